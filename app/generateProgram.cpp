@@ -0,0 +1,102 @@
+/**
+ * @file generateProgram.cpp
+ * @brief A command line tool that writes a generated synthetic program.
+ *
+ * All options of `ProgramGeneratorOptions` can be passed as `--<option>
+ * <value>` arguments. The program is written to the standard output, or to the
+ * file given by `--output`.
+ */
+
+#include "common/ProgramGenerator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Maps the name of each argument to the function that parses its value.
+ */
+using ArgumentParsers =
+    std::map<std::string, std::function<void(const std::string&)>>;
+
+/**
+ * @brief Print the supported arguments.
+ * @param arguments The supported arguments.
+ */
+void printUsage(const ArgumentParsers& arguments) {
+  std::cerr << "Usage: mqt_debugger_generate";
+  for (const auto& [name, parse] : arguments) {
+    std::cerr << " [--" << name << " <value>]";
+  }
+  std::cerr << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  ProgramGeneratorOptions options;
+  std::string output;
+
+  const auto size = [](size_t& target) {
+    return [&target](const std::string& value) { target = std::stoul(value); };
+  };
+  const auto density = [](double& target) {
+    return [&target](const std::string& value) { target = std::stod(value); };
+  };
+  const ArgumentParsers arguments{
+      {"qubits", size(options.numQubits)},
+      {"instructions", size(options.numInstructions)},
+      {"nesting-depth", size(options.nestingDepth)},
+      {"fan-out", size(options.callFanOut)},
+      {"calls", density(options.callDensity)},
+      {"assert-ent", density(options.entanglementAssertionDensity)},
+      {"assert-sup", density(options.superpositionAssertionDensity)},
+      {"assert-eq", density(options.statevectorEqualityAssertionDensity)},
+      {"assert-eq-circuit", density(options.circuitEqualityAssertionDensity)},
+      {"measurements", density(options.measurementDensity)},
+      {"classic-controls", density(options.classicControlDensity)},
+      {"noise", density(options.noiseDensity)},
+      {"seed",
+       [&options](const std::string& value) {
+         options.seed = static_cast<uint32_t>(std::stoul(value));
+       }},
+      {"output", [&output](const std::string& value) { output = value; }}};
+
+  const std::vector<std::string> args(argv + 1, argv + argc);
+  try {
+    for (size_t i = 0; i < args.size(); i += 2) {
+      const auto found = args[i].rfind("--", 0) == 0
+                             ? arguments.find(args[i].substr(2))
+                             : arguments.end();
+      if (found == arguments.end() || i + 1 >= args.size()) {
+        printUsage(arguments);
+        return 1;
+      }
+      found->second(args[i + 1]);
+    }
+
+    const auto code = generateProgram(options);
+    if (output.empty()) {
+      std::cout << code;
+      return 0;
+    }
+    std::ofstream file(output);
+    if (!file.is_open()) {
+      std::cerr << "Could not open file " << output << "\n";
+      return 1;
+    }
+    file << code;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file bench_assertions.cpp
+ * @brief Benchmarks for checking each type of assertion on states of
+ * different sizes.
+ */
+
+#include "backend/dd/DDSimDebug.hpp"
+#include "backend/debug.h"
+#include "bench_circuits.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Generate a circuit on `numQubits` qubits that prepares a Bell pair on
+ * the first two qubits and puts all other qubits into superposition, followed
+ * by the given assertion.
+ * @param numQubits The number of qubits of the circuit.
+ * @param assertion The assertion to check at the end of the circuit.
+ * @return The code of the circuit.
+ */
+std::string generateAssertionCircuit(size_t numQubits,
+                                     const std::string& assertion) {
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  ss << "h q[0];\n";
+  ss << "cx q[0], q[1];\n";
+  for (size_t i = 2; i < numQubits; i++) {
+    ss << "h q[" << i << "];\n";
+  }
+  ss << assertion << "\n";
+  return ss.str();
+}
+
+/**
+ * @brief Check the assertion at the end of a circuit of the given size
+ * repeatedly.
+ *
+ * The assertion cache is bypassed, so that every iteration performs the full
+ * check.
+ * @param state The benchmark state.
+ * @param assertion The assertion to check.
+ */
+void benchmarkAssertion(benchmark::State& state,
+                        const std::string& assertion) {
+  const auto numQubits = static_cast<size_t>(state.range(0));
+  BenchmarkSimulation simulation(state);
+  auto* simulationState = simulation.get();
+  if (!simulation.loadCode(generateAssertionCircuit(numQubits, assertion))) {
+    return;
+  }
+  const auto instruction =
+      simulationState->getInstructionCount(simulationState) - 1;
+  while (simulationState->getCurrentInstruction(simulationState) !=
+         instruction) {
+    if (!simulation.check(simulationState->stepForward(simulationState),
+                          "step to the assertion")) {
+      return;
+    }
+  }
+  auto& ddsim = simulation.ddsim;
+  const auto qubits = getAssertionQubits(&ddsim, instruction);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(checkAssertion(
+        &ddsim, instruction, ddsim.assertionInstructions[instruction],
+        qubits));
+  }
+}
+
+/**
+ * @brief Benchmark checking an entanglement assertion.
+ *
+ * The check computes the density matrix of the full state, which requires
+ * memory quadratic in the size of the state vector, so it is only run on up to
+ * 12 qubits.
+ * @param state The benchmark state.
+ */
+void benchAssertEntanglement(benchmark::State& state) {
+  benchmarkAssertion(state, "assert-ent q[0], q[1];");
+}
+BENCHMARK(benchAssertEntanglement)
+    ->Arg(4)
+    ->Arg(8)
+    ->Arg(12)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Benchmark checking a superposition assertion on all qubits.
+ * @param state The benchmark state.
+ */
+void benchAssertSuperposition(benchmark::State& state) {
+  std::ostringstream ss;
+  ss << "assert-sup q[0]";
+  for (auto i = 1; i < state.range(0); i++) {
+    ss << ", q[" << i << "]";
+  }
+  ss << ";";
+  benchmarkAssertion(state, ss.str());
+}
+BENCHMARK(benchAssertSuperposition)
+    ->Arg(4)
+    ->Arg(12)
+    ->Arg(20)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Benchmark checking an equality assertion against a state vector.
+ * @param state The benchmark state.
+ */
+void benchAssertStatevectorEquality(benchmark::State& state) {
+  benchmarkAssertion(state,
+                     "assert-eq 0.9, q[0], q[1] { 0.707, 0, 0, 0.707 }");
+}
+BENCHMARK(benchAssertStatevectorEquality)
+    ->Arg(4)
+    ->Arg(12)
+    ->Arg(20)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Benchmark checking an equality assertion against the state produced
+ * by a circuit.
+ * @param state The benchmark state.
+ */
+void benchAssertCircuitEquality(benchmark::State& state) {
+  benchmarkAssertion(
+      state, "assert-eq q[0], q[1] { qreg q[2]; h q[0]; cx q[0], q[1]; }");
+}
+BENCHMARK(benchAssertCircuitEquality)
+    ->Arg(4)
+    ->Arg(12)
+    ->Arg(20)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,116 @@
+/**
+ * @file bench_circuits.cpp
+ * @brief Implementation of the generators for the benchmark circuits and the
+ * benchmark simulation fixture.
+ */
+
+#include "bench_circuits.hpp"
+
+#include "backend/dd/DDSimDebug.hpp"
+#include "backend/debug.h"
+#include "common.h"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+
+std::string generateGhzCircuit(size_t numQubits) {
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  ss << "h q[0];\n";
+  for (size_t i = 1; i < numQubits; i++) {
+    ss << "cx q[" << i - 1 << "], q[" << i << "];\n";
+  }
+  return ss.str();
+}
+
+std::string generateQftCircuit(size_t numQubits) {
+  const auto pi = std::acos(-1.0);
+  std::ostringstream ss;
+  ss.precision(17);
+  ss << "qreg q[" << numQubits << "];\n";
+  for (size_t i = 0; i < numQubits; i += 2) {
+    ss << "x q[" << i << "];\n";
+  }
+  for (size_t i = 0; i < numQubits; i++) {
+    ss << "h q[" << i << "];\n";
+    for (size_t j = i + 1; j < numQubits; j++) {
+      const auto angle = std::ldexp(pi, -static_cast<int>(j - i));
+      ss << "cp(" << angle << ") q[" << j << "], q[" << i << "];\n";
+    }
+  }
+  return ss.str();
+}
+
+std::string generateCliffordTCircuit(size_t numQubits, size_t numInstructions,
+                                     size_t nestingDepth, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<size_t> qubitDistribution(0, numQubits - 1);
+  std::uniform_int_distribution<size_t> gateDistribution(0, 5);
+
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  for (size_t level = 0; level < nestingDepth; level++) {
+    ss << "gate level" << level << " a, b {\n";
+    if (level == 0) {
+      ss << "  h a;\n  cx a, b;\n  t b;\n";
+    } else {
+      ss << "  level" << level - 1 << " a, b;\n";
+      ss << "  s a;\n";
+      ss << "  level" << level - 1 << " b, a;\n";
+    }
+    ss << "}\n";
+  }
+
+  for (size_t i = 0; i < numInstructions; i++) {
+    const auto first = qubitDistribution(rng);
+    auto second = qubitDistribution(rng);
+    if (second == first) {
+      second = (first + 1) % numQubits;
+    }
+    const auto gate = gateDistribution(rng);
+    if (gate == 5 && nestingDepth > 0) {
+      ss << "level" << nestingDepth - 1 << " q[" << first << "], q["
+         << second << "];\n";
+    } else if (gate >= 4) {
+      ss << "cx q[" << first << "], q[" << second << "];\n";
+    } else {
+      static constexpr std::array<const char*, 4> SINGLE_QUBIT_GATES{
+          "h", "s", "t", "x"};
+      ss << SINGLE_QUBIT_GATES.at(gate) << " q[" << first << "];\n";
+    }
+  }
+  return ss.str();
+}
+
+BenchmarkSimulation::BenchmarkSimulation(benchmark::State& state)
+    : benchmarkState(state) {
+  check(createDDSimulationState(&ddsim), "create the simulation state");
+}
+
+BenchmarkSimulation::~BenchmarkSimulation() {
+  destroyDDSimulationState(&ddsim);
+}
+
+bool BenchmarkSimulation::check(Result result, const std::string& step) {
+  if (!failed && result != OK) {
+    failed = true;
+    benchmarkState.SkipWithError(("Failed to " + step).c_str());
+  }
+  return !failed;
+}
+
+bool BenchmarkSimulation::loadCode(const std::string& code) {
+  return check(get()->loadCode(get(), code.c_str()), "load the code");
+}
+
+bool BenchmarkSimulation::runSimulation() {
+  return check(get()->runSimulation(get()), "run the simulation");
+}
+
+SimulationState* BenchmarkSimulation::get() { return &ddsim.interface; }
@@ -0,0 +1,119 @@
+/**
+ * @file bench_circuits.hpp
+ * @brief Generators for the parametric circuits used by the benchmarks, and a
+ * fixture that owns the simulation state of a benchmark.
+ */
+
+#pragma once
+
+#include "backend/dd/DDSimDebug.hpp"
+#include "backend/debug.h"
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Generate a circuit that prepares a GHZ state on `numQubits` qubits.
+ * @param numQubits The number of qubits of the circuit.
+ * @return The code of the circuit.
+ */
+std::string generateGhzCircuit(size_t numQubits);
+
+/**
+ * @brief Generate a circuit that applies the quantum Fourier transform to
+ * `numQubits` qubits prepared in a basis state.
+ *
+ * The circuit consists of Hadamard gates and controlled phase rotations, so
+ * it contains `numQubits * (numQubits + 1) / 2` gates plus the state
+ * preparation.
+ * @param numQubits The number of qubits of the circuit.
+ * @return The code of the circuit.
+ */
+std::string generateQftCircuit(size_t numQubits);
+
+/**
+ * @brief Generate a random Clifford+T circuit that also calls nested custom
+ * gates.
+ *
+ * The circuit defines `nestingDepth` custom gates, each of which calls the
+ * previous one. Every top-level instruction is either a random gate from
+ * {h, s, t, x, cx} or a call to the outermost custom gate.
+ * @param numQubits The number of qubits of the circuit. Must be at least 2.
+ * @param numInstructions The number of top-level instructions.
+ * @param nestingDepth The number of nested custom gate definitions.
+ * @param seed The seed of the random number generator.
+ * @return The code of the circuit.
+ */
+std::string generateCliffordTCircuit(size_t numQubits, size_t numInstructions,
+                                     size_t nestingDepth, uint32_t seed = 42);
+
+/**
+ * @brief Owns a DD simulation state for the duration of a benchmark.
+ *
+ * Every setup step checks its result. If a step fails, the benchmark is
+ * skipped with an error instead of measuring an invalid state.
+ */
+class BenchmarkSimulation {
+public:
+  /**
+   * @brief Create the simulation state.
+   * @param state The state of the benchmark using the simulation.
+   */
+  explicit BenchmarkSimulation(benchmark::State& state);
+
+  /**
+   * @brief Destroy the simulation state.
+   */
+  ~BenchmarkSimulation();
+
+  BenchmarkSimulation(const BenchmarkSimulation&) = delete;
+  BenchmarkSimulation& operator=(const BenchmarkSimulation&) = delete;
+  BenchmarkSimulation(BenchmarkSimulation&&) = delete;
+  BenchmarkSimulation& operator=(BenchmarkSimulation&&) = delete;
+
+  /**
+   * @brief Check the result of a step, skipping the benchmark if it failed.
+   * @param result The result of the step.
+   * @param step A description of the step, used in the error message.
+   * @return True if the step succeeded and all previous steps did as well.
+   */
+  bool check(Result result, const std::string& step);
+
+  /**
+   * @brief Load the given code into the simulation state.
+   * @param code The code to load.
+   * @return True if the code was loaded.
+   */
+  bool loadCode(const std::string& code);
+
+  /**
+   * @brief Run the simulation until it finishes or pauses.
+   * @return True if the simulation ran without an error.
+   */
+  bool runSimulation();
+
+  /**
+   * @brief Get the interface of the simulation state.
+   * @return The `SimulationState` interface.
+   */
+  SimulationState* get();
+
+  /**
+   * @brief The owned simulation state.
+   */
+  DDSimulationState ddsim;
+
+private:
+  /**
+   * @brief The state of the benchmark using the simulation.
+   */
+  benchmark::State& benchmarkState;
+
+  /**
+   * @brief Indicates whether a step has failed.
+   */
+  bool failed = false;
+};
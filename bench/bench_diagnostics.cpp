@@ -0,0 +1,119 @@
+/**
+ * @file bench_diagnostics.cpp
+ * @brief Benchmarks for the static and dynamic analysis methods of the
+ * diagnostics.
+ */
+
+#include "backend/dd/DDSimDebug.hpp"
+#include "backend/debug.h"
+#include "backend/diagnostics.h"
+#include "bench_circuits.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * @brief The number of qubits used by the random part of the programs.
+ */
+constexpr size_t NUM_QUBITS = 8;
+
+/**
+ * @brief Generate a random Clifford+T program with the given number of
+ * top-level instructions that ends with a failing entanglement assertion.
+ *
+ * The assertion targets a qubit of a separate register that is never used, so
+ * it fails due to a missing interaction.
+ * @param numInstructions The number of top-level instructions.
+ * @return The code of the program.
+ */
+std::string generateDiagnosticsProgram(size_t numInstructions) {
+  return generateCliffordTCircuit(NUM_QUBITS, numInstructions, 2) +
+         "qreg r[1];\nassert-ent q[0], r[0];\n";
+}
+
+/**
+ * @brief Load a generated diagnostics program of the size given by the
+ * benchmark state and run the given analysis on it repeatedly.
+ * @param state The benchmark state.
+ * @param run Whether to run the program until the assertion fails first.
+ * @param analyze The analysis to run.
+ */
+template <typename F>
+void benchmarkDiagnostics(benchmark::State& state, bool run, F analyze) {
+  BenchmarkSimulation simulation(state);
+  auto* simulationState = simulation.get();
+  if (!simulation.loadCode(
+          generateDiagnosticsProgram(static_cast<size_t>(state.range(0)))) ||
+      (run && !simulation.runSimulation())) {
+    return;
+  }
+  auto* diagnostics = simulationState->getDiagnostics(simulationState);
+  const auto numInstructions =
+      simulationState->getInstructionCount(simulationState);
+
+  for (auto _ : state) {
+    analyze(diagnostics, numInstructions);
+  }
+}
+
+/**
+ * @brief Benchmark extracting the data dependencies of the final assertion,
+ * including the callers of custom gates.
+ * @param state The benchmark state.
+ */
+void benchGetDataDependencies(benchmark::State& state) {
+  benchmarkDiagnostics(
+      state, false, [](Diagnostics* diagnostics, size_t numInstructions) {
+        const auto dependencies = std::make_unique<bool[]>(numInstructions);
+        diagnostics->getDataDependencies(diagnostics, numInstructions - 1,
+                                         true, dependencies.get());
+        benchmark::DoNotOptimize(dependencies.get());
+      });
+}
+BENCHMARK(benchGetDataDependencies)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark extracting the qubits interacting with the first qubit
+ * before the final assertion.
+ * @param state The benchmark state.
+ */
+void benchGetInteractions(benchmark::State& state) {
+  benchmarkDiagnostics(
+      state, false, [](Diagnostics* diagnostics, size_t numInstructions) {
+        std::array<bool, NUM_QUBITS + 1> interactions{};
+        diagnostics->getInteractions(diagnostics, numInstructions - 1, 0,
+                                     interactions.data());
+        benchmark::DoNotOptimize(interactions.data());
+      });
+}
+BENCHMARK(benchGetInteractions)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark finding the potential error causes of the failed final
+ * assertion.
+ * @param state The benchmark state.
+ */
+void benchPotentialErrorCauses(benchmark::State& state) {
+  benchmarkDiagnostics(
+      state, true, [](Diagnostics* diagnostics, size_t /*numInstructions*/) {
+        std::array<ErrorCause, 10> causes{};
+        benchmark::DoNotOptimize(diagnostics->potentialErrorCauses(
+            diagnostics, causes.data(), causes.size()));
+      });
+}
+BENCHMARK(benchPotentialErrorCauses)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
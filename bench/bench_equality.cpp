@@ -0,0 +1,158 @@
+/**
+ * @file bench_equality.cpp
+ * @brief Benchmarks for checking equality assertions on the dense state vector
+ * and on the decision diagram.
+ */
+
+#include "backend/dd/DDSimDebug.hpp"
+#include "bench_circuits.hpp"
+#include "common.h"
+#include "common/Span.hpp"
+
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Generate a circuit on `numQubits` qubits whose first two qubits form
+ * a Bell pair that is separable from the remaining qubits.
+ *
+ * All further qubits are put into superposition, so the state has no zero
+ * amplitudes outside of the Bell pair.
+ * @param numQubits The number of qubits of the circuit.
+ * @return The code of the circuit.
+ */
+std::string generateEqualityCircuit(size_t numQubits) {
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  ss << "h q[0];\n";
+  ss << "cx q[0], q[1];\n";
+  for (size_t i = 2; i < numQubits; i++) {
+    ss << "h q[" << i << "];\n";
+  }
+  return ss.str();
+}
+
+/**
+ * @brief Compute the magnitude of the inner product of two state vectors.
+ *
+ * The amplitudes of the first state vector are conjugated.
+ * @param sv1 The first state vector.
+ * @param sv2 The second state vector.
+ * @return The magnitude of the computed inner product.
+ */
+double dotProduct(const Statevector& sv1, const Statevector& sv2) {
+  double resultReal = 0;
+  double resultImag = 0;
+
+  const Span<Complex> amplitudes1(sv1.amplitudes, sv1.numStates);
+  const Span<Complex> amplitudes2(sv2.amplitudes, sv2.numStates);
+
+  for (size_t i = 0; i < std::min(sv1.numStates, sv2.numStates); i++) {
+    resultReal += amplitudes1[i].real * amplitudes2[i].real +
+                  amplitudes1[i].imaginary * amplitudes2[i].imaginary;
+    resultImag += amplitudes1[i].real * amplitudes2[i].imaginary -
+                  amplitudes1[i].imaginary * amplitudes2[i].real;
+  }
+  return std::hypot(resultReal, resultImag);
+}
+
+/**
+ * @brief Compute the similarity between the sub-state of the given qubits and
+ * a reference state using the dense state vector of the full system.
+ *
+ * This is how equality assertions were checked before the sub-state was
+ * extracted from the decision diagram. It serves as the baseline for
+ * `getSubStateSimilarityDD`.
+ * @param ddsim The simulation state to extract the sub-state from.
+ * @param qubits The qubits that make up the sub-state.
+ * @param reference The reference state to compare to.
+ * @return The similarity of both states.
+ * @throws std::runtime_error If the sub-state is entangled with other qubits.
+ */
+double getSubStateSimilarityDense(DDSimulationState* ddsim,
+                                  const std::vector<size_t>& qubits,
+                                  const Statevector& reference) {
+  Statevector sv;
+  sv.numQubits = qubits.size();
+  sv.numStates = 1 << sv.numQubits;
+  std::vector<Complex> amplitudes(sv.numStates);
+  sv.amplitudes = amplitudes.data();
+
+  if (ddsim->interface.getStateVectorSub(&ddsim->interface, sv.numQubits,
+                                         qubits.data(), &sv) == ERROR) {
+    throw std::runtime_error(
+        "Equality assertion on entangled sub-state is not allowed.");
+  }
+
+  return dotProduct(reference, sv);
+}
+
+/**
+ * @brief Compare the sub-state of the Bell pair in a circuit of the given size
+ * to its expected state using the given comparison function.
+ * @param state The benchmark state.
+ * @param similarity The function used to compute the similarity.
+ */
+template <typename F>
+void benchmarkEqualityAssertion(benchmark::State& state, F similarity) {
+  const auto numQubits = static_cast<size_t>(state.range(0));
+  BenchmarkSimulation simulation(state);
+  if (!simulation.loadCode(generateEqualityCircuit(numQubits)) ||
+      !simulation.runSimulation()) {
+    return;
+  }
+
+  const std::vector<size_t> qubits{0, 1};
+  std::array<Complex, 4> amplitudes{
+      Complex{0.707, 0}, Complex{0, 0}, Complex{0, 0}, Complex{0.707, 0}};
+  const Statevector reference{2, 4, amplitudes.data()};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        similarity(&simulation.ddsim, qubits, reference));
+  }
+}
+
+/**
+ * @brief Benchmark the dense comparison that expands the full state vector.
+ *
+ * The partial trace of the full state vector visits every pair of amplitudes,
+ * so its runtime grows with 4^n for n qubits, even though the traced matrix
+ * of the Bell pair only has 4x4 entries. At 16 qubits, this already takes
+ * over four billion iterations per check, so it is only run for the smallest
+ * size.
+ * @param state The benchmark state.
+ */
+void benchEqualityDense(benchmark::State& state) {
+  benchmarkEqualityAssertion(
+      state, [](DDSimulationState* ddsim, const std::vector<size_t>& qubits,
+                const Statevector& reference) {
+        return getSubStateSimilarityDense(ddsim, qubits, reference);
+      });
+}
+BENCHMARK(benchEqualityDense)->Arg(10)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark the comparison that extracts the sub-state from the decision
+ * diagram.
+ * @param state The benchmark state.
+ */
+void benchEqualityDD(benchmark::State& state) {
+  benchmarkEqualityAssertion(
+      state, [](DDSimulationState* ddsim, const std::vector<size_t>& qubits,
+                const Statevector& reference) {
+        return getSubStateSimilarityDD(ddsim, qubits, reference);
+      });
+}
+BENCHMARK(benchEqualityDD)
+    ->Arg(10)
+    ->Arg(16)
+    ->Arg(24)
+    ->Unit(benchmark::kMillisecond);
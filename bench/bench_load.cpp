@@ -0,0 +1,165 @@
+/**
+ * @file bench_load.cpp
+ * @brief Benchmarks for loading programs, including building the quantum
+ * computation of a loaded program directly from the preprocessed instructions
+ * and by importing the preprocessed code, and preprocessing large synthetic
+ * programs.
+ */
+
+#include "backend/dd/DDSimDebug.hpp"
+#include "backend/debug.h"
+#include "bench_circuits.hpp"
+#include "circuit_optimizer/CircuitOptimizer.hpp"
+#include "common/ProgramGenerator.hpp"
+#include "common/parsing/CodePreprocessing.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Generate a program with the given number of gate instructions that
+ * repeatedly calls a small custom gate.
+ * @param numInstructions The number of top-level gate instructions.
+ * @return The code of the program.
+ */
+std::string generateLoadProgram(size_t numInstructions) {
+  constexpr size_t numQubits = 8;
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  ss << "gate bell a, b {\n  h a;\n  cx a, b;\n}\n";
+  for (size_t i = 0; i < numInstructions; i++) {
+    const auto first = i % numQubits;
+    const auto second = (i + 1) % numQubits;
+    if (i % 3 == 0) {
+      ss << "bell q[" << first << "], q[" << second << "];\n";
+    } else {
+      ss << "cz q[" << first << "], q[" << second << "];\n";
+    }
+  }
+  return ss.str();
+}
+
+/**
+ * @brief Build the quantum computation of a generated program with the given
+ * function after preprocessing it.
+ * @param state The benchmark state.
+ * @param build The function used to build the quantum computation.
+ */
+template <typename F>
+void benchmarkLoad(benchmark::State& state, F build) {
+  const auto code = generateLoadProgram(static_cast<size_t>(state.range(0)));
+  BenchmarkSimulation simulation(state);
+
+  for (auto _ : state) {
+    std::vector<Instruction> instructions;
+    const auto validCode =
+        preprocessAssertionCode(code.c_str(), &simulation.ddsim, instructions);
+    qc::QuantumComputation qc;
+    build(&simulation.ddsim, instructions, validCode, qc);
+    benchmark::DoNotOptimize(qc.getNops());
+  }
+}
+
+/**
+ * @brief Benchmark importing the preprocessed code into the quantum
+ * computation, which parses the program a second time.
+ * @param state The benchmark state.
+ */
+void benchLoadImport(benchmark::State& state) {
+  benchmarkLoad(state, [](DDSimulationState* /*ddsim*/,
+                          const std::vector<Instruction>& /*instructions*/,
+                          const std::string& validCode,
+                          qc::QuantumComputation& qc) {
+    std::stringstream ss{validCode};
+    qc.import(ss, qc::Format::OpenQASM3);
+    qc::CircuitOptimizer::flattenOperations(qc, true);
+  });
+}
+BENCHMARK(benchLoadImport)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark building the quantum computation directly from the
+ * preprocessed instructions.
+ * @param state The benchmark state.
+ */
+void benchLoadDirect(benchmark::State& state) {
+  benchmarkLoad(state, [](DDSimulationState* ddsim,
+                          const std::vector<Instruction>& instructions,
+                          const std::string& /*validCode*/,
+                          qc::QuantumComputation& qc) {
+    buildQuantumComputation(ddsim, instructions, qc);
+  });
+}
+BENCHMARK(benchLoadDirect)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark loading a random Clifford+T program with nested custom
+ * gates and the given number of top-level instructions, reporting the number
+ * of parsed bytes per second.
+ * @param state The benchmark state.
+ */
+void benchLoadCode(benchmark::State& state) {
+  const auto code =
+      generateCliffordTCircuit(16, static_cast<size_t>(state.range(0)), 3);
+  BenchmarkSimulation simulation(state);
+
+  for (auto _ : state) {
+    if (!simulation.loadCode(code)) {
+      break;
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(code.size()) *
+                          state.iterations());
+}
+BENCHMARK(benchLoadCode)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark preprocessing a synthetic program that uses all supported
+ * constructs, with the given number of top-level instructions.
+ * @param state The benchmark state.
+ */
+void benchPreprocessGenerated(benchmark::State& state) {
+  ProgramGeneratorOptions options;
+  options.numInstructions = static_cast<size_t>(state.range(0));
+  options.nestingDepth = 4;
+  options.entanglementAssertionDensity = 0.02;
+  options.superpositionAssertionDensity = 0.02;
+  options.statevectorEqualityAssertionDensity = 0.01;
+  options.circuitEqualityAssertionDensity = 0.01;
+  options.measurementDensity = 0.02;
+  options.classicControlDensity = 0.02;
+  options.noiseDensity = 0.1;
+  const auto code = generateProgram(options);
+  BenchmarkSimulation simulation(state);
+
+  for (auto _ : state) {
+    std::vector<Instruction> instructions;
+    const auto validCode =
+        preprocessAssertionCode(code.c_str(), &simulation.ddsim, instructions);
+    benchmark::DoNotOptimize(validCode.size());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(code.size()) *
+                          state.iterations());
+}
+BENCHMARK(benchPreprocessGenerated)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
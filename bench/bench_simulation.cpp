@@ -0,0 +1,120 @@
+/**
+ * @file bench_simulation.cpp
+ * @brief Benchmarks for executing programs by stepping through them and by
+ * running them as a whole.
+ */
+
+#include "backend/dd/DDSimDebug.hpp"
+#include "backend/debug.h"
+#include "bench_circuits.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Execute a program repeatedly using the given function and report the
+ * number of executed operations per second.
+ * @param state The benchmark state.
+ * @param code The code of the program.
+ * @param execute The function used to execute the program once.
+ */
+template <typename F>
+void benchmarkExecution(benchmark::State& state, const std::string& code,
+                        F execute) {
+  BenchmarkSimulation simulation(state);
+  auto* simulationState = simulation.get();
+  if (!simulation.loadCode(code)) {
+    return;
+  }
+
+  for (auto _ : state) {
+    execute(simulationState);
+    simulationState->resetSimulation(simulationState);
+  }
+  state.counters["gates"] = benchmark::Counter(
+      static_cast<double>(simulation.ddsim.qc->getNops()) *
+          static_cast<double>(state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Execute a program by calling `stepForward` for each instruction.
+ * @param simulationState The simulation state to execute.
+ */
+void stepThrough(SimulationState* simulationState) {
+  while (!simulationState->isFinished(simulationState)) {
+    simulationState->stepForward(simulationState);
+  }
+}
+
+/**
+ * @brief Execute a program by calling `runSimulation` once.
+ * @param simulationState The simulation state to execute.
+ */
+void runThrough(SimulationState* simulationState) {
+  simulationState->runSimulation(simulationState);
+}
+
+/**
+ * @brief Benchmark stepping through a GHZ circuit of the given size.
+ * @param state The benchmark state.
+ */
+void benchStepForwardGhz(benchmark::State& state) {
+  benchmarkExecution(
+      state, generateGhzCircuit(static_cast<size_t>(state.range(0))),
+      stepThrough);
+}
+BENCHMARK(benchStepForwardGhz)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(128)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Benchmark running a GHZ circuit of the given size.
+ * @param state The benchmark state.
+ */
+void benchRunSimulationGhz(benchmark::State& state) {
+  benchmarkExecution(
+      state, generateGhzCircuit(static_cast<size_t>(state.range(0))),
+      runThrough);
+}
+BENCHMARK(benchRunSimulationGhz)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(128)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Benchmark running the quantum Fourier transform on the given number
+ * of qubits.
+ * @param state The benchmark state.
+ */
+void benchRunSimulationQft(benchmark::State& state) {
+  benchmarkExecution(
+      state, generateQftCircuit(static_cast<size_t>(state.range(0))),
+      runThrough);
+}
+BENCHMARK(benchRunSimulationQft)
+    ->Arg(8)
+    ->Arg(16)
+    ->Arg(24)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark running a random Clifford+T circuit with nested custom
+ * gates and the given number of top-level instructions on 16 qubits.
+ * @param state The benchmark state.
+ */
+void benchRunSimulationCliffordT(benchmark::State& state) {
+  benchmarkExecution(
+      state,
+      generateCliffordTCircuit(16, static_cast<size_t>(state.range(0)), 3),
+      runThrough);
+}
+BENCHMARK(benchRunSimulationCliffordT)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
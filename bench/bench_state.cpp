@@ -0,0 +1,99 @@
+/**
+ * @file bench_state.cpp
+ * @brief Benchmarks for retrieving the full state vector and sub-states of the
+ * simulation.
+ */
+
+#include "backend/dd/DDSimDebug.hpp"
+#include "backend/debug.h"
+#include "bench_circuits.hpp"
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Generate a circuit that puts all `numQubits` qubits into a separable
+ * superposition, so that every subset of qubits forms a valid sub-state.
+ * @param numQubits The number of qubits of the circuit.
+ * @return The code of the circuit.
+ */
+std::string generateProductStateCircuit(size_t numQubits) {
+  std::ostringstream ss;
+  ss << "qreg q[" << numQubits << "];\n";
+  for (size_t i = 0; i < numQubits; i++) {
+    ss << (i % 3 == 0 ? "x" : "h") << " q[" << i << "];\n";
+  }
+  return ss.str();
+}
+
+/**
+ * @brief Retrieve a state vector of the given number of qubits from a product
+ * state repeatedly and report the number of retrieved amplitudes per second.
+ * @param state The benchmark state.
+ * @param numQubits The number of qubits of the simulated circuit.
+ * @param numTargets The number of qubits of the retrieved state vector.
+ * @param retrieve The function used to retrieve the state vector.
+ */
+template <typename F>
+void benchmarkStatevector(benchmark::State& state, size_t numQubits,
+                          size_t numTargets, F retrieve) {
+  BenchmarkSimulation simulation(state);
+  auto* simulationState = simulation.get();
+  if (!simulation.loadCode(generateProductStateCircuit(numQubits)) ||
+      !simulation.runSimulation()) {
+    return;
+  }
+
+  std::vector<Complex> amplitudes(1ULL << numTargets);
+  Statevector output{numTargets, amplitudes.size(), amplitudes.data()};
+  for (auto _ : state) {
+    retrieve(simulationState, &output);
+    benchmark::DoNotOptimize(amplitudes.data());
+  }
+  state.counters["amplitudes"] = benchmark::Counter(
+      static_cast<double>(amplitudes.size()) *
+          static_cast<double>(state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Benchmark retrieving the full state vector.
+ * @param state The benchmark state.
+ */
+void benchGetStateVectorFull(benchmark::State& state) {
+  const auto numQubits = static_cast<size_t>(state.range(0));
+  benchmarkStatevector(state, numQubits, numQubits,
+                       [](SimulationState* self, Statevector* output) {
+                         self->getStateVectorFull(self, output);
+                       });
+}
+BENCHMARK(benchGetStateVectorFull)
+    ->Arg(8)
+    ->Arg(14)
+    ->Arg(20)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Benchmark retrieving the sub-state of half of the qubits.
+ * @param state The benchmark state.
+ */
+void benchGetStateVectorSub(benchmark::State& state) {
+  const auto numQubits = static_cast<size_t>(state.range(0));
+  std::vector<size_t> qubits(numQubits / 2);
+  std::iota(qubits.begin(), qubits.end(), 0);
+  benchmarkStatevector(
+      state, numQubits, qubits.size(),
+      [&qubits](SimulationState* self, Statevector* output) {
+        self->getStateVectorSub(self, qubits.size(), qubits.data(), output);
+      });
+}
+BENCHMARK(benchGetStateVectorSub)
+    ->Arg(8)
+    ->Arg(14)
+    ->Arg(20)
+    ->Unit(benchmark::kMillisecond);
@@ -107,6 +107,30 @@ if(BUILD_MQT_DEBUGGER_TESTS)
   endif()
 endif()
 
+if(BUILD_MQT_DEBUGGER_BENCHMARKS)
+  set(BENCHMARK_ENABLE_TESTING
+      OFF
+      CACHE BOOL "Disable testing for Google Benchmark")
+  set(BENCHMARK_ENABLE_GTEST_TESTS
+      OFF
+      CACHE BOOL "Disable GTest-based tests for Google Benchmark")
+  set(BENCHMARK_VERSION
+      1.8.3
+      CACHE STRING "Google Benchmark version")
+  set(BENCHMARK_URL
+      https://github.com/google/benchmark/archive/refs/tags/v${BENCHMARK_VERSION}.tar.gz)
+  if(CMAKE_VERSION VERSION_GREATER_EQUAL 3.24)
+    FetchContent_Declare(benchmark URL ${BENCHMARK_URL} FIND_PACKAGE_ARGS NAMES benchmark)
+    list(APPEND FETCH_PACKAGES benchmark)
+  else()
+    find_package(benchmark QUIET)
+    if(NOT benchmark_FOUND)
+      FetchContent_Declare(benchmark URL ${BENCHMARK_URL})
+      list(APPEND FETCH_PACKAGES benchmark)
+    endif()
+  endif()
+endif()
+
 if(BUILD_MQT_DEBUGGER_BINDINGS)
   # add pybind11_json library
   if(CMAKE_VERSION VERSION_GREATER_EQUAL 3.24)
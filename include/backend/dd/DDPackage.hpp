@@ -0,0 +1,156 @@
+/**
+ * @file DDPackage.hpp
+ * @brief Provides the configuration of the DD package used by the debugger and
+ * a pool of warm packages that can be reused by new simulation states.
+ *
+ * The table sizes default to those of `dd::DDPackageConfig`. They can be tuned
+ * for the circuits at hand by defining the corresponding
+ * `MQT_DEBUGGER_DD_<SETTING>` macros, which the CMake cache variables of the
+ * same name do for the whole project.
+ */
+
+#pragma once
+
+#include "dd/Package.hpp"
+
+#include <cstddef>
+#include <memory>
+
+#ifndef MQT_DEBUGGER_DD_UT_VEC_NBUCKET
+#define MQT_DEBUGGER_DD_UT_VEC_NBUCKET dd::DDPackageConfig::UT_VEC_NBUCKET
+#endif
+#ifndef MQT_DEBUGGER_DD_UT_VEC_INITIAL_ALLOCATION_SIZE
+#define MQT_DEBUGGER_DD_UT_VEC_INITIAL_ALLOCATION_SIZE                         \
+  dd::DDPackageConfig::UT_VEC_INITIAL_ALLOCATION_SIZE
+#endif
+#ifndef MQT_DEBUGGER_DD_UT_MAT_NBUCKET
+#define MQT_DEBUGGER_DD_UT_MAT_NBUCKET dd::DDPackageConfig::UT_MAT_NBUCKET
+#endif
+#ifndef MQT_DEBUGGER_DD_UT_MAT_INITIAL_ALLOCATION_SIZE
+#define MQT_DEBUGGER_DD_UT_MAT_INITIAL_ALLOCATION_SIZE                         \
+  dd::DDPackageConfig::UT_MAT_INITIAL_ALLOCATION_SIZE
+#endif
+#ifndef MQT_DEBUGGER_DD_CT_VEC_ADD_NBUCKET
+#define MQT_DEBUGGER_DD_CT_VEC_ADD_NBUCKET                                     \
+  dd::DDPackageConfig::CT_VEC_ADD_NBUCKET
+#endif
+#ifndef MQT_DEBUGGER_DD_CT_MAT_ADD_NBUCKET
+#define MQT_DEBUGGER_DD_CT_MAT_ADD_NBUCKET                                     \
+  dd::DDPackageConfig::CT_MAT_ADD_NBUCKET
+#endif
+#ifndef MQT_DEBUGGER_DD_CT_MAT_VEC_MULT_NBUCKET
+#define MQT_DEBUGGER_DD_CT_MAT_VEC_MULT_NBUCKET                                \
+  dd::DDPackageConfig::CT_MAT_VEC_MULT_NBUCKET
+#endif
+#ifndef MQT_DEBUGGER_DD_CT_MAT_MAT_MULT_NBUCKET
+#define MQT_DEBUGGER_DD_CT_MAT_MAT_MULT_NBUCKET                                \
+  dd::DDPackageConfig::CT_MAT_MAT_MULT_NBUCKET
+#endif
+
+/**
+ * @brief The configuration of the DD package used by the debugger.
+ *
+ * All settings not listed here keep the defaults of `dd::DDPackageConfig`.
+ */
+struct DebuggerDDPackageConfig : public dd::DDPackageConfig {
+  /**
+   * @brief The number of buckets of the unique table for vector nodes.
+   */
+  static constexpr std::size_t UT_VEC_NBUCKET = MQT_DEBUGGER_DD_UT_VEC_NBUCKET;
+  /**
+   * @brief The number of vector nodes allocated when the package is created.
+   */
+  static constexpr std::size_t UT_VEC_INITIAL_ALLOCATION_SIZE =
+      MQT_DEBUGGER_DD_UT_VEC_INITIAL_ALLOCATION_SIZE;
+  /**
+   * @brief The number of buckets of the unique table for matrix nodes.
+   */
+  static constexpr std::size_t UT_MAT_NBUCKET = MQT_DEBUGGER_DD_UT_MAT_NBUCKET;
+  /**
+   * @brief The number of matrix nodes allocated when the package is created.
+   */
+  static constexpr std::size_t UT_MAT_INITIAL_ALLOCATION_SIZE =
+      MQT_DEBUGGER_DD_UT_MAT_INITIAL_ALLOCATION_SIZE;
+  /**
+   * @brief The number of buckets of the compute table of vector additions.
+   */
+  static constexpr std::size_t CT_VEC_ADD_NBUCKET =
+      MQT_DEBUGGER_DD_CT_VEC_ADD_NBUCKET;
+  /**
+   * @brief The number of buckets of the compute table of matrix additions.
+   */
+  static constexpr std::size_t CT_MAT_ADD_NBUCKET =
+      MQT_DEBUGGER_DD_CT_MAT_ADD_NBUCKET;
+  /**
+   * @brief The number of buckets of the compute table of matrix-vector
+   * multiplications, which apply the operations to the state.
+   */
+  static constexpr std::size_t CT_MAT_VEC_MULT_NBUCKET =
+      MQT_DEBUGGER_DD_CT_MAT_VEC_MULT_NBUCKET;
+  /**
+   * @brief The number of buckets of the compute table of matrix-matrix
+   * multiplications.
+   */
+  static constexpr std::size_t CT_MAT_MAT_MULT_NBUCKET =
+      MQT_DEBUGGER_DD_CT_MAT_MAT_MULT_NBUCKET;
+};
+
+/**
+ * @brief Check whether a number of buckets can be used by a hash table of the
+ * DD package, which requires it to be a power of two.
+ * @param buckets The number of buckets.
+ * @return True if the number of buckets is valid, false otherwise.
+ */
+constexpr bool isValidBucketCount(std::size_t buckets) {
+  return buckets > 0 && (buckets & (buckets - 1)) == 0;
+}
+
+static_assert(
+    isValidBucketCount(DebuggerDDPackageConfig::UT_VEC_NBUCKET) &&
+        isValidBucketCount(DebuggerDDPackageConfig::UT_MAT_NBUCKET) &&
+        isValidBucketCount(DebuggerDDPackageConfig::CT_VEC_ADD_NBUCKET) &&
+        isValidBucketCount(DebuggerDDPackageConfig::CT_MAT_ADD_NBUCKET) &&
+        isValidBucketCount(DebuggerDDPackageConfig::CT_MAT_VEC_MULT_NBUCKET) &&
+        isValidBucketCount(DebuggerDDPackageConfig::CT_MAT_MAT_MULT_NBUCKET),
+    "The bucket counts of the DD package must be powers of two");
+
+/**
+ * @brief The DD package used by the debugger.
+ */
+using DDPackage = dd::Package<DebuggerDDPackageConfig>;
+
+/**
+ * @brief Get a DD package for a new simulation state.
+ *
+ * If the pool contains a package released by a previous simulation state, it
+ * is reused, so that its allocated nodes and tables do not have to be
+ * allocated again. Otherwise, a new package is created.
+ * @param numQubits The number of qubits a new package is created for.
+ * @return The DD package.
+ */
+std::unique_ptr<DDPackage> acquireDDPackage(std::size_t numQubits);
+
+/**
+ * @brief Return the DD package of a destroyed simulation state.
+ *
+ * The package is kept in the pool if it has space left, and destroyed
+ * otherwise. All states and operations of the package must have been
+ * dereferenced before.
+ * @param package The DD package to return.
+ */
+void releaseDDPackage(std::unique_ptr<DDPackage> package);
+
+/**
+ * @brief Set the number of released DD packages kept for reuse.
+ *
+ * The capacity is 0 by default, so that each simulation state creates its own
+ * package. Packages exceeding a reduced capacity are destroyed.
+ * @param capacity The maximum number of packages kept in the pool.
+ */
+void setDDPackagePoolCapacity(std::size_t capacity);
+
+/**
+ * @brief Get the number of DD packages currently kept in the pool.
+ * @return The number of packages in the pool.
+ */
+std::size_t getDDPackagePoolSize();
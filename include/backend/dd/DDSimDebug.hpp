@@ -5,21 +5,30 @@
  */
 #pragma once
 
+#include "DDPackage.hpp"
 #include "DDSimDiagnostics.hpp"
 #include "backend/debug.h"
 #include "backend/diagnostics.h"
 #include "common.h"
+#include "common/CompressedTable.hpp"
+#include "common/RingBuffer.hpp"
+#include "common/SymbolTable.hpp"
 #include "common/parsing/AssertionParsing.hpp"
+#include "common/parsing/BreakpointConditionParsing.hpp"
+#include "common/parsing/CodePreprocessing.hpp"
 #include "dd/Package.hpp"
 #include "ir/QuantumComputation.hpp"
 #include "ir/operations/Operation.hpp"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -87,6 +96,126 @@ struct ClassicalRegisterDefinition {
   size_t size;
 };
 
+/**
+ * @brief Represents a parameter of a custom gate call, resolved to the global
+ * variable it refers to.
+ */
+struct ResolvedParameter {
+  /**
+   * @brief The symbol of the parameter's name.
+   */
+  SymbolId parameter;
+  /**
+   * @brief The global variable the parameter refers to in this call.
+   */
+  VariableReference variable;
+  /**
+   * @brief The index of the qubit the parameter refers to, or -1 if the
+   * variable does not refer to a valid qubit.
+   */
+  size_t qubit;
+};
+
+/**
+ * @brief Represents a frame of the custom gate call stack.
+ *
+ * The parameters of the called gate are resolved once when the frame is pushed,
+ * so variables inside the gate can be mapped to qubits without walking through
+ * the outer frames.
+ */
+struct CallFrame {
+  /**
+   * @brief The instruction of the custom gate call.
+   */
+  size_t call;
+  /**
+   * @brief The resolved parameters of the call, sorted by their symbol.
+   */
+  std::vector<ResolvedParameter> parameters;
+};
+
+/**
+ * @brief Represents the conditions attached to a breakpoint.
+ *
+ * The variables used by the conditions are resolved when the conditions are
+ * set, so that checking them does not require any lookups by name.
+ */
+struct BreakpointConditions {
+  /**
+   * @brief Indicates whether the breakpoint has a condition on the state of the
+   * simulation.
+   */
+  bool hasCondition;
+  /**
+   * @brief The condition on the state of the simulation.
+   */
+  BreakpointCondition condition;
+  /**
+   * @brief The names of the classical bits compared by the condition, starting
+   * with the least significant bit.
+   */
+  std::vector<std::string> classicalBits;
+  /**
+   * @brief The index of the qubit whose probability is compared by the
+   * condition, or -1 if the condition does not refer to a valid qubit.
+   */
+  size_t qubit;
+  /**
+   * @brief Indicates whether the breakpoint has a condition on its hit count.
+   */
+  bool hasHitCondition;
+  /**
+   * @brief The condition on the hit count of the breakpoint.
+   */
+  HitCondition hitCondition;
+  /**
+   * @brief The number of times the breakpoint was reached while its condition
+   * held since the last reset.
+   */
+  size_t hits;
+};
+
+/**
+ * @brief Identifies the outcome of an assertion check.
+ *
+ * Decision diagrams are canonical, so the root edge of the current state,
+ * together with the checked assertion and the qubits its targets resolve to,
+ * uniquely determines whether the assertion is satisfied.
+ */
+struct AssertionCacheKey {
+  /**
+   * @brief The root edge of the state the assertion was checked on.
+   */
+  qc::VectorDD state;
+  /**
+   * @brief The instruction of the checked assertion.
+   */
+  size_t instruction;
+  /**
+   * @brief The qubit indices the assertion's targets resolved to.
+   */
+  std::vector<size_t> qubits;
+
+  /**
+   * @brief Checks whether two keys refer to the same assertion outcome.
+   * @param other The key to compare to.
+   * @return True if both keys are equal, false otherwise.
+   */
+  bool operator==(const AssertionCacheKey& other) const;
+};
+
+/**
+ * @brief Computes the hash of an `AssertionCacheKey`.
+ */
+struct AssertionCacheKeyHash {
+  /**
+   * @brief Computes the hash of the given key.
+   * @param key The key to hash.
+   * @return The hash of the key.
+   */
+  size_t operator()(const AssertionCacheKey& key) const;
+};
+
 /**
  * @brief The DD-simulator implementation of the `SimulationState` interface.
  */
@@ -107,6 +236,10 @@ struct DDSimulationState {
    * @brief The code being executed, after preprocessing.
    */
   std::string processedCode;
+  /**
+   * @brief The position in `code` at which each line starts.
+   */
+  std::vector<size_t> lineStarts;
   /**
    * @brief Indicates whether the debugger is ready to start simulation.
    */
@@ -120,7 +253,7 @@ struct DDSimulationState {
   /**
    * @brief The DD package used for simulation.
    */
-  std::unique_ptr<dd::Package<>> dd;
+  std::unique_ptr<DDPackage> dd;
   /**
    * @brief The iterator pointing to the current instruction in the simulation.
    */
@@ -144,19 +277,19 @@ struct DDSimulationState {
    */
   std::vector<size_t> instructionEnds;
   /**
-   * @brief A vector containing the instruction indices of all function
-   * definitions.
+   * @brief A bitset indicating for each instruction whether it is a custom gate
+   * definition.
    */
-  std::set<size_t> functionDefinitions;
+  std::vector<bool> functionDefinitions;
   /**
-   * @brief A map containing the instruction indices of all assertion, mapped to
-   * their `Assertion` objects.
+   * @brief A vector containing the `Assertion` object of each instruction, or
+   * `nullptr` for instructions that are not assertions.
    */
-  std::map<size_t, std::unique_ptr<Assertion>> assertionInstructions;
+  std::vector<std::unique_ptr<Assertion>> assertionInstructions;
   /**
-   * @brief Maps each instruction to its successor instruction.
+   * @brief A vector containing the successor instruction of each instruction.
    */
-  std::map<size_t, size_t> successorInstructions;
+  std::vector<size_t> successorInstructions;
   /**
    * @brief A vector containing all qubit registers.
    *
@@ -164,6 +297,11 @@ struct DDSimulationState {
    * respective declaration is found.
    */
   std::vector<QubitRegisterDefinition> qubitRegisters;
+  /**
+   * @brief Maps the symbol of each qubit register's name to its position in
+   * `qubitRegisters`.
+   */
+  std::unordered_map<SymbolId, size_t> qubitRegisterIndices;
   /**
    * @brief A vector containing all classical registers.
    *
@@ -191,48 +329,83 @@ struct DDSimulationState {
    * instruction pops this stack.
    */
   std::vector<size_t> callReturnStack;
+  /**
+   * @brief The frames of the custom gate calls in `callReturnStack`.
+   *
+   * This stack always has the same size as `callReturnStack`.
+   */
+  std::vector<CallFrame> callFrames;
   /**
    * @brief Maps each custom gate call instruction to the substitutions for this
    * call.
    *
-   * The substitution maps the names of the parameters of the custom gate to the
-   * names of the variables used to call the custom gate.
+   * The substitution maps the symbols of the parameters of the custom gate to
+   * the variables used to call the custom gate.
    */
-  std::map<size_t, std::map<std::string, std::string>> callSubstitutions;
+  std::map<size_t, std::map<SymbolId, VariableReference>> callSubstitutions;
   /**
    * @brief Saves elements removed from the `callReturnStack` so that they can
    * be re-used when stepping back.
    */
   std::vector<std::pair<size_t, size_t>> restoreCallReturnStack;
   /**
-   * @brief Maps each instruction index to a vector of its immediate data
-   * dependencies.
+   * @brief A table containing the immediate data dependencies of each
+   * instruction.
    *
-   * For each variable used by this instruction, this vector contains a
-   * reference to the last instruction that used it. It also contains the index
-   * of the variable in that dependency's argument list, so that it can be
-   * identified exactly.
+   * For each variable used by an instruction, its row contains a reference to
+   * the last instruction that used it. It also contains the index of the
+   * variable in that dependency's argument list, so that it can be identified
+   * exactly.
    */
-  std::map<size_t, std::vector<std::pair<size_t, size_t>>> dataDependencies;
+  CompressedTable<std::pair<size_t, size_t>> dataDependencies;
   /**
    * @brief Maps each custom gate definition to a set of all instructions that
    * call it.
    */
   std::map<size_t, std::set<size_t>> functionCallers;
   /**
-   * @brief A set of all breakpoints set by the user.
+   * @brief A bitset indicating for each instruction whether the user set a
+   * breakpoint at it.
    */
-  std::set<size_t> breakpoints;
+  std::vector<bool> breakpoints;
   /**
-   * @brief A vector containing the names of all target qubits for each
-   * instruction.
+   * @brief The indices of all instructions outside of custom gate bodies.
+   *
+   * These instructions do not overlap and are sorted by their position in the
+   * code, so the instruction at a given position can be found with a binary
+   * search.
    */
-  std::vector<std::vector<std::string>> targetQubits;
+  std::vector<size_t> topLevelInstructions;
+  /**
+   * @brief Maps the instructions of all breakpoints with conditions to their
+   * conditions.
+   */
+  std::map<size_t, BreakpointConditions> breakpointConditions;
+  /**
+   * @brief The symbol table containing the names of all variables and
+   * registers in the code.
+   *
+   * Names are only translated back to strings at the interface boundary.
+   */
+  SymbolTable symbols;
+  /**
+   * @brief A table containing the target variables of each instruction.
+   */
+  CompressedTable<VariableReference> targetQubits;
+  /**
+   * @brief A table containing the target variables of each assertion.
+   *
+   * The rows of instructions that are not assertions are empty.
+   */
+  CompressedTable<VariableReference> assertionTargets;
 
   /**
    * @brief Indicates whether the simulation should be paused.
+   *
+   * This may be set by a different thread than the one running the
+   * simulation.
    */
-  bool paused;
+  std::atomic<bool> paused;
 
   /**
    * @brief Stores the last instruction that failed an assertion.
@@ -243,6 +416,74 @@ struct DDSimulationState {
    */
   size_t lastMetBreakpoint;
 
+  /**
+   * @brief The most recent events of the execution trace.
+   *
+   * Has a capacity of 0 while tracing is disabled.
+   */
+  RingBuffer<TraceEvent> trace;
+  /**
+   * @brief Indicates whether the execution trace records the number of nodes
+   * of the state after each step that changes it.
+   */
+  bool traceNodeCounts;
+
+  /**
+   * @brief The outcomes of previous assertion checks.
+   *
+   * The states referenced by the keys are kept alive by the DD package until
+   * they are evicted from the cache.
+   */
+  std::unordered_map<AssertionCacheKey, bool, AssertionCacheKeyHash>
+      assertionCache;
+  /**
+   * @brief The keys of `assertionCache` in the order they were inserted.
+   *
+   * Used to evict the oldest entry once the cache is full.
+   */
+  std::deque<AssertionCacheKey> assertionCacheOrder;
+  /**
+   * @brief The final states of the reference circuits of circuit-equality
+   * assertions, indexed by the assertion instruction.
+   *
+   * Each reference circuit is only simulated the first time its assertion is
+   * checked. The states are stored in the same DD package as
+   * `simulationState`.
+   */
+  std::map<size_t, qc::VectorDD> circuitEqualityReferences;
+
+  /**
+   * @brief The number of bytes the DD package may use, or 0 if there is no
+   * limit.
+   */
+  size_t memoryBudget;
+  /**
+   * @brief The number of times exceeding `memoryBudget` forced a garbage
+   * collection.
+   */
+  size_t budgetCollections;
+  /**
+   * @brief Whether the last step was refused because the DD package exceeded
+   * `memoryBudget`.
+   */
+  bool budgetExceeded;
+  /**
+   * @brief The largest number of vector nodes referenced at the same time
+   * since the simulation state was initialized.
+   *
+   * It is tracked here instead of by the unique table, as pooled DD packages
+   * keep their statistics when they are reused.
+   */
+  size_t peakActiveVectorNodes;
+
+  /**
+   * @brief The counters and timers describing the work performed so far.
+   *
+   * They are only updated by the thread running the simulation, so they do
+   * not require synchronization.
+   */
+  Metrics metrics;
+
   /**
    * @brief The diagnostics instance used for analysis.
    */
@@ -263,6 +504,19 @@ Result ddsimInit(SimulationState* self);
  * @return The result of the operation.
  */
 Result ddsimLoadCode(SimulationState* self, const char* code);
+/**
+ * @brief Reloads the simulation state with an edited version of its code.
+ *
+ * The simulation steps back until none of the instructions executed so far
+ * were changed and continues from there, unless a measurement or reset makes
+ * this impossible. Reference states of circuit-equality assertions, cached
+ * assertion outcomes, and diagnostics data are kept for instructions located
+ * before the first change.
+ * @param self The instance to reload the code into.
+ * @param code The edited code to load.
+ * @return The result of the operation.
+ */
+Result ddsimReloadCode(SimulationState* self, const char* code);
 /**
  * @brief Steps the simulation forward by one instruction.
  * @param self The instance to step forward.
@@ -420,6 +674,42 @@ size_t ddsimGetInstructionCount(SimulationState* self);
  */
 Result ddsimGetInstructionPosition(SimulationState* self, size_t instruction,
                                    size_t* start, size_t* end);
+/**
+ * @brief Gets the positions of the first instructions in the code.
+ *
+ * For each of the first `count` instructions, this stores the same positions
+ * that `getInstructionPosition` returns.
+ * @param self The instance to query.
+ * @param count The number of instructions to query.
+ * @param starts An array of `count` elements to store the start positions.
+ * @param ends An array of `count` elements to store the end positions.
+ * @return The result of the operation.
+ */
+Result ddsimGetInstructionPositions(SimulationState* self, size_t count,
+                                    size_t* starts, size_t* ends);
+/**
+ * @brief Converts a position in the code to a line and column.
+ * @param self The instance to query.
+ * @param position The 0-indexed character position in the code.
+ * @param line A reference to a `size_t` integer to store the 0-indexed line.
+ * @param column A reference to a `size_t` integer to store the 0-indexed
+ * column.
+ * @return The result of the operation.
+ */
+Result ddsimGetCodeCoordinates(SimulationState* self, size_t position,
+                               size_t* line, size_t* column);
+/**
+ * @brief Converts a line and column in the code to a position.
+ * @param self The instance to query.
+ * @param line The 0-indexed line.
+ * @param column The 0-indexed column.
+ * @param position A reference to a `size_t` integer to store the 0-indexed
+ * character position in the code.
+ * @return The result of the operation. It fails if the line or column lies
+ * outside of the code.
+ */
+Result ddsimGetCodePosition(SimulationState* self, size_t line, size_t column,
+                            size_t* position);
 
 /**
  * @brief Gets the number of qubits used by the program.
@@ -536,6 +826,38 @@ Result ddsimGetStateVectorSub(SimulationState* self, size_t subStateSize,
  */
 Result ddsimSetBreakpoint(SimulationState* self, size_t desiredPosition,
                           size_t* targetInstruction);
+/**
+ * @brief Sets breakpoints at multiple desired positions in the code.
+ *
+ * The positions are given as 0-indexed character positions in the full code
+ * string. For each position, the instruction at which the breakpoint was set
+ * is stored in the `targetInstructions` array, or -1 if no breakpoint could be
+ * set at that position.
+ * @param self The instance to set the breakpoints in.
+ * @param desiredPositions An array of the desired positions in the code.
+ * @param count The number of desired positions.
+ * @param targetInstructions An array of `count` elements to store the target
+ * instructions in.
+ * @return The result of the operation.
+ */
+Result ddsimSetBreakpoints(SimulationState* self,
+                           const size_t* desiredPositions, size_t count,
+                           size_t* targetInstructions);
+/**
+ * @brief Attaches conditions to the breakpoint at the given instruction.
+ *
+ * The breakpoint is only hit if both conditions hold. Passing `nullptr` or an
+ * empty string for both conditions removes all conditions from the breakpoint.
+ * @param self The instance to set the conditions in.
+ * @param instruction The instruction of the breakpoint.
+ * @param condition The condition on the state of the simulation, or `nullptr`.
+ * @param hitCondition The condition on the hit count of the breakpoint, or
+ * `nullptr`.
+ * @return The result of the operation.
+ */
+Result ddsimSetBreakpointCondition(SimulationState* self, size_t instruction,
+                                  const char* condition,
+                                  const char* hitCondition);
 /**
  * @brief Clears all breakpoints set in the simulation.
  * @param self The instance to clear the breakpoints in.
@@ -570,6 +892,75 @@ Result ddsimGetStackDepth(SimulationState* self, size_t* depth);
  */
 Result ddsimGetStackTrace(SimulationState* self, size_t maxDepth,
                           size_t* output);
+/**
+ * @brief Sets the number of events kept in the execution trace.
+ *
+ * The trace is cleared when the simulation is reset or new code is loaded.
+ * Setting the capacity also clears it.
+ * @param self The instance to set the capacity in.
+ * @param capacity The maximum number of events to keep, or 0 to disable
+ * tracing.
+ * @param recordNodeCounts Whether to also record the number of nodes of the
+ * decision diagram after each step that changes the state.
+ * @return The result of the operation.
+ */
+Result ddsimSetTraceCapacity(SimulationState* self, size_t capacity,
+                             bool recordNodeCounts);
+/**
+ * @brief Gets the number of events currently stored in the execution trace.
+ * @param self The instance to query.
+ * @return The number of stored events.
+ */
+size_t ddsimGetTraceLength(SimulationState* self);
+/**
+ * @brief Gets a range of events from the execution trace.
+ *
+ * Events are indexed from the oldest stored event to the most recent one.
+ * @param self The instance to query.
+ * @param start The index of the first event to get.
+ * @param count The number of events to get.
+ * @param events A buffer to store the events.
+ * @return The result of the operation.
+ */
+Result ddsimGetTrace(SimulationState* self, size_t start, size_t count,
+                     TraceEvent* events);
+
+/**
+ * @brief Gets the counters and timers describing the work performed so far.
+ * @param self The instance to query.
+ * @param output A reference to a `Metrics` instance to store the metrics.
+ * @return The result of the operation.
+ */
+Result ddsimGetMetrics(SimulationState* self, Metrics* output);
+/**
+ * @brief Resets all counters and timers to zero.
+ * @param self The instance to reset the metrics of.
+ * @return The result of the operation.
+ */
+Result ddsimResetMetrics(SimulationState* self);
+
+/**
+ * @brief Gets the memory used by the decision diagrams of the simulation.
+ * @param self The instance to query.
+ * @param output A reference to a `MemoryStatistics` instance to store the
+ * statistics.
+ * @return The result of the operation.
+ */
+Result ddsimGetMemoryStatistics(SimulationState* self,
+                                MemoryStatistics* output);
+/**
+ * @brief Limits the memory used by the decision diagrams of the simulation.
+ *
+ * Steps that would apply an operation while the DD package exceeds the budget
+ * flush the compute tables, release the assertion cache and the
+ * circuit-equality references, and force a garbage collection, and are refused
+ * with `ERROR` if that is not enough.
+ * @param self The instance to limit.
+ * @param bytes The number of bytes the DD package may use, or 0 to remove the
+ * limit.
+ * @return The result of the operation.
+ */
+Result ddsimSetMemoryBudget(SimulationState* self, size_t bytes);
 
 /**
  * @brief Gets the diagnostics interface instance employed by this debugger.
@@ -598,18 +989,147 @@ Result destroyDDSimulationState(DDSimulationState* self);
  * @brief Preprocess the code to be executed.
  * @param code The code to preprocess.
  * @param ddsim The simulation state to preprocess the code for.
+ * @param instructions A reference to store the preprocessed instructions in.
+ * They refer to `ddsim->processedCode`.
  * @return The preprocessed code.
  */
-std::string preprocessAssertionCode(const char* code, DDSimulationState* ddsim);
+std::string preprocessAssertionCode(const char* code, DDSimulationState* ddsim,
+                                    std::vector<Instruction>& instructions);
+
+/**
+ * @brief Build the quantum computation directly from the preprocessed
+ * instructions, without parsing the preprocessed code again.
+ *
+ * Only programs consisting of register declarations, parameter-free standard
+ * gates, custom gate calls, measurements, resets, and barriers on single qubits
+ * are supported. For all other programs, nothing is built and the preprocessed
+ * code has to be imported instead.
+ *
+ * The standard gates are always available, so unlike the importer, programs
+ * are not checked for an `include` statement. Programs without any include
+ * are therefore built even if the importer would reject them. Includes other
+ * than `qelib1.inc` and `stdgates.inc` are left to the importer.
+ * @param ddsim The simulation state to build the quantum computation for.
+ * @param instructions The preprocessed instructions of the program.
+ * @param qc The quantum computation to add the operations to.
+ * @return True if the quantum computation was built, false if the program is
+ * not supported.
+ */
+bool buildQuantumComputation(DDSimulationState* ddsim,
+                             const std::vector<Instruction>& instructions,
+                             qc::QuantumComputation& qc);
 
 /**
  * @brief Checks an assertion against the current state of the simulation.
  * @param ddsim The simulation state to check the assertion against.
+ * @param instruction The instruction of the assertion to check.
  * @param assertion The assertion to check.
+ * @param qubits The qubit indices the assertion's targets resolve to.
  * @return True if the assertion is satisfied, false otherwise.
  */
-bool checkAssertion(DDSimulationState* ddsim,
-                    std::unique_ptr<Assertion>& assertion);
+bool checkAssertion(DDSimulationState* ddsim, size_t instruction,
+                    std::unique_ptr<Assertion>& assertion,
+                    const std::vector<size_t>& qubits);
+
+/**
+ * @brief Gets the qubit indices the targets of an assertion resolve to in the
+ * current call stack.
+ * @param ddsim The simulation state to query.
+ * @param instruction The instruction of the assertion.
+ * @return The qubit indices of the assertion's targets.
+ */
+std::vector<size_t> getAssertionQubits(DDSimulationState* ddsim,
+                                       size_t instruction);
+
+/**
+ * @brief Checks the assertion at the given instruction against the current
+ * state of the simulation.
+ *
+ * If the same assertion has already been checked on the same state with the
+ * same target qubits, the previous outcome is reused.
+ * @param ddsim The simulation state to check the assertion against.
+ * @param instruction The instruction of the assertion to check.
+ * @return True if the assertion is satisfied, false otherwise.
+ */
+bool checkAssertionCached(DDSimulationState* ddsim, size_t instruction);
+
+/**
+ * @brief Removes all entries from the assertion cache of the given simulation
+ * state.
+ *
+ * This also removes the cached reference states of circuit-equality
+ * assertions.
+ * @param ddsim The simulation state whose cache should be cleared.
+ */
+void clearAssertionCache(DDSimulationState* ddsim);
+
+/**
+ * @brief Computes the similarity between the sub-state of the given qubits and
+ * a reference state.
+ *
+ * The similarity is the magnitude of the inner product of both states. The
+ * amplitudes of the sub-state are ordered by the indices of the qubits, not by
+ * their order in `qubits`. Sub-states of at most `DENSE_EQUALITY_MAX_QUBITS`
+ * qubits are compared on their amplitudes, larger ones by
+ * `getSubStateSimilarityDD`.
+ * @param ddsim The simulation state to extract the sub-state from.
+ * @param qubits The qubits that make up the sub-state.
+ * @param reference The reference state to compare to.
+ * @return The similarity of both states.
+ * @throws std::runtime_error If the sub-state is entangled with other qubits.
+ */
+double getSubStateSimilarity(DDSimulationState* ddsim,
+                             const std::vector<size_t>& qubits,
+                             const Statevector& reference);
+
+/**
+ * @brief Extracts the sub-state of the given qubits from the decision diagram
+ * of the current state.
+ *
+ * The targets are first moved to the lowest levels of the diagram by SWAP
+ * operations. The sub-state is separable from the remaining qubits if and only
+ * if all sub-diagrams below the remaining qubits are equal up to a scalar
+ * factor. The runtime is linear in the size of the decision diagram.
+ * @param ddsim The simulation state to extract the sub-state from.
+ * @param qubits The qubits that make up the sub-state.
+ * @return The sub-state, where the `i`-th smallest target corresponds to the
+ * `i`-th level. It is not reference-counted and may not be normalized.
+ * @throws std::runtime_error If the sub-state is entangled with other qubits.
+ */
+qc::VectorDD getSubStateDD(DDSimulationState* ddsim,
+                           const std::vector<size_t>& qubits);
+
+/**
+ * @brief Computes the similarity between the sub-state of the given qubits and
+ * a reference state given as a decision diagram.
+ *
+ * No amplitudes are materialized, the inner product is computed on the
+ * decision diagrams of both states.
+ * @param ddsim The simulation state to extract the sub-state from.
+ * @param qubits The qubits that make up the sub-state.
+ * @param reference The reference state to compare to. It has to be a
+ * diagram over as many levels as there are qubits in `qubits`.
+ * @return The similarity of both states.
+ * @throws std::runtime_error If the sub-state is entangled with other qubits.
+ */
+double getSubStateSimilarityDD(DDSimulationState* ddsim,
+                               const std::vector<size_t>& qubits,
+                               const qc::VectorDD& reference);
+
+/**
+ * @brief Computes the similarity between the sub-state of the given qubits and
+ * a reference state on the decision diagram.
+ *
+ * The reference state is first converted into a decision diagram.
+ * @param ddsim The simulation state to extract the sub-state from.
+ * @param qubits The qubits that make up the sub-state.
+ * @param reference The reference state to compare to.
+ * @return The similarity of both states.
+ * @throws std::runtime_error If the sub-state is entangled with other qubits.
+ */
+double getSubStateSimilarityDD(DDSimulationState* ddsim,
+                               const std::vector<size_t>& qubits,
+                               const Statevector& reference);
 
 /**
  * @brief Gets the name of a classical bit by its index.
@@ -620,30 +1140,62 @@ bool checkAssertion(DDSimulationState* ddsim,
 std::string getClassicalBitName(DDSimulationState* ddsim, size_t index);
 
 /**
- * @brief Gets the qubit index from a variable name.
+ * @brief Pushes a custom gate call onto the call stack.
+ *
+ * The parameters of the called gate are resolved to the qubits they refer to
+ * using the frames that are already on the stack.
+ * @param ddsim The simulation state to modify.
+ * @param call The instruction of the custom gate call.
+ */
+void pushCallFrame(DDSimulationState* ddsim, size_t call);
+
+/**
+ * @brief Pops the innermost custom gate call from the call stack.
+ * @param ddsim The simulation state to modify.
+ */
+void popCallFrame(DDSimulationState* ddsim);
+
+/**
+ * @brief Clears the custom gate call stack.
+ * @param ddsim The simulation state to modify.
+ */
+void clearCallFrames(DDSimulationState* ddsim);
+
+/**
+ * @brief Gets the qubit index of a variable in the global scope.
+ * @param ddsim The simulation state to query.
+ * @param variable The reference to the global variable.
+ * @return The index of the qubit.
+ */
+size_t globalVariableToQubit(DDSimulationState* ddsim,
+                             const VariableReference& variable);
+
+/**
+ * @brief Gets the qubit index from a variable.
  *
  * If the variable is in the global scope, the index is based on the index of
  * the qubit in the state vector. If the variable is in a function scope, it
- * uses the current substitution to check what actual quantum variable is used
- * and computes the index based on that.
+ * looks up the qubit its parameter was resolved to when the call was pushed.
  * @param ddsim The simulation state to query.
- * @param variable The name of the variable.
+ * @param variable The reference to the variable.
  * @return The index of the qubit.
  */
-size_t variableToQubit(DDSimulationState* ddsim, const std::string& variable);
+size_t variableToQubit(DDSimulationState* ddsim,
+                       const VariableReference& variable);
 
 /**
- * @brief Gets the qubit index from a variable name.
+ * @brief Gets the qubit index from a variable.
  *
  * If the variable is in the global scope, the index is based on the index of
  * the qubit in the state vector. If the variable is in a function scope, the
  * index is based on the index of the qubit in the function's parameter list.
  * @param ddsim The simulation state to query.
- * @param variable The name of the variable.
+ * @param variable The reference to the variable.
+ * @param instruction The instruction in whose scope the variable is used.
  * @return The index of the qubit.
  */
 std::pair<size_t, size_t> variableToQubitAt(DDSimulationState* ddsim,
-                                            const std::string& variable,
+                                            const VariableReference& variable,
                                             size_t instruction);
 
 /**
@@ -680,5 +1232,5 @@ getPartialTraceFromStateVector(const Statevector& sv,
  * @param instruction The instruction index to get the target variables for.
  * @return The target variables.
  */
-std::vector<std::string> getTargetVariables(DDSimulationState* ddsim,
-                                            size_t instruction);
+std::vector<VariableReference> getTargetVariables(DDSimulationState* ddsim,
+                                                  size_t instruction);
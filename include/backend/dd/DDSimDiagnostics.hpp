@@ -7,16 +7,45 @@
 
 #include "backend/diagnostics.h"
 #include "common.h"
+#include "common/QubitTupleTable.hpp"
 #include "common/parsing/AssertionParsing.hpp"
 
 #include <cstddef>
 #include <map>
 #include <memory>
 #include <set>
+#include <utility>
 #include <vector>
 
 struct DDSimulationState;
 
+/**
+ * @brief Stores the runtime context of an assertion that failed during
+ * `runAll`.
+ */
+struct FailedAssertionRecord {
+  /**
+   * @brief The instruction of the failed assertion.
+   */
+  size_t instruction;
+  /**
+   * @brief The call instructions on the stack when the assertion failed.
+   *
+   * Together with `instruction`, it identifies the call site of the failure,
+   * which distinguishes failures of an assertion inside a custom gate.
+   */
+  std::vector<size_t> callStack;
+  /**
+   * @brief The qubit indices that the assertion targeted when it failed.
+   */
+  std::vector<size_t> targetQubits;
+  /**
+   * @brief The number of entries in the runtime qubit usage log when the
+   * assertion failed.
+   */
+  size_t qubitUsageLogSize;
+};
+
 /**
  * @brief The DD-simulator implementation of the `Diagnostics` interface.
  */
@@ -39,10 +68,33 @@ struct DDDiagnostics {
    */
   std::map<size_t, std::set<size_t>> nonZeroControls;
 
+  /**
+   * @brief The distinct qubit tuples that instructions have targeted at
+   * runtime.
+   */
+  QubitTupleTable qubitTuples;
+
   /**
    * @brief The actual qubits that each instruction has targeted.
+   *
+   * For each instruction, this stores the sorted IDs of all tuples in
+   * `qubitTuples` that the instruction has been executed on.
+   */
+  std::vector<std::vector<QubitTupleTable::TupleId>> actualQubits;
+
+  /**
+   * @brief The (instruction, qubit tuple) pairs in the order in which they were
+   * first encountered at runtime.
+   *
+   * Taking the size of this log acts as a snapshot of the runtime qubit usage
+   * at a given point in time.
    */
-  std::map<size_t, std::set<std::vector<size_t>>> actualQubits;
+  std::vector<std::pair<size_t, QubitTupleTable::TupleId>> qubitUsageLog;
+
+  /**
+   * @brief The assertions that failed during the last `runAll` call.
+   */
+  std::vector<FailedAssertionRecord> failedAssertions;
 };
 
 /**
@@ -161,6 +213,31 @@ Result dddiagnosticsGetZeroControlInstructions(Diagnostics* self,
 size_t dddiagnosticsPotentialErrorCauses(Diagnostics* self, ErrorCause* output,
                                          size_t count);
 
+/**
+ * @brief Extract a ranked list of potential error causes for all assertions
+ * that failed during the last `runAll` call.
+ *
+ * Each error cause is only reported once, even if it explains several failed
+ * assertions. Error causes that explain failures at more call sites, given by
+ * the assertion and the call stack it failed in, are reported first.
+ * @param self The diagnostics instance to query.
+ * @param output An array of error causes to be filled. It is expected to have
+ * space for at least `count` elements.
+ * @param count The maximum number of error causes to return.
+ * @return The number of error causes found.
+ */
+size_t dddiagnosticsPotentialErrorCausesAll(Diagnostics* self,
+                                            ErrorCause* output, size_t count);
+
+/**
+ * @brief Get statistics about the runtime data collected by the diagnostics.
+ * @param self The diagnostics instance to query.
+ * @param output The statistics structure to fill.
+ * @return The result of the operation.
+ */
+Result dddiagnosticsGetStatistics(Diagnostics* self,
+                                  DiagnosticsStatistics* output);
+
 /**
  * @brief Creates a new `DDDiagnostics` instance.
  *
@@ -186,6 +263,35 @@ Result destroyDDDiagnostics([[maybe_unused]] DDDiagnostics* self);
  */
 void dddiagnosticsOnStepForward(DDDiagnostics* diagnostics, size_t instruction);
 
+/**
+ * @brief Called, whenever an assertion fails during `runAll` to record its
+ * runtime context.
+ * @param diagnostics The diagnostics instance to update.
+ * @param instruction The instruction of the failed assertion.
+ */
+void dddiagnosticsOnAssertionFailed(DDDiagnostics* diagnostics,
+                                    size_t instruction);
+
+/**
+ * @brief Removes all failed assertions recorded during a previous `runAll`
+ * call.
+ * @param diagnostics The diagnostics instance to update.
+ */
+void dddiagnosticsClearFailedAssertions(DDDiagnostics* diagnostics);
+
+/**
+ * @brief Discards the runtime data recorded for all instructions starting at
+ * the given instruction, as well as all failed assertion records.
+ *
+ * Called when new code is loaded. The data of the instructions before
+ * `firstInstruction` is kept, so it must only be used for instructions that
+ * did not change.
+ * @param diagnostics The diagnostics instance to update.
+ * @param firstInstruction The first instruction to discard the data of.
+ */
+void dddiagnosticsDiscardRuntimeData(DDDiagnostics* diagnostics,
+                                     size_t firstInstruction);
+
 /**
  * @brief Tries to find potential errors caused by missing interactions at
  * runtime.
@@ -194,14 +300,12 @@ void dddiagnosticsOnStepForward(DDDiagnostics* diagnostics, size_t instruction);
  * @param diagnostics The diagnostics instance to query.
  * @param state The simulation state.
  * @param instruction The instruction for which to investigate interactions.
- * @param assertion The assertion that failed.
  * @param output An array of error causes to be filled.
  * @param count The maximum number of error causes to return.
  * @return The number of error causes found.
  */
 size_t tryFindMissingInteraction(DDDiagnostics* diagnostics,
                                  DDSimulationState* state, size_t instruction,
-                                 const std::unique_ptr<Assertion>& assertion,
                                  ErrorCause* output, size_t count);
 
 /**
@@ -5,7 +5,7 @@
  */
 
 #pragma once
-// NOLINTBEGIN(modernize-use-using)
+// NOLINTBEGIN(modernize-use-using, performance-enum-size)
 
 #include "common.h"
 #include "diagnostics.h"
@@ -15,6 +15,258 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Represents the type of an event in the execution trace.
+ */
+typedef enum {
+  /**
+   * @brief An instruction was executed.
+   *
+   * The `instruction` is the executed instruction. Events caused by executing
+   * it, such as measurement outcomes, follow this event.
+   */
+  TraceStepForward,
+  /**
+   * @brief An instruction was reverted.
+   *
+   * The `instruction` is the reverted instruction, which is the current
+   * instruction afterwards. As the simulation stops before failing
+   * assertions, a failing assertion is recorded as a step forward followed by
+   * a step backward.
+   */
+  TraceStepBackward,
+  /**
+   * @brief A custom gate was called.
+   *
+   * The `instruction` is the call instruction and the `value` is the first
+   * instruction of the called gate.
+   */
+  TraceCall,
+  /**
+   * @brief A custom gate returned to its caller.
+   *
+   * The `instruction` is the `return` instruction of the gate and the `value`
+   * is the instruction the execution continues at.
+   */
+  TraceReturn,
+  /**
+   * @brief A qubit was measured, either by a measurement or a reset.
+   *
+   * The `instruction` is the measuring instruction. The `value` is twice the
+   * index of the measured qubit, plus 1 if the outcome was |1>.
+   */
+  TraceMeasurement,
+  /**
+   * @brief The number of nodes of the decision diagram representing the state
+   * after an instruction changed it.
+   *
+   * The `instruction` is the executed or reverted instruction and the `value`
+   * is the number of nodes. These events are only recorded if requested.
+   */
+  TraceNodeCount
+} TraceEventType;
+
+/**
+ * @brief Represents an event in the execution trace.
+ */
+typedef struct {
+  /**
+   * @brief The type of the event.
+   */
+  TraceEventType type;
+  /**
+   * @brief The instruction the event refers to.
+   */
+  size_t instruction;
+  /**
+   * @brief Additional information, depending on the type of the event.
+   */
+  size_t value;
+} TraceEvent;
+
+/**
+ * @brief Counters and timers describing the work performed by a simulation
+ * state.
+ *
+ * They accumulate over all loaded programs until they are reset, so that the
+ * time spent in a session can be attributed to the responsible subsystem. All
+ * times are given in nanoseconds.
+ */
+typedef struct {
+  /**
+   * @brief The number of decision diagram multiplications applying an
+   * operation to the state.
+   */
+  size_t ddMultiplications;
+  /**
+   * @brief The number of garbage collections that freed unused nodes.
+   */
+  size_t garbageCollections;
+  /**
+   * @brief The total time spent in garbage collections.
+   */
+  size_t garbageCollectionTime;
+  /**
+   * @brief The number of checked entanglement assertions.
+   */
+  size_t entanglementAssertionChecks;
+  /**
+   * @brief The total time spent checking entanglement assertions.
+   */
+  size_t entanglementAssertionTime;
+  /**
+   * @brief The number of checked superposition assertions.
+   */
+  size_t superpositionAssertionChecks;
+  /**
+   * @brief The total time spent checking superposition assertions.
+   */
+  size_t superpositionAssertionTime;
+  /**
+   * @brief The number of checked equality assertions against a state vector.
+   */
+  size_t statevectorEqualityAssertionChecks;
+  /**
+   * @brief The total time spent checking equality assertions against a state
+   * vector.
+   */
+  size_t statevectorEqualityAssertionTime;
+  /**
+   * @brief The number of checked equality assertions against a circuit.
+   */
+  size_t circuitEqualityAssertionChecks;
+  /**
+   * @brief The total time spent checking equality assertions against a
+   * circuit, including the simulation of the reference circuits.
+   */
+  size_t circuitEqualityAssertionTime;
+  /**
+   * @brief The number of assertion checks answered by cached outcomes.
+   *
+   * These checks are not included in the per-type counters.
+   */
+  size_t assertionCacheHits;
+  /**
+   * @brief The number of assertion checks that had to be computed.
+   */
+  size_t assertionCacheMisses;
+  /**
+   * @brief The number of times the full state vector was computed from the
+   * decision diagram.
+   */
+  size_t stateVectorExpansions;
+  /**
+   * @brief The total number of amplitudes computed by state vector
+   * expansions.
+   */
+  size_t stateVectorExpansionAmplitudes;
+  /**
+   * @brief The number of diagnostics callbacks invoked while stepping through
+   * the program.
+   */
+  size_t diagnosticsCallbacks;
+  /**
+   * @brief The total time spent in diagnostics callbacks.
+   */
+  size_t diagnosticsCallbackTime;
+  /**
+   * @brief The number of loaded programs.
+   */
+  size_t codeLoads;
+  /**
+   * @brief The total time spent preprocessing loaded code, which parses the
+   * instructions, assertions, and custom gate definitions.
+   */
+  size_t preprocessingTime;
+  /**
+   * @brief The total time spent building the quantum computation of loaded
+   * code from the preprocessed instructions.
+   */
+  size_t circuitConstructionTime;
+} Metrics;
+
+/**
+ * @brief Describes the memory used by the decision diagrams of a simulation
+ * state.
+ */
+typedef struct {
+  /**
+   * @brief The number of vector nodes stored in the unique table, including
+   * unused nodes that were not yet collected.
+   */
+  size_t vectorNodes;
+  /**
+   * @brief The number of vector nodes that are currently referenced.
+   */
+  size_t activeVectorNodes;
+  /**
+   * @brief The largest number of vector nodes that were referenced at the
+   * same time.
+   */
+  size_t peakActiveVectorNodes;
+  /**
+   * @brief The number of matrix nodes stored in the unique table, including
+   * unused nodes that were not yet collected.
+   */
+  size_t matrixNodes;
+  /**
+   * @brief The number of matrix nodes that are currently referenced.
+   */
+  size_t activeMatrixNodes;
+  /**
+   * @brief The number of bytes used by all stored vector and matrix nodes.
+   */
+  size_t nodeMemory;
+  /**
+   * @brief The number of bytes used by the decision diagram package, including
+   * the nodes and numbers in use, the unique tables, and the compute tables.
+   */
+  size_t packageMemory;
+  /**
+   * @brief The number of bytes the decision diagram package may use, or 0 if
+   * there is no limit.
+   */
+  size_t memoryBudget;
+  /**
+   * @brief The number of times exceeding the memory budget forced a garbage
+   * collection.
+   */
+  size_t budgetCollections;
+  /**
+   * @brief Whether the last step was refused because the decision diagram
+   * package exceeded the memory budget.
+   */
+  bool budgetExceeded;
+  /**
+   * @brief The number of entries in the compute table of matrix-vector
+   * multiplications.
+   */
+  size_t multiplicationTableEntries;
+  /**
+   * @brief The number of buckets of the compute table of matrix-vector
+   * multiplications.
+   */
+  size_t multiplicationTableBuckets;
+  /**
+   * @brief The ratio of lookups in the compute table of matrix-vector
+   * multiplications that found a result.
+   */
+  double multiplicationTableHitRatio;
+  /**
+   * @brief The number of entries in the compute table of vector additions.
+   */
+  size_t additionTableEntries;
+  /**
+   * @brief The number of buckets of the compute table of vector additions.
+   */
+  size_t additionTableBuckets;
+  /**
+   * @brief The ratio of lookups in the compute table of vector additions that
+   * found a result.
+   */
+  double additionTableHitRatio;
+} MemoryStatistics;
+
 /**
  * @brief A C-style interface for the debugging and simulation interface.
  *
@@ -44,6 +296,21 @@ struct SimulationStateStruct {
    */
   Result (*loadCode)(SimulationState* self, const char* code);
 
+  /**
+   * @brief Loads an edited version of the current code into the simulation
+   * state.
+   *
+   * Unlike `loadCode`, this reuses results for the unchanged beginning of the
+   * code. If instructions executed so far were changed, the simulation first
+   * steps back to the last unchanged one, and then continues from there. The
+   * diagnostics data of unchanged instructions is kept as well. If no code was
+   * loaded before, it behaves like `loadCode`.
+   * @param self The instance to reload the code into.
+   * @param code The edited code to load.
+   * @return The result of the operation.
+   */
+  Result (*reloadCode)(SimulationState* self, const char* code);
+
   /**
    * @brief Steps the simulation forward by one instruction.
    * @param self The instance to step forward.
@@ -220,6 +487,53 @@ struct SimulationStateStruct {
   Result (*getInstructionPosition)(SimulationState* self, size_t instruction,
                                    size_t* start, size_t* end);
 
+  /**
+   * @brief Gets the positions of the first instructions in the code.
+   *
+   * For each of the first `count` instructions, this stores the same positions
+   * that `getInstructionPosition` returns, so that all instructions can be
+   * queried in a single call.
+   * @param self The instance to query.
+   * @param count The number of instructions to query.
+   * @param starts An array of `count` elements to store the start positions.
+   * @param ends An array of `count` elements to store the end positions.
+   * @return The result of the operation. It fails if `count` exceeds the
+   * number of instructions.
+   */
+  Result (*getInstructionPositions)(SimulationState* self, size_t count,
+                                    size_t* starts, size_t* ends);
+
+  /**
+   * @brief Converts a position in the code to a line and column.
+   *
+   * The start of each line is determined once when the code is loaded, so each
+   * conversion only requires a binary search. A line break belongs to the line
+   * it ends.
+   * @param self The instance to query.
+   * @param position The 0-indexed character position in the code.
+   * @param line A reference to a `size_t` integer to store the 0-indexed line.
+   * @param column A reference to a `size_t` integer to store the 0-indexed
+   * column.
+   * @return The result of the operation. It fails if the position lies beyond
+   * the end of the code.
+   */
+  Result (*getCodeCoordinates)(SimulationState* self, size_t position,
+                               size_t* line, size_t* column);
+
+  /**
+   * @brief Converts a line and column in the code to a position.
+   * @param self The instance to query.
+   * @param line The 0-indexed line.
+   * @param column The 0-indexed column.
+   * @param position A reference to a `size_t` integer to store the 0-indexed
+   * character position in the code.
+   * @return The result of the operation. It fails if the code does not have
+   * the given line, or if the line does not have the given column. The line
+   * break at the end of a line is its last column.
+   */
+  Result (*getCodePosition)(SimulationState* self, size_t line, size_t column,
+                            size_t* position);
+
   /**
    * @brief Gets the number of qubits used by the program.
    * @param self The instance to query.
@@ -339,6 +653,51 @@ struct SimulationStateStruct {
   Result (*setBreakpoint)(SimulationState* self, size_t desiredPosition,
                           size_t* targetInstruction);
 
+  /**
+   * @brief Sets breakpoints at multiple desired positions in the code.
+   *
+   * The positions are given as 0-indexed character positions in the full code
+   * string. For each position, the instruction at which the breakpoint was set
+   * is stored in the `targetInstructions` array. If no breakpoint can be set at
+   * a position, -1 is stored instead.
+   * @param self The instance to set the breakpoints in.
+   * @param desiredPositions An array of the desired positions in the code as
+   * 0-indexed character indices.
+   * @param count The number of desired positions.
+   * @param targetInstructions An array of `count` elements to store the target
+   * instructions in.
+   * @return The result of the operation.
+   */
+  Result (*setBreakpoints)(SimulationState* self,
+                           const size_t* desiredPositions, size_t count,
+                           size_t* targetInstructions);
+
+  /**
+   * @brief Attaches conditions to the breakpoint at the given instruction.
+   *
+   * The condition compares a classical bit (`c[0] == 1`), a classical register
+   * (`c >= 2`), or the probability of measuring a qubit in the state |1>
+   * (`P(q[0]) > 0.5`) to a value. The hit condition compares the number of
+   * times the breakpoint was reached while its condition held since the last
+   * reset to a number (`>= 3`) or checks whether it is a multiple of a number
+   * (`% 2`).
+   *
+   * The breakpoint is only hit if both conditions hold. Passing `nullptr` or an
+   * empty string for both conditions removes all conditions from the
+   * breakpoint.
+   * @param self The instance to set the conditions in.
+   * @param instruction The instruction of the breakpoint.
+   * @param condition The condition on the state of the simulation, or
+   * `nullptr`.
+   * @param hitCondition The condition on the hit count of the breakpoint, or
+   * `nullptr`.
+   * @return The result of the operation. `ERROR` is returned if no breakpoint
+   * is set at the instruction or a condition is invalid.
+   */
+  Result (*setBreakpointCondition)(SimulationState* self, size_t instruction,
+                                   const char* condition,
+                                   const char* hitCondition);
+
   /**
    * @brief Clears all breakpoints set in the simulation.
    * @param self The instance to clear the breakpoints in.
@@ -376,6 +735,91 @@ struct SimulationStateStruct {
   Result (*getStackTrace)(SimulationState* self, size_t maxDepth,
                           size_t* output);
 
+  /**
+   * @brief Sets the number of events kept in the execution trace.
+   *
+   * While tracing is enabled, each step records its instruction, custom gate
+   * calls and returns, and measurement outcomes. The memory for the trace is
+   * allocated once, and when it is full, each new event replaces the oldest
+   * one. Together with the code, the trace describes the executed path, so it
+   * can be used to analyze or replay a run after it finished. \n\n
+   *
+   * The trace is cleared when the simulation is reset or new code is loaded.
+   * Setting the capacity also clears it.
+   * @param self The instance to set the capacity in.
+   * @param capacity The maximum number of events to keep, or 0 to disable
+   * tracing.
+   * @param recordNodeCounts Whether to also record the number of nodes of the
+   * decision diagram after each step that changes the state.
+   * @return The result of the operation.
+   */
+  Result (*setTraceCapacity)(SimulationState* self, size_t capacity,
+                             bool recordNodeCounts);
+
+  /**
+   * @brief Gets the number of events currently stored in the execution trace.
+   * @param self The instance to query.
+   * @return The number of stored events.
+   */
+  size_t (*getTraceLength)(SimulationState* self);
+
+  /**
+   * @brief Gets a range of events from the execution trace.
+   *
+   * Events are indexed from the oldest stored event to the most recent one.
+   * @param self The instance to query.
+   * @param start The index of the first event to get.
+   * @param count The number of events to get.
+   * @param events A buffer to store the events. It must be large enough to
+   * hold `count` events.
+   * @return The result of the operation. `ERROR` is returned if the range
+   * exceeds the stored events.
+   */
+  Result (*getTrace)(SimulationState* self, size_t start, size_t count,
+                     TraceEvent* events);
+
+  /**
+   * @brief Gets the counters and timers describing the work performed so far.
+   * @param self The instance to query.
+   * @param output A reference to a `Metrics` instance to store the metrics.
+   * @return The result of the operation.
+   */
+  Result (*getMetrics)(SimulationState* self, Metrics* output);
+
+  /**
+   * @brief Resets all counters and timers to zero.
+   * @param self The instance to reset the metrics of.
+   * @return The result of the operation.
+   */
+  Result (*resetMetrics)(SimulationState* self);
+
+  /**
+   * @brief Gets the memory used by the decision diagrams of the simulation.
+   * @param self The instance to query.
+   * @param output A reference to a `MemoryStatistics` instance to store the
+   * statistics.
+   * @return The result of the operation.
+   */
+  Result (*getMemoryStatistics)(SimulationState* self,
+                                MemoryStatistics* output);
+
+  /**
+   * @brief Limits the memory used by the decision diagrams of the simulation.
+   *
+   * Before a step applies an operation, the memory of the decision diagram
+   * package is compared to the budget. If it exceeds the budget, the compute
+   * tables are flushed, the states cached for assertions are released, and a
+   * garbage collection is forced. If the package still exceeds the budget
+   * afterwards, the step is refused without changing the state and returns
+   * `ERROR`, and `budgetExceeded` is set in the memory statistics, so that
+   * running the simulation stops before the process runs out of memory.
+   * @param self The instance to limit.
+   * @param bytes The number of bytes the decision diagram package may use, or
+   * 0 to remove the limit.
+   * @return The result of the operation.
+   */
+  Result (*setMemoryBudget)(SimulationState* self, size_t bytes);
+
   /**
    * @brief Gets the diagnostics interface instance employed by this debugger.
    * @param self The instance to query.
@@ -388,4 +832,4 @@ struct SimulationStateStruct {
 }
 #endif
 
-// NOLINTEND(modernize-use-using)
+// NOLINTEND(modernize-use-using, performance-enum-size)
@@ -54,6 +54,28 @@ struct ErrorCauseStruct {
   size_t instruction;
 };
 
+/**
+ * @brief Represents statistics about the runtime data collected by the
+ * diagnostics.
+ */
+typedef struct {
+  /**
+   * @brief The number of distinct qubit tuples targeted by instructions at
+   * runtime.
+   */
+  size_t distinctQubitTuples;
+  /**
+   * @brief The number of distinct (instruction, qubit tuple) pairs recorded at
+   * runtime.
+   */
+  size_t qubitUsageEntries;
+  /**
+   * @brief The approximate number of bytes used to store the runtime qubit
+   * usage.
+   */
+  size_t qubitUsageBytes;
+} DiagnosticsStatistics;
+
 /**
  * @brief An interface representing the diagnostic capabilities of a debugger.
  */
@@ -174,6 +196,39 @@ struct DiagnosticsStruct {
    */
   size_t (*potentialErrorCauses)(Diagnostics* self, ErrorCause* output,
                                  size_t count);
+
+  /**
+   * @brief Extract a ranked list of potential error causes for all assertions
+   * that failed during the last `runAll` call.
+   *
+   * Up to `count` error causes will be returned. Each error cause is only
+   * reported once, even if it explains several failed assertions. Error causes
+   * that explain failures at more call sites are reported first. A call site
+   * is a failed assertion together with the custom gate calls it was reached
+   * through, so an assertion inside a custom gate counts once for each call
+   * it failed in.\n\n
+   *
+   * This method should be run after the program has been executed using
+   * `runAll`.
+   * @param self The diagnostics instance to query.
+   * @param output An array of error causes to be filled. It is expected to have
+   * space for at least `count` elements.
+   * @param count The maximum number of error causes to return.
+   * @return The number of error causes found.
+   */
+  size_t (*potentialErrorCausesAll)(Diagnostics* self, ErrorCause* output,
+                                    size_t count);
+
+  /**
+   * @brief Get statistics about the runtime data collected by the diagnostics.
+   *
+   * This can be used to monitor the memory consumption of the dynamic analysis
+   * methods.
+   * @param self The diagnostics instance to query.
+   * @param output The statistics structure to fill.
+   * @return The result of the operation.
+   */
+  Result (*getStatistics)(Diagnostics* self, DiagnosticsStatistics* output);
 };
 
 #ifdef __cplusplus
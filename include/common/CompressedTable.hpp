@@ -0,0 +1,80 @@
+/**
+ * @file CompressedTable.hpp
+ * @brief Provides a table that stores a variable-length row for each index.
+ *
+ * Storing a separate vector for each row requires one heap allocation per row
+ * and scatters the rows across memory. This table stores all rows back-to-back
+ * in a single flat buffer, in compressed sparse row form.
+ */
+
+#pragma once
+
+#include "common/Span.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Stores a variable-length row of elements for each index.
+ *
+ * Rows can only be appended, so the index of a row is the number of rows that
+ * were added before it.
+ * @tparam T The type of the elements in the rows.
+ */
+template <typename T> class CompressedTable {
+public:
+  /**
+   * @brief Appends a new row containing the given elements.
+   * @tparam Iterator The type of the iterators.
+   * @param begin The iterator to the first element of the row.
+   * @param end The iterator past the last element of the row.
+   */
+  template <typename Iterator> void addRow(Iterator begin, Iterator end) {
+    storage.insert(storage.end(), begin, end);
+    offsets.push_back(storage.size());
+  }
+
+  /**
+   * @brief Appends a new row containing the given elements.
+   * @param row The elements of the row.
+   */
+  void addRow(const std::vector<T>& row) { addRow(row.begin(), row.end()); }
+
+  /**
+   * @brief Gets the elements of the row with the given index.
+   * @param row The index of the row.
+   * @return A span containing the elements of the row.
+   */
+  Span<const T> operator[](size_t row) const {
+    const auto start = offsets[row];
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return {storage.data() + start, offsets[row + 1] - start};
+  }
+
+  /**
+   * @brief Gets the number of rows in the table.
+   * @return The number of rows.
+   */
+  [[nodiscard]] size_t size() const { return offsets.size() - 1; }
+
+  /**
+   * @brief Removes all rows from the table.
+   */
+  void clear() {
+    storage.clear();
+    offsets.assign(1, 0);
+  }
+
+private:
+  /**
+   * @brief The elements of all rows, stored back-to-back.
+   */
+  std::vector<T> storage;
+
+  /**
+   * @brief The start offset of each row in `storage`.
+   *
+   * Contains one additional element marking the end of the last row.
+   */
+  std::vector<size_t> offsets{0};
+};
@@ -0,0 +1,98 @@
+/**
+ * @file ProgramGenerator.hpp
+ * @brief Provides a generator for large synthetic programs.
+ *
+ * The generated programs use all constructs supported by the debugger, such as
+ * nested custom gates, assertions, measurements, and classic-controlled gates,
+ * in configurable amounts. They are used to test and benchmark how the
+ * debugger scales to programs with many instructions.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief The options controlling the shape of a generated program.
+ *
+ * Densities are probabilities between 0 and 1 that a top-level instruction is
+ * of the given kind. Their sum must not exceed 1; all remaining instructions
+ * are random gates from {h, s, t, x, cx}.
+ */
+struct ProgramGeneratorOptions {
+  /**
+   * @brief The number of qubits of the program. Must be at least 2.
+   *
+   * A classical register of the same size is declared as well.
+   */
+  size_t numQubits = 8;
+  /**
+   * @brief The number of top-level instructions, excluding declarations and
+   * custom gate definitions.
+   */
+  size_t numInstructions = 1000;
+  /**
+   * @brief The number of nested custom gate definitions.
+   *
+   * Each custom gate calls the previously defined one.
+   */
+  size_t nestingDepth = 2;
+  /**
+   * @brief The number of calls each custom gate makes to the previously
+   * defined one.
+   *
+   * A call to the outermost custom gate executes `callFanOut^nestingDepth`
+   * calls in total.
+   */
+  size_t callFanOut = 2;
+  /**
+   * @brief The density of calls to the outermost custom gate.
+   */
+  double callDensity = 0.1;
+  /**
+   * @brief The density of entanglement assertions.
+   */
+  double entanglementAssertionDensity = 0;
+  /**
+   * @brief The density of superposition assertions.
+   */
+  double superpositionAssertionDensity = 0;
+  /**
+   * @brief The density of equality assertions against a state vector.
+   */
+  double statevectorEqualityAssertionDensity = 0;
+  /**
+   * @brief The density of equality assertions against the state produced by a
+   * circuit.
+   */
+  double circuitEqualityAssertionDensity = 0;
+  /**
+   * @brief The density of measurements.
+   */
+  double measurementDensity = 0;
+  /**
+   * @brief The density of classic-controlled gates.
+   */
+  double classicControlDensity = 0;
+  /**
+   * @brief The probability that an instruction is surrounded by comments,
+   * blank lines, or irregular whitespace.
+   */
+  double noiseDensity = 0;
+  /**
+   * @brief The seed of the random number generator.
+   *
+   * The same options always produce the same program.
+   */
+  uint32_t seed = 42;
+};
+
+/**
+ * @brief Generate a random program with the given options.
+ * @param options The options controlling the shape of the program.
+ * @return The code of the program.
+ * @throws std::invalid_argument If the options are invalid.
+ */
+std::string generateProgram(const ProgramGeneratorOptions& options);
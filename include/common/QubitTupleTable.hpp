@@ -0,0 +1,90 @@
+/**
+ * @file QubitTupleTable.hpp
+ * @brief Provides a table that interns tuples of qubit indices.
+ *
+ * During execution, the same instructions are executed on the same qubits over
+ * and over again. Storing each tuple of qubits only once and referring to it by
+ * a small integer ID keeps runtime bookkeeping compact.
+ */
+
+#pragma once
+
+#include "common/Span.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Interns tuples of qubit indices and assigns a unique ID to each of
+ * them.
+ *
+ * All tuples are stored back-to-back in a single flat buffer, so interning a
+ * tuple does not require a separate heap allocation per tuple.
+ */
+class QubitTupleTable {
+public:
+  /**
+   * @brief The type used for the IDs of interned tuples.
+   */
+  using TupleId = uint32_t;
+
+  /**
+   * @brief Interns the given tuple and returns its ID.
+   *
+   * If the tuple was already interned before, the existing ID is returned.
+   * @param qubits The qubit indices of the tuple.
+   * @return The ID of the interned tuple.
+   */
+  TupleId intern(const std::vector<size_t>& qubits);
+
+  /**
+   * @brief Gets the qubit indices of the tuple with the given ID.
+   * @param id The ID of the tuple.
+   * @return A span containing the qubit indices of the tuple.
+   */
+  [[nodiscard]] Span<const size_t> get(TupleId id) const;
+
+  /**
+   * @brief Gets the number of distinct tuples in the table.
+   * @return The number of distinct tuples.
+   */
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * @brief Gets the approximate number of bytes allocated by the table.
+   * @return The number of bytes allocated by the table.
+   */
+  [[nodiscard]] size_t memoryUsage() const;
+
+  /**
+   * @brief Removes all tuples from the table.
+   */
+  void clear();
+
+private:
+  /**
+   * @brief The qubit indices of all interned tuples, stored back-to-back.
+   */
+  std::vector<size_t> storage;
+
+  /**
+   * @brief The start offset of each tuple in `storage`.
+   *
+   * Contains one additional element marking the end of the last tuple.
+   */
+  std::vector<size_t> offsets{0};
+
+  /**
+   * @brief Maps the hash of a tuple to the IDs of all tuples with that hash.
+   */
+  std::unordered_multimap<size_t, TupleId> lookup;
+
+  /**
+   * @brief Computes the hash of a tuple of qubit indices.
+   * @param qubits The qubit indices of the tuple.
+   * @return The hash of the tuple.
+   */
+  static size_t hashTuple(const std::vector<size_t>& qubits);
+};
@@ -0,0 +1,131 @@
+/**
+ * @file RingBuffer.hpp
+ * @brief Provides a fixed-capacity buffer that keeps the most recent elements.
+ *
+ * All memory is allocated when the capacity is set, so appending an element
+ * never allocates. Once the buffer is full, each new element replaces the
+ * oldest one.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Stores the most recent elements appended to it, up to a fixed
+ * capacity.
+ *
+ * Elements are indexed from the oldest stored element to the most recent one.
+ * @tparam T The type of the stored elements.
+ */
+template <typename T> class RingBuffer {
+public:
+  /**
+   * @brief Sets the maximum number of elements stored in the buffer.
+   *
+   * This removes all stored elements. A capacity of 0 disables the buffer, so
+   * that appended elements are discarded.
+   * @param capacity The new capacity of the buffer.
+   */
+  void setCapacity(size_t capacity) {
+    storage.assign(capacity, T{});
+    storage.shrink_to_fit();
+    clear();
+  }
+
+  /**
+   * @brief Gets the maximum number of elements stored in the buffer.
+   * @return The capacity of the buffer.
+   */
+  [[nodiscard]] size_t capacity() const { return storage.size(); }
+
+  /**
+   * @brief Appends an element, replacing the oldest element if the buffer is
+   * full.
+   * @param element The element to append.
+   */
+  void push(const T& element) {
+    if (storage.empty()) {
+      return;
+    }
+    storage[next] = element;
+    next = next + 1 == storage.size() ? 0 : next + 1;
+    count = std::min(count + 1, storage.size());
+  }
+
+  /**
+   * @brief Gets the element with the given index.
+   * @param index The index of the element, where 0 is the oldest stored
+   * element.
+   * @return The element with the given index.
+   * @throws std::out_of_range If the index is not smaller than the number of
+   * stored elements, which includes every index if the capacity is 0.
+   */
+  const T& operator[](size_t index) const {
+    if (index >= count) {
+      throw std::out_of_range("Ring buffer index out of range");
+    }
+    return storage[(next + storage.size() - count + index) % storage.size()];
+  }
+
+  /**
+   * @brief Copies a range of stored elements, starting from the oldest.
+   * @param start The index of the first element to copy.
+   * @param length The number of elements to copy.
+   * @param output The memory to copy the elements to. It must be large enough
+   * to hold `length` elements.
+   * @return True, if the range was valid and the elements were copied.
+   */
+  bool copy(size_t start, size_t length, T* output) const {
+    if (start > count || length > count - start) {
+      return false;
+    }
+    // The range consists of at most two contiguous parts, as it might wrap
+    // around the end of the storage.
+    const auto first = (next + storage.size() - count + start) %
+                       std::max<size_t>(storage.size(), 1);
+    const auto firstLength = std::min(length, storage.size() - first);
+    const auto begin = storage.begin() + static_cast<std::ptrdiff_t>(first);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    auto* const secondOutput = output + firstLength;
+    std::copy(begin, begin + static_cast<std::ptrdiff_t>(firstLength), output);
+    std::copy(storage.begin(),
+              storage.begin() +
+                  static_cast<std::ptrdiff_t>(length - firstLength),
+              secondOutput);
+    return true;
+  }
+
+  /**
+   * @brief Gets the number of stored elements.
+   * @return The number of stored elements.
+   */
+  [[nodiscard]] size_t size() const { return count; }
+
+  /**
+   * @brief Removes all stored elements, keeping the capacity.
+   */
+  void clear() {
+    next = 0;
+    count = 0;
+  }
+
+private:
+  /**
+   * @brief The preallocated memory holding the elements.
+   */
+  std::vector<T> storage;
+
+  /**
+   * @brief The position in `storage` the next element is written to.
+   */
+  size_t next = 0;
+
+  /**
+   * @brief The number of stored elements.
+   */
+  size_t count = 0;
+};
@@ -0,0 +1,52 @@
+/**
+ * @file ScopedTimer.hpp
+ * @brief Provides a timer that adds the duration of a scope to a counter.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @brief Measures the time between its construction and destruction and adds
+ * it to a counter of nanoseconds.
+ *
+ * The time is also added if the scope is left by returning early or by an
+ * exception.
+ */
+class ScopedTimer {
+public:
+  /**
+   * @brief Starts a new timer.
+   * @param counter The counter the measured time is added to.
+   */
+  explicit ScopedTimer(size_t& counter)
+      : target(counter), start(std::chrono::steady_clock::now()) {}
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+  ScopedTimer(ScopedTimer&&) = delete;
+  ScopedTimer& operator=(ScopedTimer&&) = delete;
+
+  /**
+   * @brief Stops the timer and adds the measured time to the counter.
+   */
+  ~ScopedTimer() {
+    target += static_cast<size_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+  }
+
+private:
+  /**
+   * @brief The counter the measured time is added to.
+   */
+  size_t& target;
+
+  /**
+   * @brief The time at which the timer was started.
+   */
+  std::chrono::steady_clock::time_point start;
+};
@@ -47,6 +47,21 @@ public:
    */
   [[nodiscard]] size_t size() const { return spanSize; }
 
+  /**
+   * @brief Returns a pointer to the first element in the span.
+   * @return A pointer to the first element in the span.
+   */
+  T* begin() const { return pointer; }
+
+  /**
+   * @brief Returns a pointer past the last element in the span.
+   * @return A pointer past the last element in the span.
+   */
+  T* end() const {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return pointer + spanSize;
+  }
+
 private:
   /**
    * @brief The pointer on which the span is based.
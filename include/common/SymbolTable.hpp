@@ -0,0 +1,127 @@
+/**
+ * @file SymbolTable.hpp
+ * @brief Provides a table that interns the names of registers and variables.
+ *
+ * Names are interned once when the code is parsed. Afterwards, variables are
+ * referred to by a compact pair of a symbol ID and an index, so that comparing
+ * and resolving them does not require any string operations.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief The type used for the IDs of interned symbols.
+ */
+using SymbolId = uint32_t;
+
+/**
+ * @brief Refers to a variable in the code, i.e., to a full register or to a
+ * single index of a register.
+ */
+struct VariableReference {
+  /**
+   * @brief The index used for references to a full register.
+   */
+  static constexpr size_t FULL_REGISTER = -1ULL;
+
+  /**
+   * @brief The symbol ID of the register name.
+   */
+  SymbolId symbol;
+  /**
+   * @brief The index of the variable in the register, or `FULL_REGISTER`.
+   */
+  size_t index;
+
+  /**
+   * @brief Checks whether this reference refers to a full register.
+   * @return True if the reference refers to a full register, false otherwise.
+   */
+  [[nodiscard]] bool isFullRegister() const { return index == FULL_REGISTER; }
+
+  /**
+   * @brief Checks whether two references refer to the same variable.
+   * @param other The reference to compare to.
+   * @return True if both references are equal, false otherwise.
+   */
+  bool operator==(const VariableReference& other) const {
+    return symbol == other.symbol && index == other.index;
+  }
+
+  /**
+   * @brief Checks whether two references refer to different variables.
+   * @param other The reference to compare to.
+   * @return True if both references are different, false otherwise.
+   */
+  bool operator!=(const VariableReference& other) const {
+    return !(*this == other);
+  }
+};
+
+/**
+ * @brief Interns names and assigns a unique ID to each of them.
+ */
+class SymbolTable {
+public:
+  /**
+   * @brief Interns the given name and returns its ID.
+   *
+   * If the name was already interned before, the existing ID is returned.
+   * @param name The name to intern.
+   * @return The ID of the interned name.
+   */
+  SymbolId intern(const std::string& name);
+
+  /**
+   * @brief Gets the name of the symbol with the given ID.
+   * @param id The ID of the symbol.
+   * @return The name of the symbol.
+   */
+  [[nodiscard]] const std::string& getName(SymbolId id) const;
+
+  /**
+   * @brief Parses a variable such as `q` or `q[3]` and interns its register
+   * name.
+   *
+   * Variables whose index is not a non-negative integer are interned as a
+   * whole and treated like a full register.
+   * @param variable The variable to parse.
+   * @return The reference to the parsed variable.
+   */
+  VariableReference parseVariable(const std::string& variable);
+
+  /**
+   * @brief Gets the string representation of a variable reference.
+   * @param variable The variable reference.
+   * @return The string representation of the variable, such as `q[3]`.
+   */
+  [[nodiscard]] std::string toString(const VariableReference& variable) const;
+
+  /**
+   * @brief Gets the number of interned symbols.
+   * @return The number of interned symbols.
+   */
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * @brief Removes all symbols from the table.
+   */
+  void clear();
+
+private:
+  /**
+   * @brief The names of all interned symbols, indexed by their ID.
+   */
+  std::vector<std::string> names;
+
+  /**
+   * @brief Maps the name of each interned symbol to its ID.
+   */
+  std::unordered_map<std::string, SymbolId> ids;
+};
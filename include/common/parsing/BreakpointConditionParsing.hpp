@@ -0,0 +1,146 @@
+/**
+ * @file BreakpointConditionParsing.hpp
+ * @brief Contains the definitions and parsing functions for the conditions
+ * that can be attached to breakpoints.
+ *
+ * Conditions are parsed once when they are set, so that checking them while
+ * the simulation runs does not require any string processing.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief The operators that can be used to compare values in conditions.
+ */
+enum class ComparisonOperator : uint8_t {
+  /**
+   * @brief The value is equal to the given value.
+   */
+  Equal,
+  /**
+   * @brief The value is not equal to the given value.
+   */
+  NotEqual,
+  /**
+   * @brief The value is less than the given value.
+   */
+  Less,
+  /**
+   * @brief The value is less than or equal to the given value.
+   */
+  LessEqual,
+  /**
+   * @brief The value is greater than the given value.
+   */
+  Greater,
+  /**
+   * @brief The value is greater than or equal to the given value.
+   */
+  GreaterEqual,
+  /**
+   * @brief The value is a multiple of the given value.
+   *
+   * This operator is only supported in hit conditions.
+   */
+  Multiple
+};
+
+/**
+ * @brief The kinds of values that a breakpoint condition can compare.
+ */
+enum class ConditionTarget : uint8_t {
+  /**
+   * @brief The value of a single classical bit, such as `c[0]`.
+   */
+  ClassicalBit,
+  /**
+   * @brief The value of a full classical register, such as `c`, interpreted as
+   * an unsigned integer with the bit at index 0 as its least significant bit.
+   */
+  ClassicalRegister,
+  /**
+   * @brief The probability of measuring a single qubit in the state |1>, such
+   * as `P(q[0])`.
+   */
+  QubitProbability
+};
+
+/**
+ * @brief Represents a condition on the state of the simulation, such as
+ * `c[0] == 1` or `P(q[1]) > 0.5`.
+ */
+struct BreakpointCondition {
+  /**
+   * @brief The kind of value compared by the condition.
+   */
+  ConditionTarget target;
+  /**
+   * @brief The name of the compared variable, such as `c[0]`, `c`, or `q[1]`.
+   */
+  std::string variable;
+  /**
+   * @brief The operator used for the comparison.
+   */
+  ComparisonOperator comparison;
+  /**
+   * @brief The value the variable is compared to.
+   */
+  double value;
+};
+
+/**
+ * @brief Represents a condition on the number of times a breakpoint was hit,
+ * such as `>= 5` or `% 2`.
+ */
+struct HitCondition {
+  /**
+   * @brief The operator used for the comparison.
+   */
+  ComparisonOperator comparison;
+  /**
+   * @brief The number of hits the hit count is compared to.
+   */
+  size_t count;
+};
+
+/**
+ * @brief Parse a condition on the state of the simulation.
+ *
+ * Conditions have the form `<operand> <operator> <value>`, where the operand is
+ * a classical bit (`c[0]`), a classical register (`c`), or the probability of
+ * measuring a qubit in the state |1> (`P(q[0])`), and the operator is one of
+ * `==`, `!=`, `<`, `<=`, `>`, and `>=`.
+ * @param condition The condition to parse.
+ * @return The parsed condition.
+ * @throws ParsingError If the condition is malformed.
+ */
+BreakpointCondition parseBreakpointCondition(const std::string& condition);
+
+/**
+ * @brief Parse a condition on the number of times a breakpoint was hit.
+ *
+ * Hit conditions consist of an optional operator and a non-negative integer.
+ * The supported operators are `==`, `!=`, `<`, `<=`, `>`, `>=`, and `%`, where
+ * `%` checks whether the hit count is a multiple of the (positive) integer. If
+ * no operator is given, `==` is used.
+ * @param hitCondition The hit condition to parse.
+ * @return The parsed hit condition.
+ * @throws ParsingError If the hit condition is malformed.
+ */
+HitCondition parseHitCondition(const std::string& hitCondition);
+
+/**
+ * @brief Compare two values using the given operator.
+ *
+ * Equality comparisons tolerate small rounding errors, so that they can also be
+ * used for probabilities.
+ * @param comparison The operator to use.
+ * @param lhs The value on the left-hand side of the comparison.
+ * @param rhs The value on the right-hand side of the comparison.
+ * @return The result of the comparison.
+ */
+bool compareValues(ComparisonOperator comparison, double lhs, double rhs);
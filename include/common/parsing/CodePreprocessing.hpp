@@ -7,11 +7,13 @@
 #pragma once
 
 #include "AssertionParsing.hpp"
+#include "common/SymbolTable.hpp"
 
 #include <cstddef>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -19,7 +21,8 @@
  * @brief Represents a block of code.
  *
  * Code blocks are typically given in curly braces after a custom gate
- * definition or an assertion.
+ * definition or an assertion. The block does not own its code, but refers to
+ * the processed code it was parsed from.
  */
 struct Block {
   /**
@@ -32,13 +35,15 @@ struct Block {
   /**
    * @brief The code in the block.
    */
-  std::string code;
+  std::string_view code;
 };
 
 /**
  * @brief Represents a preprocessed instruction in the code.
  *
- * Also contains additional meta-information about the instruction.
+ * Also contains additional meta-information about the instruction. The code
+ * of the instruction and its block refer to the processed code it was parsed
+ * from, so that code must outlive the instruction.
  */
 struct Instruction {
   /**
@@ -53,7 +58,7 @@ struct Instruction {
   /**
    * @brief The string representation of this code.
    */
-  std::string code;
+  std::string_view code;
 
   /**
    * @brief The representation of this instruction as an assertion.
@@ -68,6 +73,12 @@ struct Instruction {
    */
   std::vector<std::string> targets;
 
+  /**
+   * @brief The target variables or registers of this instruction, as
+   * references into the symbol table used for preprocessing.
+   */
+  std::vector<VariableReference> targetReferences;
+
   /**
    * @brief The position of the instruction's string's first character in the
    * un-processed code.
@@ -99,7 +110,7 @@ struct Instruction {
    * @brief The name of the custom gate called by this instruction, if it is a
    * custom gate call.
    */
-  std::string calledFunction;
+  std::string_view calledFunction;
 
   /**
    * @brief Indicates whether the instruction is located inside a custom gate
@@ -116,18 +127,23 @@ struct Instruction {
   /**
    * @brief The substitutions to be made in the code when calling a custom gate.
    *
-   * Maps from the names of the parameters of the custom gate to
-   * the names of the variables used to call the custom gate.
+   * Maps from the symbols of the parameters of the custom gate to
+   * the variables used to call the custom gate.
    */
-  std::map<std::string, std::string> callSubstitution;
+  std::map<SymbolId, VariableReference> callSubstitution;
 
   /**
    * @brief The immediate data dependencies of this instruction.
    *
    * For each variable used by this instruction, this vector contains a
-   * reference to the last instruction that used it. It also contains the index
-   * of the variable in that dependency's argument list, so that it can be
-   * identified exactly.
+   * reference to the last instruction in the same scope that used it. It also
+   * contains the index of the variable in that dependency's argument list, so
+   * that it can be identified exactly.
+   *
+   * A usage of a full register `q` counts as a usage of each of its indices,
+   * so `q[i]` only depends on the later of the last usages of `q[i]` and `q`,
+   * while `q` depends on its last usage and on the last usage of every index
+   * since then.
    */
   std::vector<std::pair<size_t, size_t>> dataDependencies;
 
@@ -172,11 +188,11 @@ struct Instruction {
    * definition.
    * @param inputBlock The block of code following this instruction.
    */
-  Instruction(size_t inputLineNumber, std::string inputCode,
+  Instruction(size_t inputLineNumber, std::string_view inputCode,
               std::unique_ptr<Assertion>& inputAssertion,
               std::vector<std::string> inputTargets, size_t startPos,
               size_t endPos, size_t successor, bool isFuncCall,
-              std::string function, bool inFuncDef, bool isFuncDef,
+              std::string_view function, bool inFuncDef, bool isFuncDef,
               Block inputBlock);
 };
 
@@ -197,7 +213,9 @@ struct FunctionDefinition {
 /**
  * @brief Process a given source code and return a vector of instructions.
  *
- * The processed code is stored in the `processedCode` parameter.
+ * The processed code is stored in the `processedCode` parameter. Variable names
+ * are interned in a temporary symbol table, so the symbol IDs of the returned
+ * instructions can only be compared with each other.
  *
  * @param code The source code to process.
  * @param processedCode A reference to store the processed code in.
@@ -206,6 +224,21 @@ struct FunctionDefinition {
 std::vector<Instruction> preprocessCode(const std::string& code,
                                         std::string& processedCode);
 
+/**
+ * @brief Process a given source code and return a vector of instructions.
+ *
+ * The processed code is stored in the `processedCode` parameter. All variable
+ * names are interned in the given symbol table.
+ *
+ * @param code The source code to process.
+ * @param processedCode A reference to store the processed code in.
+ * @param symbols The symbol table to intern variable names in.
+ * @return A vector of all processed instructions.
+ */
+std::vector<Instruction> preprocessCode(const std::string& code,
+                                        std::string& processedCode,
+                                        SymbolTable& symbols);
+
 /**
  * @brief Process a given code block and return a vector of instructions.
  * @param code The source code to process.
@@ -219,6 +252,7 @@ std::vector<Instruction> preprocessCode(const std::string& code,
  * @param shadowedRegisters The registers shadowed by the current or previous
  * scopes (e.g., by having function parameters with the same name).
  * @param processedCode A reference to store the processed code in.
+ * @param symbols The symbol table to intern variable names in.
  * @return A vector of all processed instructions.
  */
 std::vector<Instruction>
@@ -227,4 +261,4 @@ preprocessCode(const std::string& code, size_t startIndex,
                const std::vector<std::string>& functionNames,
                std::map<std::string, size_t>& definedRegisters,
                const std::vector<std::string>& shadowedRegisters,
-               std::string& processedCode);
+               std::string& processedCode, SymbolTable& symbols);
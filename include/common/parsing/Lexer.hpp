@@ -0,0 +1,102 @@
+/**
+ * @file Lexer.hpp
+ * @brief Contains the definition of the lexer that splits source code into
+ * tokens.
+ *
+ * The code preprocessing derives instruction boundaries, blocks, comments, and
+ * instruction targets from the token stream produced by the lexer, so the
+ * source code only has to be scanned once.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The types of tokens produced by the lexer.
+ */
+enum class TokenType : uint8_t {
+  /**
+   * @brief A sequence of letters, digits, underscores, and dots, such as a
+   * keyword, an identifier, or a number.
+   */
+  Word,
+  /**
+   * @brief A string literal in double quotes.
+   */
+  String,
+  /**
+   * @brief A comment starting with `//` and reaching to the end of the line.
+   */
+  Comment,
+  /**
+   * @brief A semicolon, ending an instruction.
+   */
+  Semicolon,
+  /**
+   * @brief A comma, separating arguments.
+   */
+  Comma,
+  /**
+   * @brief An opening curly brace, starting a block.
+   */
+  LeftBrace,
+  /**
+   * @brief A closing curly brace, ending a block.
+   */
+  RightBrace,
+  /**
+   * @brief An opening parenthesis.
+   */
+  LeftParen,
+  /**
+   * @brief A closing parenthesis.
+   */
+  RightParen,
+  /**
+   * @brief An opening square bracket.
+   */
+  LeftBracket,
+  /**
+   * @brief A closing square bracket.
+   */
+  RightBracket,
+  /**
+   * @brief Any other single character, such as an operator.
+   */
+  Symbol
+};
+
+/**
+ * @brief Represents a single token in the source code.
+ *
+ * Tokens do not store their text, but only their position in the source code.
+ */
+struct Token {
+  /**
+   * @brief The type of the token.
+   */
+  TokenType type;
+  /**
+   * @brief The position of the token's first character in the source code.
+   */
+  size_t start;
+  /**
+   * @brief The position after the token's last character in the source code.
+   */
+  size_t end;
+};
+
+/**
+ * @brief Split the given source code into tokens in a single pass.
+ *
+ * Whitespace is not represented by tokens. Two tokens are separated by
+ * whitespace or a comment if the end of the first token is not equal to the
+ * start of the second token.
+ * @param code The source code to tokenize.
+ * @return The tokens of the source code in order of their appearance.
+ */
+std::vector<Token> tokenize(const std::string& code);
@@ -46,6 +46,12 @@ private:
   void printState(SimulationState* state, size_t inspecting,
                   bool codeOnly = false);
 
+  /**
+   * @brief Print the counters and timers of the simulation in the command
+   * line.
+   */
+  void printMetrics(SimulationState* state);
+
   /**
    * @brief Initialize the code for running it at a later time.
    */
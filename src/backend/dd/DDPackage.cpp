@@ -0,0 +1,97 @@
+/**
+ * @file DDPackage.cpp
+ * @brief Implementation of the pool of reusable DD packages.
+ */
+
+#include "backend/dd/DDPackage.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief The pool of DD packages released by destroyed simulation states.
+ */
+struct DDPackagePool {
+  /**
+   * @brief Guards all members, as simulation states may be created and
+   * destroyed concurrently.
+   */
+  std::mutex mutex;
+  /**
+   * @brief The packages available for reuse.
+   */
+  std::vector<std::unique_ptr<DDPackage>> packages;
+  /**
+   * @brief The maximum number of packages kept in the pool.
+   */
+  std::size_t capacity = 0;
+};
+
+/**
+ * @brief Get the process-wide pool of DD packages.
+ * @return The pool.
+ */
+DDPackagePool& getPool() {
+  static DDPackagePool pool;
+  return pool;
+}
+
+} // namespace
+
+std::unique_ptr<DDPackage> acquireDDPackage(std::size_t numQubits) {
+  auto& pool = getPool();
+  {
+    const std::lock_guard<std::mutex> lock(pool.mutex);
+    if (!pool.packages.empty()) {
+      auto package = std::move(pool.packages.back());
+      pool.packages.pop_back();
+      return package;
+    }
+  }
+  return std::make_unique<DDPackage>(numQubits);
+}
+
+void releaseDDPackage(std::unique_ptr<DDPackage> package) {
+  if (package == nullptr) {
+    return;
+  }
+  auto& pool = getPool();
+  {
+    const std::lock_guard<std::mutex> lock(pool.mutex);
+    if (pool.packages.size() >= pool.capacity) {
+      return;
+    }
+  }
+  // Freeing all unused nodes returns them to the memory manager of the
+  // package, where they are available to the next simulation state.
+  package->garbageCollect(true);
+  const std::lock_guard<std::mutex> lock(pool.mutex);
+  if (pool.packages.size() < pool.capacity) {
+    pool.packages.emplace_back(std::move(package));
+  }
+}
+
+void setDDPackagePoolCapacity(std::size_t capacity) {
+  auto& pool = getPool();
+  // Removed packages are destroyed after the lock is released.
+  std::vector<std::unique_ptr<DDPackage>> removed;
+  {
+    const std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.capacity = capacity;
+    while (pool.packages.size() > capacity) {
+      removed.emplace_back(std::move(pool.packages.back()));
+      pool.packages.pop_back();
+    }
+  }
+}
+
+std::size_t getDDPackagePoolSize() {
+  auto& pool = getPool();
+  const std::lock_guard<std::mutex> lock(pool.mutex);
+  return pool.packages.size();
+}
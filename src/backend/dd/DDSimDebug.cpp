@@ -6,39 +6,62 @@
 #include "backend/dd/DDSimDebug.hpp"
 
 #include "Definitions.hpp"
+#include "backend/dd/DDPackage.hpp"
 #include "backend/dd/DDSimDiagnostics.hpp"
 #include "backend/debug.h"
 #include "backend/diagnostics.h"
 #include "circuit_optimizer/CircuitOptimizer.hpp"
 #include "common.h"
+#include "common/ScopedTimer.hpp"
 #include "common/Span.hpp"
 #include "common/parsing/AssertionParsing.hpp"
+#include "common/parsing/BreakpointConditionParsing.hpp"
 #include "common/parsing/CodePreprocessing.hpp"
+#include "common/parsing/ParsingError.hpp"
 #include "common/parsing/Utils.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/Operations.hpp"
 #include "dd/Package.hpp"
 #include "ir/operations/ClassicControlledOperation.hpp"
+#include "ir/operations/NonUnitaryOperation.hpp"
 #include "ir/operations/OpType.hpp"
+#include "ir/operations/StandardOperation.hpp"
 
 #include <Eigen/Dense>
 #include <algorithm>
 #include <cmath>
+#include <complex>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <exception>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <memory>
-#include <numeric>
+#include <new>
 #include <random>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+/**
+ * @brief The maximum number of assertion outcomes kept in the assertion cache
+ * of a `DDSimulationState`.
+ */
+constexpr size_t ASSERTION_CACHE_CAPACITY = 1024;
+
+/**
+ * @brief The largest number of qubits for which equality assertions are
+ * checked on the dense state vector instead of the decision diagram.
+ */
+constexpr size_t DENSE_EQUALITY_MAX_QUBITS = 6;
+
 /**
  * @brief Cast a `SimulationState` pointer to a `DDSimulationState` pointer.
  *
@@ -73,6 +96,7 @@ Result createDDSimulationState(DDSimulationState* self) {
   self->interface.init = ddsimInit;
 
   self->interface.loadCode = ddsimLoadCode;
+  self->interface.reloadCode = ddsimReloadCode;
   self->interface.stepForward = ddsimStepForward;
   self->interface.stepBackward = ddsimStepBackward;
   self->interface.stepOverForward = ddsimStepOverForward;
@@ -93,6 +117,9 @@ Result createDDSimulationState(DDSimulationState* self) {
   self->interface.getCurrentInstruction = ddsimGetCurrentInstruction;
   self->interface.getInstructionCount = ddsimGetInstructionCount;
   self->interface.getInstructionPosition = ddsimGetInstructionPosition;
+  self->interface.getInstructionPositions = ddsimGetInstructionPositions;
+  self->interface.getCodeCoordinates = ddsimGetCodeCoordinates;
+  self->interface.getCodePosition = ddsimGetCodePosition;
   self->interface.getNumQubits = ddsimGetNumQubits;
   self->interface.getAmplitudeIndex = ddsimGetAmplitudeIndex;
   self->interface.getAmplitudeBitstring = ddsimGetAmplitudeBitstring;
@@ -103,9 +130,18 @@ Result createDDSimulationState(DDSimulationState* self) {
   self->interface.getStateVectorSub = ddsimGetStateVectorSub;
   self->interface.getDiagnostics = ddsimGetDiagnostics;
   self->interface.setBreakpoint = ddsimSetBreakpoint;
+  self->interface.setBreakpoints = ddsimSetBreakpoints;
+  self->interface.setBreakpointCondition = ddsimSetBreakpointCondition;
   self->interface.clearBreakpoints = ddsimClearBreakpoints;
   self->interface.getStackDepth = ddsimGetStackDepth;
   self->interface.getStackTrace = ddsimGetStackTrace;
+  self->interface.setTraceCapacity = ddsimSetTraceCapacity;
+  self->interface.getTraceLength = ddsimGetTraceLength;
+  self->interface.getTrace = ddsimGetTrace;
+  self->interface.getMetrics = ddsimGetMetrics;
+  self->interface.resetMetrics = ddsimResetMetrics;
+  self->interface.getMemoryStatistics = ddsimGetMemoryStatistics;
+  self->interface.setMemoryBudget = ddsimSetMemoryBudget;
 
   // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
   return self->interface.init(reinterpret_cast<SimulationState*>(self));
@@ -129,21 +165,321 @@ void resetSimulationState(DDSimulationState* ddsim) {
   ddsim->paused = false;
 }
 
+/**
+ * @brief Check whether a breakpoint is set at the given instruction.
+ * @param ddsim The simulation state.
+ * @param instruction The index of the instruction.
+ * @return True if a breakpoint is set at the instruction, false otherwise.
+ */
+bool isBreakpoint(const DDSimulationState* ddsim, size_t instruction) {
+  return instruction < ddsim->breakpoints.size() &&
+         ddsim->breakpoints[instruction];
+}
+
+/**
+ * @brief Append an event to the execution trace.
+ *
+ * The event is discarded if tracing is disabled.
+ * @param ddsim The simulation state.
+ * @param type The type of the event.
+ * @param instruction The instruction the event refers to.
+ * @param value Additional information, depending on the type of the event.
+ */
+void recordTraceEvent(DDSimulationState* ddsim, TraceEventType type,
+                      size_t instruction, size_t value = 0) {
+  ddsim->trace.push({type, instruction, value});
+}
+
+/**
+ * @brief Append the number of nodes of the current state to the execution
+ * trace, if requested.
+ *
+ * Counting the nodes requires traversing the decision diagram, so it is only
+ * done if tracing is enabled and node counts were requested.
+ * @param ddsim The simulation state.
+ * @param instruction The instruction that changed the state.
+ */
+void recordTraceNodeCount(DDSimulationState* ddsim, size_t instruction) {
+  if (ddsim->traceNodeCounts && ddsim->trace.capacity() > 0) {
+    recordTraceEvent(ddsim, TraceNodeCount, instruction,
+                     ddsim->simulationState.size());
+  }
+}
+
+/**
+ * @brief Run the garbage collection of the DD package, recording it in the
+ * metrics if it freed any nodes.
+ * @param ddsim The simulation state.
+ */
+void collectGarbage(DDSimulationState* ddsim) {
+  size_t time = 0;
+  bool collected = false;
+  {
+    const ScopedTimer timer(time);
+    collected = ddsim->dd->garbageCollect();
+  }
+  if (collected) {
+    ddsim->metrics.garbageCollections++;
+    ddsim->metrics.garbageCollectionTime += time;
+  }
+}
+
+/**
+ * @brief Get the number of bytes used by all nodes stored in the DD package.
+ * @param ddsim The simulation state.
+ * @return The number of bytes.
+ */
+size_t getNodeMemory(const DDSimulationState* ddsim) {
+  return (ddsim->dd->vUniqueTable.getNumEntries() * sizeof(dd::vNode)) +
+         (ddsim->dd->mUniqueTable.getNumEntries() * sizeof(dd::mNode));
+}
+
+/**
+ * @brief Get the number of bytes of a compute table of the DD package.
+ * @param table The compute table.
+ * @return The number of bytes.
+ */
+template <class Table> size_t getTableMemory(const Table& table) {
+  const auto& stats = table.getStats();
+  return stats.numBuckets * stats.entrySize;
+}
+
+/**
+ * @brief Get the number of bytes of a memory manager of the DD package that
+ * are used by live entries.
+ * @param manager The memory manager.
+ * @return The number of bytes.
+ */
+template <class Manager> size_t getManagerMemory(const Manager& manager) {
+  const auto& stats = manager.getStats();
+  return stats.numUsed * stats.entrySize;
+}
+
+/**
+ * @brief Get the number of bytes used by the DD package.
+ *
+ * This includes the nodes and real numbers in use, the buckets of the unique
+ * tables, and the compute tables. Memory the package keeps allocated for
+ * entries that were freed is not included, as it can be reused.
+ * @param ddsim The simulation state.
+ * @return The number of bytes.
+ */
+size_t getPackageMemory(const DDSimulationState* ddsim) {
+  const auto& dd = *ddsim->dd;
+  const auto uniqueTableBuckets =
+      dd.qubits() * ((DebuggerDDPackageConfig::UT_VEC_NBUCKET +
+                      DebuggerDDPackageConfig::UT_MAT_NBUCKET) *
+                     sizeof(void*));
+  return getManagerMemory(dd.vMemoryManager) +
+         getManagerMemory(dd.mMemoryManager) +
+         getManagerMemory(dd.cMemoryManager) + uniqueTableBuckets +
+         getTableMemory(dd.vectorAdd) + getTableMemory(dd.matrixAdd) +
+         getTableMemory(dd.matrixVectorMultiplication) +
+         getTableMemory(dd.matrixMatrixMultiplication) +
+         getTableMemory(dd.vectorInnerProduct);
+}
+
+/**
+ * @brief Record the number of vector nodes that are currently referenced in
+ * `peakActiveVectorNodes` if it is the largest number so far.
+ * @param ddsim The simulation state.
+ */
+void updatePeakActiveVectorNodes(DDSimulationState* ddsim) {
+  ddsim->peakActiveVectorNodes =
+      std::max(ddsim->peakActiveVectorNodes,
+               ddsim->dd->vUniqueTable.getNumActiveEntries());
+}
+
+/**
+ * @brief Check that the DD package fits into the memory budget before an
+ * instruction changes the state.
+ *
+ * If it exceeds the budget, the compute tables are flushed, the assertion
+ * cache and the reference states of circuit-equality assertions are released,
+ * and a garbage collection is forced, so that all nodes not used by the
+ * current state are freed. The result is stored in `budgetExceeded`.
+ * @param ddsim The simulation state.
+ * @return True if the DD package fits into the budget, false otherwise.
+ */
+bool checkMemoryBudget(DDSimulationState* ddsim) {
+  updatePeakActiveVectorNodes(ddsim);
+  ddsim->budgetExceeded = false;
+  if (ddsim->memoryBudget == 0 ||
+      getPackageMemory(ddsim) <= ddsim->memoryBudget) {
+    return true;
+  }
+  ddsim->budgetCollections++;
+  ddsim->dd->clearComputeTables();
+  clearAssertionCache(ddsim);
+  ddsim->dd->garbageCollect(true);
+  ddsim->budgetExceeded = getPackageMemory(ddsim) > ddsim->memoryBudget;
+  return !ddsim->budgetExceeded;
+}
+
+/**
+ * @brief Resolve the variables used by the condition of a breakpoint.
+ *
+ * Variables that do not exist in the current code are left unresolved, so the
+ * condition never holds.
+ * @param ddsim The simulation state.
+ * @param conditions The conditions of the breakpoint.
+ * @return True if all variables could be resolved, false otherwise.
+ */
+bool resolveBreakpointCondition(DDSimulationState* ddsim,
+                                BreakpointConditions& conditions) {
+  conditions.classicalBits.clear();
+  conditions.qubit = -1ULL;
+  if (!conditions.hasCondition) {
+    return true;
+  }
+  const auto& variable = conditions.condition.variable;
+  switch (conditions.condition.target) {
+  case ConditionTarget::ClassicalBit:
+    if (ddsim->variables.find(variable) == ddsim->variables.end()) {
+      return false;
+    }
+    conditions.classicalBits.push_back(variable);
+    return true;
+  case ConditionTarget::ClassicalRegister:
+    for (const auto& reg : ddsim->classicalRegisters) {
+      if (reg.name == variable) {
+        for (size_t i = 0; i < reg.size; i++) {
+          conditions.classicalBits.push_back(variable + "[" +
+                                             std::to_string(i) + "]");
+        }
+        return true;
+      }
+    }
+    return false;
+  case ConditionTarget::QubitProbability:
+    try {
+      conditions.qubit = globalVariableToQubit(
+          ddsim, ddsim->symbols.parseVariable(variable));
+      return true;
+    } catch (const std::exception&) {
+      return false;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Check whether the condition on the state of the simulation holds for
+ * the breakpoint at the given instruction.
+ * @param ddsim The simulation state.
+ * @param instruction The index of the instruction.
+ * @return True if the breakpoint has no condition or its condition holds, false
+ * otherwise.
+ */
+bool isBreakpointConditionMet(DDSimulationState* ddsim, size_t instruction) {
+  const auto found = ddsim->breakpointConditions.find(instruction);
+  if (found == ddsim->breakpointConditions.end() ||
+      !found->second.hasCondition) {
+    return true;
+  }
+  const auto& conditions = found->second;
+  double value = 0;
+  if (conditions.condition.target == ConditionTarget::QubitProbability) {
+    if (conditions.qubit == -1ULL) {
+      return false;
+    }
+    value = ddsim->dd
+                ->determineMeasurementProbabilities(
+                    ddsim->simulationState,
+                    static_cast<dd::Qubit>(conditions.qubit), true)
+                .second;
+  } else {
+    if (conditions.classicalBits.empty()) {
+      return false;
+    }
+    size_t registerValue = 0;
+    for (size_t i = 0; i < conditions.classicalBits.size(); i++) {
+      const auto& bit = ddsim->variables[conditions.classicalBits[i]];
+      registerValue |= (bit.value.boolValue ? 1ULL : 0ULL) << i;
+    }
+    value = static_cast<double>(registerValue);
+  }
+  return compareValues(conditions.condition.comparison, value,
+                       conditions.condition.value);
+}
+
+/**
+ * @brief Update the hit count of the breakpoint at the given instruction and
+ * check its hit condition.
+ *
+ * Reaching the breakpoint when stepping forward counts as a hit if the
+ * condition of the breakpoint holds, and leaving it when stepping backward
+ * undoes that hit again. The condition must be checked on the state after the
+ * step that reached the breakpoint.
+ * @param ddsim The simulation state.
+ * @param instruction The index of the instruction.
+ * @param delta The change of the hit count: 1 when the breakpoint is reached,
+ * -1 when it is left backward, and 0 when it is reached backward.
+ * @return True if the hit condition of the breakpoint holds, false otherwise
+ * or if the condition of the breakpoint does not hold.
+ */
+bool updateBreakpointHits(DDSimulationState* ddsim, size_t instruction,
+                          int delta) {
+  const auto found = ddsim->breakpointConditions.find(instruction);
+  if (found == ddsim->breakpointConditions.end()) {
+    return true;
+  }
+  // Reaching the breakpoint only counts as a hit if its condition holds. As
+  // the instruction has not been executed yet, the state is the same when the
+  // hit is undone again.
+  if (delta != 0 && !isBreakpointConditionMet(ddsim, instruction)) {
+    return false;
+  }
+  auto& conditions = found->second;
+  if (delta > 0) {
+    conditions.hits++;
+  } else if (delta < 0 && conditions.hits > 0) {
+    conditions.hits--;
+  }
+  return !conditions.hasHitCondition ||
+         compareValues(conditions.hitCondition.comparison,
+                       static_cast<double>(conditions.hits),
+                       static_cast<double>(conditions.hitCondition.count));
+}
+
+/**
+ * @brief Reset the hit counts of all breakpoints and resolve the variables of
+ * their conditions again.
+ *
+ * This is required whenever the simulation is reset or new code is loaded.
+ * @param ddsim The simulation state.
+ */
+void resetBreakpointConditions(DDSimulationState* ddsim) {
+  for (auto& [instruction, conditions] : ddsim->breakpointConditions) {
+    conditions.hits = 0;
+    resolveBreakpointCondition(ddsim, conditions);
+  }
+}
+
 Result ddsimInit(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
 
+  clearAssertionCache(ddsim);
+  ddsim->metrics = {};
+  ddsim->memoryBudget = 0;
+  ddsim->budgetCollections = 0;
+  ddsim->budgetExceeded = false;
+  ddsim->peakActiveVectorNodes = 0;
   ddsim->simulationState.p = nullptr;
   ddsim->qc = std::make_unique<qc::QuantumComputation>();
-  ddsim->dd = std::make_unique<dd::Package<>>(1);
+  ddsim->dd = acquireDDPackage(1);
   ddsim->iterator = ddsim->qc->begin();
   ddsim->currentInstruction = 0;
   ddsim->previousInstructionStack.clear();
-  ddsim->callReturnStack.clear();
+  clearCallFrames(ddsim);
   ddsim->callSubstitutions.clear();
   ddsim->restoreCallReturnStack.clear();
   ddsim->breakpoints.clear();
+  ddsim->breakpointConditions.clear();
   ddsim->lastFailedAssertion = -1ULL;
   ddsim->lastMetBreakpoint = -1ULL;
+  ddsim->trace.setCapacity(0);
+  ddsim->traceNodeCounts = false;
 
   destroyDDDiagnostics(&ddsim->diagnostics);
   createDDDiagnostics(&ddsim->diagnostics, ddsim);
@@ -155,21 +491,55 @@ Result ddsimInit(SimulationState* self) {
   return OK;
 }
 
-Result ddsimLoadCode(SimulationState* self, const char* code) {
-  auto* ddsim = toDDSimulationState(self);
+/**
+ * @brief Load the given code into the simulation state.
+ *
+ * The diagnostics data recorded at runtime is only kept for the given number
+ * of leading instructions, which must be unchanged in the new code.
+ * @param ddsim The simulation state.
+ * @param code The code to load.
+ * @param keptInstructions The number of instructions to keep the diagnostics
+ * data of.
+ * @return The result of the operation.
+ */
+Result loadCode(DDSimulationState* ddsim, const char* code,
+                size_t keptInstructions) {
   ddsim->currentInstruction = 0;
   ddsim->previousInstructionStack.clear();
-  ddsim->callReturnStack.clear();
+  clearCallFrames(ddsim);
   ddsim->callSubstitutions.clear();
   ddsim->restoreCallReturnStack.clear();
   ddsim->code = code;
+  ddsim->lineStarts.clear();
+  ddsim->lineStarts.push_back(0);
+  for (size_t i = 0; i < ddsim->code.size(); i++) {
+    if (ddsim->code[i] == '\n') {
+      ddsim->lineStarts.push_back(i + 1);
+    }
+  }
   ddsim->variables.clear();
+  clearAssertionCache(ddsim);
   ddsim->variableNames.clear();
 
+  ddsim->metrics.codeLoads++;
   try {
-    std::stringstream ss{preprocessAssertionCode(code, ddsim)};
-    ddsim->qc->import(ss, qc::Format::OpenQASM3);
-    qc::CircuitOptimizer::flattenOperations(*ddsim->qc, true);
+    std::vector<Instruction> instructions;
+    std::string validCode;
+    {
+      const ScopedTimer timer(ddsim->metrics.preprocessingTime);
+      validCode = preprocessAssertionCode(code, ddsim, instructions);
+    }
+    const ScopedTimer timer(ddsim->metrics.circuitConstructionTime);
+    // Most programs can be built from the instructions directly, so they do
+    // not have to be parsed a second time by the importer.
+    auto directQc = std::make_unique<qc::QuantumComputation>();
+    if (buildQuantumComputation(ddsim, instructions, *directQc)) {
+      ddsim->qc = std::move(directQc);
+    } else {
+      std::stringstream ss{validCode};
+      ddsim->qc->import(ss, qc::Format::OpenQASM3);
+      qc::CircuitOptimizer::flattenOperations(*ddsim->qc, true);
+    }
   } catch (const std::exception& e) {
     std::cerr << e.what() << "\n";
     return ERROR;
@@ -179,14 +549,149 @@ Result ddsimLoadCode(SimulationState* self, const char* code) {
   ddsim->dd->resize(ddsim->qc->getNqubits());
   ddsim->lastFailedAssertion = -1ULL;
   ddsim->lastMetBreakpoint = -1ULL;
+  dddiagnosticsDiscardRuntimeData(&ddsim->diagnostics, keptInstructions);
+  ddsim->trace.clear();
 
   resetSimulationState(ddsim);
+  resetBreakpointConditions(ddsim);
 
   ddsim->ready = true;
 
   return OK;
 }
 
+Result ddsimLoadCode(SimulationState* self, const char* code) {
+  return loadCode(toDDSimulationState(self), code, 0);
+}
+
+Result ddsimReloadCode(SimulationState* self, const char* code) {
+  auto* ddsim = toDDSimulationState(self);
+  if (!ddsim->ready) {
+    return self->loadCode(self, code);
+  }
+  const std::string newCode = code;
+  const auto firstChange = static_cast<size_t>(
+      std::mismatch(ddsim->code.begin(), ddsim->code.end(), newCode.begin(),
+                    newCode.end())
+          .first -
+      ddsim->code.begin());
+  if (firstChange == ddsim->code.size() && firstChange == newCode.size()) {
+    return OK;
+  }
+
+  // Instructions that end before the first change keep their index and their
+  // meaning in the new code.
+  const auto unchanged = [ddsim, firstChange](size_t instruction) {
+    return instruction < ddsim->instructionEnds.size() &&
+           ddsim->instructionEnds[instruction] < firstChange;
+  };
+
+  size_t unchangedInstructions = 0;
+  while (unchanged(unchangedInstructions)) {
+    unchangedInstructions++;
+  }
+
+  // The simulation is stepped back until only unchanged instructions were
+  // executed, so that the state they reached can be kept. If a measurement or
+  // reset cleared the history, the state cannot be verified.
+  const auto simulatedInstructions = static_cast<size_t>(
+      std::count_if(ddsim->previousInstructionStack.begin(),
+                    ddsim->previousInstructionStack.end(),
+                    [ddsim](size_t instruction) {
+                      return ddsim->instructionTypes[instruction] == SIMULATE;
+                    }));
+  bool keepState =
+      simulatedInstructions == static_cast<size_t>(std::distance(
+                                   ddsim->qc->begin(), ddsim->iterator));
+  const auto firstChanged = static_cast<size_t>(
+      std::find_if_not(ddsim->previousInstructionStack.begin(),
+                       ddsim->previousInstructionStack.end(), unchanged) -
+      ddsim->previousInstructionStack.begin());
+  while (keepState && ddsim->previousInstructionStack.size() > firstChanged) {
+    keepState = self->stepBackward(self) == OK;
+  }
+  const auto executedOperations =
+      static_cast<size_t>(std::distance(ddsim->qc->begin(), ddsim->iterator));
+
+  const auto numQubits = ddsim->qc->getNqubits();
+  const auto currentInstruction = ddsim->currentInstruction;
+  const auto previousInstructionStack = ddsim->previousInstructionStack;
+  const auto callReturnStack = ddsim->callReturnStack;
+  const auto restoreCallReturnStack = ddsim->restoreCallReturnStack;
+  const auto state = ddsim->simulationState;
+  std::vector<std::pair<size_t, size_t>> breakpointHits;
+  for (const auto& [instruction, conditions] : ddsim->breakpointConditions) {
+    breakpointHits.emplace_back(instruction, conditions.hits);
+  }
+  // The trace is moved out, so that loading the code does not clear it.
+  RingBuffer<TraceEvent> trace;
+  std::swap(trace, ddsim->trace);
+
+  // Additional references keep the reused states alive while the previous
+  // code is unloaded.
+  ddsim->dd->incRef(state);
+  std::map<size_t, qc::VectorDD> references;
+  for (const auto& [instruction, reference] :
+       ddsim->circuitEqualityReferences) {
+    if (unchanged(instruction)) {
+      ddsim->dd->incRef(reference);
+      references.insert({instruction, reference});
+    }
+  }
+  std::vector<std::pair<AssertionCacheKey, bool>> cachedOutcomes;
+  for (const auto& key : ddsim->assertionCacheOrder) {
+    if (unchanged(key.instruction)) {
+      ddsim->dd->incRef(key.state);
+      cachedOutcomes.emplace_back(key, ddsim->assertionCache.at(key));
+    }
+  }
+
+  const auto result = loadCode(ddsim, code, unchangedInstructions);
+
+  keepState = keepState && result == OK &&
+              ddsim->qc->getNqubits() == numQubits &&
+              currentInstruction < ddsim->instructionTypes.size() &&
+              executedOperations <= ddsim->qc->getNops();
+  if (keepState) {
+    ddsim->currentInstruction = currentInstruction;
+    ddsim->previousInstructionStack = previousInstructionStack;
+    ddsim->restoreCallReturnStack = restoreCallReturnStack;
+    for (const auto call : callReturnStack) {
+      pushCallFrame(ddsim, call);
+    }
+    ddsim->iterator =
+        ddsim->qc->begin() + static_cast<std::ptrdiff_t>(executedOperations);
+    ddsim->dd->decRef(ddsim->simulationState);
+    ddsim->simulationState = state;
+    for (const auto& [instruction, hits] : breakpointHits) {
+      ddsim->breakpointConditions[instruction].hits = hits;
+    }
+  } else {
+    ddsim->dd->decRef(state);
+    trace.clear();
+  }
+  std::swap(trace, ddsim->trace);
+
+  // The references span all qubits of the program, so they can only be kept
+  // if its size did not change.
+  for (const auto& [instruction, reference] : references) {
+    if (result == OK && ddsim->qc->getNqubits() == numQubits) {
+      ddsim->circuitEqualityReferences.insert({instruction, reference});
+    } else {
+      ddsim->dd->decRef(reference);
+    }
+  }
+  for (const auto& [key, outcome] : cachedOutcomes) {
+    if (result == OK) {
+      ddsim->assertionCache.insert({key, outcome});
+      ddsim->assertionCacheOrder.push_back(key);
+    } else {
+      ddsim->dd->decRef(key.state);
+    }
+  }
+  return result;
+}
+
 Result ddsimStepOverForward(SimulationState* self) {
   if (!self->canStepForward(self)) {
     return ERROR;
@@ -291,57 +796,25 @@ Result ddsimStepOutBackward(SimulationState* self) {
   return res;
 }
 
-Result ddsimStepForward(SimulationState* self) {
-  auto* ddsim = toDDSimulationState(self);
-  if (!self->canStepForward(self)) {
-    return ERROR;
-  }
-  ddsim->lastMetBreakpoint = -1ULL;
-  const auto currentInstruction = ddsim->currentInstruction;
-  dddiagnosticsOnStepForward(&ddsim->diagnostics, currentInstruction);
-  ddsim->currentInstruction = ddsim->successorInstructions[currentInstruction];
-
-  if (ddsim->currentInstruction == 0) {
-    ddsim->currentInstruction = ddsim->callReturnStack.back() + 1;
-    ddsim->restoreCallReturnStack.emplace_back(ddsim->currentInstruction,
-                                               ddsim->callReturnStack.back());
-    ddsim->callReturnStack.pop_back();
-  }
-
-  if (ddsim->breakpoints.find(ddsim->currentInstruction) !=
-      ddsim->breakpoints.end()) {
+/**
+ * @brief Count a hit of the breakpoint at the current instruction after
+ * stepping forward onto it.
+ * @param ddsim The simulation state.
+ */
+void countBreakpointHit(DDSimulationState* ddsim) {
+  if (isBreakpoint(ddsim, ddsim->currentInstruction) &&
+      updateBreakpointHits(ddsim, ddsim->currentInstruction, 1)) {
     ddsim->lastMetBreakpoint = ddsim->currentInstruction;
   }
+}
 
-  if (ddsim->instructionTypes[currentInstruction] == CALL) {
-    ddsim->callReturnStack.push_back(currentInstruction);
-  }
-  ddsim->previousInstructionStack.emplace_back(currentInstruction);
-
-  // The exact action we take depends on the type of the next instruction:
-  // - ASSERTION: check the assertion and step back if it fails.
-  // - Non-SIMULATE: just step to the next instruction.
-  // - SIMULATE: run the corresponding operation on the DD backend.
-  if (ddsim->instructionTypes[currentInstruction] == ASSERTION) {
-    auto& assertion = ddsim->assertionInstructions[currentInstruction];
-    try {
-      const auto failed = !checkAssertion(ddsim, assertion);
-      if (failed && ddsim->lastFailedAssertion != currentInstruction) {
-        ddsim->lastFailedAssertion = currentInstruction;
-        self->stepBackward(self);
-      }
-      return OK;
-    } catch (const std::exception& e) {
-      std::cerr << e.what() << "\n";
-      return ERROR;
-    }
-  }
-
-  ddsim->lastFailedAssertion = -1ULL;
-  if (ddsim->instructionTypes[currentInstruction] != SIMULATE) {
-    return OK;
-  }
-
+/**
+ * @brief Apply the operation of the given `SIMULATE` instruction to the state.
+ * @param ddsim The simulation state.
+ * @param currentInstruction The index of the instruction.
+ * @return The result of the operation.
+ */
+Result applyOperation(DDSimulationState* ddsim, size_t currentInstruction) {
   qc::MatrixDD currDD;
   if ((*ddsim->iterator)->getType() == qc::Measure) {
     // Perform a measurement of the desired qubits, based on the amplitudes of
@@ -361,6 +834,8 @@ Result ddsimStepForward(SimulationState* self) {
       ddsim->dd->performCollapsingMeasurement(ddsim->simulationState,
                                               static_cast<dd::Qubit>(qubit),
                                               result ? pZero : pOne, result);
+      recordTraceEvent(ddsim, TraceMeasurement, currentInstruction,
+                       (static_cast<size_t>(qubit) * 2) + (result ? 0 : 1));
       auto name = getClassicalBitName(ddsim, classicalBit);
       if (ddsim->variables.find(name) != ddsim->variables.end()) {
         VariableValue value;
@@ -379,6 +854,7 @@ Result ddsimStepForward(SimulationState* self) {
     ddsim->previousInstructionStack
         .clear(); // after measurements, we can no longer step back.
     ddsim->restoreCallReturnStack.clear();
+    recordTraceNodeCount(ddsim, currentInstruction);
     return OK;
   }
   if ((*ddsim->iterator)->getType() == qc::Reset) {
@@ -396,15 +872,19 @@ Result ddsimStepForward(SimulationState* self) {
       ddsim->dd->performCollapsingMeasurement(ddsim->simulationState,
                                               static_cast<dd::Qubit>(qubit),
                                               result ? pZero : pOne, result);
+      recordTraceEvent(ddsim, TraceMeasurement, currentInstruction,
+                       (static_cast<size_t>(qubit) * 2) + (result ? 0 : 1));
       if (!result) {
         const auto x = qc::StandardOperation(qubit, qc::X);
         auto tmp = ddsim->dd->multiply(dd::getDD(&x, *ddsim->dd),
                                        ddsim->simulationState);
+        ddsim->metrics.ddMultiplications++;
         ddsim->dd->incRef(tmp);
         ddsim->dd->decRef(ddsim->simulationState);
         ddsim->simulationState = tmp;
       }
     }
+    recordTraceNodeCount(ddsim, currentInstruction);
     return OK;
   }
   if ((*ddsim->iterator)->getType() == qc::Barrier) {
@@ -437,41 +917,122 @@ Result ddsimStepForward(SimulationState* self) {
   }
 
   auto temp = ddsim->dd->multiply(currDD, ddsim->simulationState);
+  ddsim->metrics.ddMultiplications++;
   ddsim->dd->incRef(temp);
   ddsim->dd->decRef(ddsim->simulationState);
   ddsim->simulationState = temp;
-  ddsim->dd->garbageCollect();
+  collectGarbage(ddsim);
 
   ddsim->iterator++;
+  recordTraceNodeCount(ddsim, currentInstruction);
   return OK;
 }
 
+Result ddsimStepForward(SimulationState* self) {
+  auto* ddsim = toDDSimulationState(self);
+  if (!self->canStepForward(self)) {
+    return ERROR;
+  }
+  // Operations are only applied if the DD package fits into the memory
+  // budget, so that a refused step leaves the state unchanged.
+  if (ddsim->instructionTypes[ddsim->currentInstruction] == SIMULATE &&
+      !checkMemoryBudget(ddsim)) {
+    return ERROR;
+  }
+  ddsim->lastMetBreakpoint = -1ULL;
+  const auto currentInstruction = ddsim->currentInstruction;
+  recordTraceEvent(ddsim, TraceStepForward, currentInstruction);
+  {
+    const ScopedTimer timer(ddsim->metrics.diagnosticsCallbackTime);
+    ddsim->metrics.diagnosticsCallbacks++;
+    dddiagnosticsOnStepForward(&ddsim->diagnostics, currentInstruction);
+  }
+  ddsim->currentInstruction = ddsim->successorInstructions[currentInstruction];
+
+  if (ddsim->currentInstruction == 0) {
+    ddsim->currentInstruction = ddsim->callReturnStack.back() + 1;
+    ddsim->restoreCallReturnStack.emplace_back(ddsim->currentInstruction,
+                                               ddsim->callReturnStack.back());
+    popCallFrame(ddsim);
+    recordTraceEvent(ddsim, TraceReturn, currentInstruction,
+                     ddsim->currentInstruction);
+  }
+
+  // Instructions other than `SIMULATE` do not change the state, so their
+  // breakpoint hits can be counted before they are executed.
+  if (ddsim->instructionTypes[currentInstruction] != SIMULATE) {
+    countBreakpointHit(ddsim);
+  }
+
+  if (ddsim->instructionTypes[currentInstruction] == CALL) {
+    pushCallFrame(ddsim, currentInstruction);
+    recordTraceEvent(ddsim, TraceCall, currentInstruction,
+                     ddsim->currentInstruction);
+  }
+  ddsim->previousInstructionStack.emplace_back(currentInstruction);
+
+  // The exact action we take depends on the type of the next instruction:
+  // - ASSERTION: check the assertion and step back if it fails.
+  // - Non-SIMULATE: just step to the next instruction.
+  // - SIMULATE: run the corresponding operation on the DD backend.
+  if (ddsim->instructionTypes[currentInstruction] == ASSERTION) {
+    try {
+      const auto failed = !checkAssertionCached(ddsim, currentInstruction);
+      if (failed && ddsim->lastFailedAssertion != currentInstruction) {
+        ddsim->lastFailedAssertion = currentInstruction;
+        self->stepBackward(self);
+      }
+      return OK;
+    } catch (const std::exception& e) {
+      std::cerr << e.what() << "\n";
+      return ERROR;
+    }
+  }
+
+  ddsim->lastFailedAssertion = -1ULL;
+  if (ddsim->instructionTypes[currentInstruction] != SIMULATE) {
+    return OK;
+  }
+
+  const auto result = applyOperation(ddsim, currentInstruction);
+  countBreakpointHit(ddsim);
+  return result;
+}
+
 Result ddsimStepBackward(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
   if (!self->canStepBackward(self)) {
     return ERROR;
   }
+  if (ddsim->instructionTypes[ddsim->previousInstructionStack.back()] ==
+          SIMULATE &&
+      !checkMemoryBudget(ddsim)) {
+    return ERROR;
+  }
 
   ddsim->lastMetBreakpoint = -1ULL;
+  if (isBreakpoint(ddsim, ddsim->currentInstruction)) {
+    updateBreakpointHits(ddsim, ddsim->currentInstruction, -1);
+  }
   if (!ddsim->restoreCallReturnStack.empty() &&
       ddsim->currentInstruction == ddsim->restoreCallReturnStack.back().first) {
-    ddsim->callReturnStack.push_back(
-        ddsim->restoreCallReturnStack.back().second);
+    pushCallFrame(ddsim, ddsim->restoreCallReturnStack.back().second);
     ddsim->restoreCallReturnStack.pop_back();
   }
 
   ddsim->currentInstruction = ddsim->previousInstructionStack.back();
   ddsim->previousInstructionStack.pop_back();
+  recordTraceEvent(ddsim, TraceStepBackward, ddsim->currentInstruction);
 
   if (!ddsim->callReturnStack.empty() &&
       ddsim->currentInstruction == ddsim->callReturnStack.back()) {
-    ddsim->callReturnStack.pop_back();
+    popCallFrame(ddsim);
   }
 
   // When going backwards, we still run the instruction that hits the breakpoint
   // because we want to stop *before* it.
-  if (ddsim->breakpoints.find(ddsim->currentInstruction) !=
-      ddsim->breakpoints.end()) {
+  if (isBreakpoint(ddsim, ddsim->currentInstruction) &&
+      updateBreakpointHits(ddsim, ddsim->currentInstruction, 0)) {
     ddsim->lastMetBreakpoint = ddsim->currentInstruction;
   }
 
@@ -512,15 +1073,19 @@ Result ddsimStepBackward(SimulationState* self) {
   }
 
   auto temp = ddsim->dd->multiply(currDD, ddsim->simulationState);
+  ddsim->metrics.ddMultiplications++;
   ddsim->dd->incRef(temp);
   ddsim->dd->decRef(ddsim->simulationState);
   ddsim->simulationState = temp;
-  ddsim->dd->garbageCollect();
+  collectGarbage(ddsim);
 
+  recordTraceNodeCount(ddsim, ddsim->currentInstruction);
   return OK;
 }
 
 Result ddsimRunAll(SimulationState* self, size_t* failedAssertions) {
+  auto* ddsim = toDDSimulationState(self);
+  dddiagnosticsClearFailedAssertions(&ddsim->diagnostics);
   size_t errorCount = 0;
   while (!self->isFinished(self)) {
     const Result result = self->runSimulation(self);
@@ -528,6 +1093,10 @@ Result ddsimRunAll(SimulationState* self, size_t* failedAssertions) {
       return result;
     }
     if (self->didAssertionFail(self)) {
+      const ScopedTimer timer(ddsim->metrics.diagnosticsCallbackTime);
+      ddsim->metrics.diagnosticsCallbacks++;
+      dddiagnosticsOnAssertionFailed(&ddsim->diagnostics,
+                                     ddsim->lastFailedAssertion);
       errorCount++;
     }
   }
@@ -581,14 +1150,17 @@ Result ddsimResetSimulation(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
   ddsim->currentInstruction = 0;
   ddsim->previousInstructionStack.clear();
-  ddsim->callReturnStack.clear();
+  clearCallFrames(ddsim);
   ddsim->restoreCallReturnStack.clear();
 
   ddsim->iterator = ddsim->qc->begin();
   ddsim->lastFailedAssertion = -1ULL;
   ddsim->lastMetBreakpoint = -1ULL;
+  dddiagnosticsClearFailedAssertions(&ddsim->diagnostics);
+  ddsim->trace.clear();
 
   resetSimulationState(ddsim);
+  resetBreakpointConditions(ddsim);
   return OK;
 }
 
@@ -621,7 +1193,10 @@ bool ddsimDidAssertionFail(SimulationState* self) {
 
 bool ddsimWasBreakpointHit(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
-  return ddsim->lastMetBreakpoint == ddsim->currentInstruction;
+  // The condition on the state is only checked once the step that reached the
+  // breakpoint is complete, so it sees the state the simulation is paused in.
+  return ddsim->lastMetBreakpoint == ddsim->currentInstruction &&
+         isBreakpointConditionMet(ddsim, ddsim->currentInstruction);
 }
 
 size_t ddsimGetCurrentInstruction(SimulationState* self) {
@@ -660,6 +1235,55 @@ Result ddsimGetInstructionPosition(SimulationState* self, size_t instruction,
   return OK;
 }
 
+Result ddsimGetInstructionPositions(SimulationState* self, size_t count,
+                                    size_t* starts, size_t* ends) {
+  if (count > self->getInstructionCount(self)) {
+    return ERROR;
+  }
+  for (size_t i = 0; i < count; i++) {
+    const auto result =
+        ddsimGetInstructionPosition(self, i, &starts[i], &ends[i]);
+    if (result != OK) {
+      return result;
+    }
+  }
+  return OK;
+}
+
+Result ddsimGetCodeCoordinates(SimulationState* self, size_t position,
+                               size_t* line, size_t* column) {
+  auto* ddsim = toDDSimulationState(self);
+  if (position > ddsim->code.size() || ddsim->lineStarts.empty()) {
+    return ERROR;
+  }
+  // The line is the last one that starts at or before the position.
+  const auto next = std::upper_bound(ddsim->lineStarts.begin(),
+                                     ddsim->lineStarts.end(), position);
+  const auto lineIndex =
+      static_cast<size_t>(std::distance(ddsim->lineStarts.begin(), next)) - 1;
+  *line = lineIndex;
+  *column = position - ddsim->lineStarts[lineIndex];
+  return OK;
+}
+
+Result ddsimGetCodePosition(SimulationState* self, size_t line, size_t column,
+                            size_t* position) {
+  auto* ddsim = toDDSimulationState(self);
+  if (line >= ddsim->lineStarts.size()) {
+    return ERROR;
+  }
+  // A line ends with its line break, and the last line with the end of the
+  // code, which is a valid position itself.
+  const auto lineEnd = line + 1 < ddsim->lineStarts.size()
+                           ? ddsim->lineStarts[line + 1]
+                           : ddsim->code.size() + 1;
+  if (column >= lineEnd - ddsim->lineStarts[line]) {
+    return ERROR;
+  }
+  *position = ddsim->lineStarts[line] + column;
+  return OK;
+}
+
 size_t ddsimGetNumQubits(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
   return ddsim->qc->getNqubits();
@@ -713,6 +1337,9 @@ Result ddsimGetClassicalVariableName(SimulationState* self,
 }
 
 Result ddsimGetStateVectorFull(SimulationState* self, Statevector* output) {
+  auto* ddsim = toDDSimulationState(self);
+  ddsim->metrics.stateVectorExpansions++;
+  ddsim->metrics.stateVectorExpansionAmplitudes += output->numStates;
   const Span<Complex> amplitudes(output->amplitudes, output->numStates);
   for (size_t i = 0; i < output->numStates; i++) {
     self->getAmplitudeIndex(self, i, &amplitudes[i]);
@@ -790,63 +1417,142 @@ Result ddsimGetStateVectorSub(SimulationState* self, size_t subStateSize,
     index = i;
   }
 
-  if (index == -1) {
+  if (index == -1) {
+    return ERROR;
+  }
+
+  for (size_t i = 0; i < traced.size(); i++) {
+    outAmplitudes[i] = {vectors(static_cast<int>(i), index).real(),
+                        vectors(static_cast<int>(i), index).imag()};
+  }
+
+  return OK;
+}
+
+Diagnostics* ddsimGetDiagnostics(SimulationState* self) {
+  auto* ddsim = toDDSimulationState(self);
+  return &ddsim->diagnostics.interface;
+}
+
+/**
+ * @brief Find the instruction at which a breakpoint at the given position would
+ * be set.
+ *
+ * Instructions outside of gate bodies and the instructions of each gate body do
+ * not overlap and are sorted by their position, so their end positions are
+ * sorted as well and can be searched with a binary search. Breakpoints inside a
+ * custom gate definition are set at the instruction of the gate's body that
+ * contains the position. If no such instruction exists, the breakpoint is set
+ * at the gate definition itself.
+ * @param ddsim The simulation state.
+ * @param position The position in the code.
+ * @return The index of the instruction, or -1 if no instruction contains the
+ * position.
+ */
+size_t findBreakpointInstruction(const DDSimulationState* ddsim,
+                                 size_t position) {
+  const auto& ends = ddsim->instructionEnds;
+  const auto& topLevel = ddsim->topLevelInstructions;
+  const auto found = std::lower_bound(
+      topLevel.begin(), topLevel.end(), position,
+      [&ends](size_t instruction, size_t searched) {
+        return ends[instruction] < searched;
+      });
+  if (found == topLevel.end() ||
+      ddsim->instructionStarts[*found] > position) {
+    return -1ULL;
+  }
+  const auto instruction = *found;
+  if (!ddsim->functionDefinitions[instruction]) {
+    return instruction;
+  }
+
+  // The body of a gate definition, including its `RETURN` instruction, lies
+  // between the definition and its successor.
+  const auto bodyBegin =
+      ends.begin() + static_cast<std::ptrdiff_t>(instruction + 1);
+  const auto bodyEnd =
+      ends.begin() +
+      static_cast<std::ptrdiff_t>(ddsim->successorInstructions[instruction]);
+  const auto foundInBody = std::lower_bound(bodyBegin, bodyEnd, position);
+  if (foundInBody == bodyEnd) {
+    return instruction;
+  }
+  const auto bodyInstruction =
+      static_cast<size_t>(std::distance(ends.begin(), foundInBody));
+  return ddsim->instructionStarts[bodyInstruction] > position
+             ? instruction
+             : bodyInstruction;
+}
+
+Result ddsimSetBreakpoint(SimulationState* self, size_t desiredPosition,
+                          size_t* targetInstruction) {
+  auto* ddsim = toDDSimulationState(self);
+  const auto instruction = findBreakpointInstruction(ddsim, desiredPosition);
+  if (instruction == -1ULL) {
     return ERROR;
   }
-
-  for (size_t i = 0; i < traced.size(); i++) {
-    outAmplitudes[i] = {vectors(static_cast<int>(i), index).real(),
-                        vectors(static_cast<int>(i), index).imag()};
-  }
-
+  *targetInstruction = instruction;
+  ddsim->breakpoints[instruction] = true;
   return OK;
 }
 
-Diagnostics* ddsimGetDiagnostics(SimulationState* self) {
+Result ddsimSetBreakpoints(SimulationState* self,
+                           const size_t* desiredPositions, size_t count,
+                           size_t* targetInstructions) {
   auto* ddsim = toDDSimulationState(self);
-  return &ddsim->diagnostics.interface;
+  const Span<const size_t> positions(desiredPositions, count);
+  const Span<size_t> targets(targetInstructions, count);
+  for (size_t i = 0; i < count; i++) {
+    const auto instruction = findBreakpointInstruction(ddsim, positions[i]);
+    targets[i] = instruction;
+    if (instruction != -1ULL) {
+      ddsim->breakpoints[instruction] = true;
+    }
+  }
+  return OK;
 }
 
-Result ddsimSetBreakpoint(SimulationState* self, size_t desiredPosition,
-                          size_t* targetInstruction) {
+Result ddsimSetBreakpointCondition(SimulationState* self, size_t instruction,
+                                  const char* condition,
+                                  const char* hitCondition) {
   auto* ddsim = toDDSimulationState(self);
-  for (auto i = 0ULL; i < ddsim->instructionTypes.size(); i++) {
-    const size_t start = ddsim->instructionStarts[i];
-    const size_t end = ddsim->instructionEnds[i];
-    if (desiredPosition >= start && desiredPosition <= end) {
-      if (ddsim->functionDefinitions.find(i) !=
-          ddsim->functionDefinitions.end()) {
-        // Breakpoint may be located in a sub-gate of the gate definition.
-        for (auto j = i + 1; j < ddsim->instructionTypes.size(); j++) {
-          const size_t startSub = ddsim->instructionStarts[j];
-          const size_t endSub = ddsim->instructionEnds[j];
-          if (startSub > desiredPosition) {
-            break;
-          }
-          if (endSub >= desiredPosition) {
-            *targetInstruction = j;
-            ddsim->breakpoints.insert(j);
-            return OK;
-          }
-          if (ddsim->instructionTypes[j] == RETURN) {
-            break;
-          }
-        }
-        *targetInstruction = i;
-        ddsim->breakpoints.insert(i);
-        return OK;
-      }
-      *targetInstruction = i;
-      ddsim->breakpoints.insert(i);
-      return OK;
+  if (!isBreakpoint(ddsim, instruction)) {
+    return ERROR;
+  }
+  const std::string conditionString = condition == nullptr ? "" : condition;
+  const std::string hitConditionString =
+      hitCondition == nullptr ? "" : hitCondition;
+
+  BreakpointConditions conditions{};
+  conditions.hasCondition = !trim(conditionString).empty();
+  conditions.hasHitCondition = !trim(hitConditionString).empty();
+  if (!conditions.hasCondition && !conditions.hasHitCondition) {
+    ddsim->breakpointConditions.erase(instruction);
+    return OK;
+  }
+  try {
+    if (conditions.hasCondition) {
+      conditions.condition = parseBreakpointCondition(conditionString);
     }
+    if (conditions.hasHitCondition) {
+      conditions.hitCondition = parseHitCondition(hitConditionString);
+    }
+  } catch (const ParsingError& e) {
+    std::cerr << e.what() << "\n";
+    return ERROR;
   }
-  return ERROR;
+  if (!resolveBreakpointCondition(ddsim, conditions)) {
+    return ERROR;
+  }
+  ddsim->breakpointConditions[instruction] = std::move(conditions);
+  return OK;
 }
 
 Result ddsimClearBreakpoints(SimulationState* self) {
   auto* ddsim = toDDSimulationState(self);
-  ddsim->breakpoints.clear();
+  std::fill(ddsim->breakpoints.begin(), ddsim->breakpoints.end(), false);
+  ddsim->breakpointConditions.clear();
   return OK;
 }
 
@@ -879,22 +1585,99 @@ Result ddsimGetStackTrace(SimulationState* self, size_t maxDepth,
   return OK;
 }
 
+Result ddsimSetTraceCapacity(SimulationState* self, size_t capacity,
+                             bool recordNodeCounts) {
+  auto* ddsim = toDDSimulationState(self);
+  try {
+    ddsim->trace.setCapacity(capacity);
+  } catch (const std::bad_alloc& e) {
+    std::cerr << e.what() << "\n";
+    ddsim->trace.setCapacity(0);
+    return ERROR;
+  }
+  ddsim->traceNodeCounts = recordNodeCounts;
+  return OK;
+}
+
+size_t ddsimGetTraceLength(SimulationState* self) {
+  auto* ddsim = toDDSimulationState(self);
+  return ddsim->trace.size();
+}
+
+Result ddsimGetTrace(SimulationState* self, size_t start, size_t count,
+                     TraceEvent* events) {
+  auto* ddsim = toDDSimulationState(self);
+  return ddsim->trace.copy(start, count, events) ? OK : ERROR;
+}
+
+Result ddsimGetMetrics(SimulationState* self, Metrics* output) {
+  auto* ddsim = toDDSimulationState(self);
+  *output = ddsim->metrics;
+  return OK;
+}
+
+Result ddsimResetMetrics(SimulationState* self) {
+  auto* ddsim = toDDSimulationState(self);
+  ddsim->metrics = {};
+  return OK;
+}
+
+Result ddsimGetMemoryStatistics(SimulationState* self,
+                                MemoryStatistics* output) {
+  auto* ddsim = toDDSimulationState(self);
+  const auto& vectors = ddsim->dd->vUniqueTable;
+  const auto& matrices = ddsim->dd->mUniqueTable;
+  const auto& multiplications =
+      ddsim->dd->matrixVectorMultiplication.getStats();
+  const auto& additions = ddsim->dd->vectorAdd.getStats();
+  output->vectorNodes = vectors.getNumEntries();
+  output->activeVectorNodes = vectors.getNumActiveEntries();
+  updatePeakActiveVectorNodes(ddsim);
+  output->peakActiveVectorNodes = ddsim->peakActiveVectorNodes;
+  output->matrixNodes = matrices.getNumEntries();
+  output->activeMatrixNodes = matrices.getNumActiveEntries();
+  output->nodeMemory = getNodeMemory(ddsim);
+  output->packageMemory = getPackageMemory(ddsim);
+  output->memoryBudget = ddsim->memoryBudget;
+  output->budgetCollections = ddsim->budgetCollections;
+  output->budgetExceeded = ddsim->budgetExceeded;
+  output->multiplicationTableEntries = multiplications.numEntries;
+  output->multiplicationTableBuckets = multiplications.numBuckets;
+  output->multiplicationTableHitRatio = multiplications.hitRatio();
+  output->additionTableEntries = additions.numEntries;
+  output->additionTableBuckets = additions.numBuckets;
+  output->additionTableHitRatio = additions.hitRatio();
+  return OK;
+}
+
+Result ddsimSetMemoryBudget(SimulationState* self, size_t bytes) {
+  auto* ddsim = toDDSimulationState(self);
+  ddsim->memoryBudget = bytes;
+  ddsim->budgetExceeded = false;
+  return OK;
+}
+
 Result destroyDDSimulationState(DDSimulationState* self) {
   self->ready = false;
+  clearAssertionCache(self);
   destroyDDDiagnostics(&self->diagnostics);
+  if (self->dd != nullptr && self->simulationState.p != nullptr) {
+    self->dd->decRef(self->simulationState);
+    self->simulationState.p = nullptr;
+  }
+  releaseDDPackage(std::move(self->dd));
   return OK;
 }
 
 //-----------------------------------------------------------------------------------------
 
-std::vector<std::string> getTargetVariables(DDSimulationState* ddsim,
-                                            size_t instruction) {
-  std::vector<std::string> result;
+std::vector<VariableReference> getTargetVariables(DDSimulationState* ddsim,
+                                                  size_t instruction) {
+  std::vector<VariableReference> result;
   size_t parentFunction = -1ULL;
   size_t i = instruction;
   while (true) {
-    if (ddsim->functionDefinitions.find(i) !=
-        ddsim->functionDefinitions.end()) {
+    if (ddsim->functionDefinitions[i]) {
       parentFunction = i;
       break;
     }
@@ -909,21 +1692,19 @@ std::vector<std::string> getTargetVariables(DDSimulationState* ddsim,
 
   const auto parameters = parentFunction != -1ULL
                               ? ddsim->targetQubits[parentFunction]
-                              : std::vector<std::string>{};
+                              : Span<const VariableReference>(nullptr, 0);
   for (const auto& target : ddsim->targetQubits[instruction]) {
     if (std::find(parameters.begin(), parameters.end(), target) !=
         parameters.end()) {
       result.push_back(target);
       continue;
     }
-    const auto foundRegister =
-        std::find_if(ddsim->qubitRegisters.begin(), ddsim->qubitRegisters.end(),
-                     [target](const QubitRegisterDefinition& reg) {
-                       return reg.name == target;
-                     });
-    if (foundRegister != ddsim->qubitRegisters.end()) {
-      for (size_t j = 0; j < foundRegister->size; j++) {
-        result.push_back(target + "[" + std::to_string(j) + "]");
+    const auto foundRegister = ddsim->qubitRegisterIndices.find(target.symbol);
+    if (target.isFullRegister() &&
+        foundRegister != ddsim->qubitRegisterIndices.end()) {
+      const auto size = ddsim->qubitRegisters[foundRegister->second].size;
+      for (size_t j = 0; j < size; j++) {
+        result.push_back({target.symbol, j});
       }
     } else {
       result.push_back(target);
@@ -932,53 +1713,119 @@ std::vector<std::string> getTargetVariables(DDSimulationState* ddsim,
   return result;
 }
 
-size_t variableToQubit(DDSimulationState* ddsim, const std::string& variable) {
-  auto declaration = replaceString(variable, " ", "");
-  declaration = replaceString(declaration, "\t", "");
-  std::string var;
-  size_t idx = 0;
-  if (declaration.find('[') != std::string::npos) {
-    auto parts = splitString(declaration, '[');
-    var = parts[0];
-    idx = std::stoul(parts[1].substr(0, parts[1].size() - 1));
-  } else {
-    var = declaration;
+/**
+ * @brief Finds the resolved parameter with the given symbol in a call frame.
+ * @param frame The call frame to search.
+ * @param symbol The symbol of the parameter.
+ * @return A pointer to the resolved parameter, or `nullptr` if the symbol is
+ * not a parameter of the call.
+ */
+const ResolvedParameter* findParameter(const CallFrame& frame,
+                                       SymbolId symbol) {
+  const auto found =
+      std::lower_bound(frame.parameters.begin(), frame.parameters.end(), symbol,
+                       [](const ResolvedParameter& parameter, SymbolId id) {
+                         return parameter.parameter < id;
+                       });
+  if (found == frame.parameters.end() || found->parameter != symbol) {
+    return nullptr;
   }
+  return &*found;
+}
 
-  for (size_t i = ddsim->callReturnStack.size() - 1; i != -1ULL; i--) {
-    const auto call = ddsim->callReturnStack[i];
-    if (ddsim->callSubstitutions[call].find(var) ==
-        ddsim->callSubstitutions[call].end()) {
+/**
+ * @brief Resolves a variable in the current scope to the global variable it
+ * refers to.
+ *
+ * The parameters of each frame are already resolved to global variables, so
+ * only the innermost frame that defines the variable has to be considered.
+ * @param ddsim The simulation state to query.
+ * @param variable The reference to the variable.
+ * @return The reference to the global variable.
+ */
+VariableReference resolveVariable(DDSimulationState* ddsim,
+                                  const VariableReference& variable) {
+  for (auto frame = ddsim->callFrames.rbegin();
+       frame != ddsim->callFrames.rend(); frame++) {
+    const auto* parameter = findParameter(*frame, variable.symbol);
+    if (parameter == nullptr) {
       continue;
     }
-    var = ddsim->callSubstitutions[call][var];
-    if (var.find('[') != std::string::npos) {
-      auto parts = splitString(var, '[');
-      var = parts[0];
-      idx = std::stoul(parts[1].substr(0, parts[1].size() - 1));
+    // Substituting a full register keeps the index used inside the gate.
+    if (parameter->variable.isFullRegister()) {
+      return {parameter->variable.symbol, variable.index};
     }
+    return parameter->variable;
   }
+  return variable;
+}
 
-  for (auto& reg : ddsim->qubitRegisters) {
-    if (reg.name == var) {
-      if (idx >= reg.size) {
-        throw std::runtime_error("Index out of bounds");
-      }
-      return reg.index + idx;
+size_t globalVariableToQubit(DDSimulationState* ddsim,
+                             const VariableReference& variable) {
+  const auto foundRegister = ddsim->qubitRegisterIndices.find(variable.symbol);
+  if (foundRegister == ddsim->qubitRegisterIndices.end()) {
+    throw std::runtime_error("Unknown variable name " +
+                             ddsim->symbols.getName(variable.symbol));
+  }
+  const auto& reg = ddsim->qubitRegisters[foundRegister->second];
+  // A full register without an index refers to its first qubit.
+  const auto idx = variable.isFullRegister() ? 0 : variable.index;
+  if (idx >= reg.size) {
+    throw std::runtime_error("Index out of bounds");
+  }
+  return reg.index + idx;
+}
+
+void pushCallFrame(DDSimulationState* ddsim, size_t call) {
+  CallFrame frame{call, {}};
+  const auto& substitution = ddsim->callSubstitutions[call];
+  frame.parameters.reserve(substitution.size());
+  // `substitution` is ordered by symbol, so the parameters are sorted as well.
+  for (const auto& [parameter, argument] : substitution) {
+    const auto variable = resolveVariable(ddsim, argument);
+    size_t qubit = -1ULL;
+    try {
+      qubit = globalVariableToQubit(ddsim, variable);
+    } catch (const std::runtime_error&) {
+      // Invalid arguments are only reported once they are actually used.
     }
+    frame.parameters.push_back({parameter, variable, qubit});
   }
-  throw std::runtime_error("Unknown variable name " + var);
+  ddsim->callReturnStack.push_back(call);
+  ddsim->callFrames.push_back(std::move(frame));
+}
+
+void popCallFrame(DDSimulationState* ddsim) {
+  ddsim->callReturnStack.pop_back();
+  ddsim->callFrames.pop_back();
+}
+
+void clearCallFrames(DDSimulationState* ddsim) {
+  ddsim->callReturnStack.clear();
+  ddsim->callFrames.clear();
+}
+
+size_t variableToQubit(DDSimulationState* ddsim,
+                       const VariableReference& variable) {
+  if (!ddsim->callFrames.empty()) {
+    const auto* parameter =
+        findParameter(ddsim->callFrames.back(), variable.symbol);
+    // Gate parameters are used without an index, so their qubit is known.
+    if (parameter != nullptr && parameter->qubit != -1ULL &&
+        (variable.isFullRegister() || !parameter->variable.isFullRegister())) {
+      return parameter->qubit;
+    }
+  }
+  return globalVariableToQubit(ddsim, resolveVariable(ddsim, variable));
 }
 
 std::pair<size_t, size_t> variableToQubitAt(DDSimulationState* ddsim,
-                                            const std::string& variable,
+                                            const VariableReference& variable,
                                             size_t instruction) {
   size_t sweep = instruction;
   size_t functionDef = -1ULL;
   while (sweep < ddsim->instructionTypes.size()) {
-    if (std::find(ddsim->functionDefinitions.begin(),
-                  ddsim->functionDefinitions.end(),
-                  sweep) != ddsim->functionDefinitions.end()) {
+    if (ddsim->functionDefinitions[sweep]) {
       functionDef = sweep;
       break;
     }
@@ -995,11 +1842,12 @@ std::pair<size_t, size_t> variableToQubitAt(DDSimulationState* ddsim,
 
   // In a gate-local scope, we have to define qubit indices relative to the
   // gate.
-  const auto& targets = ddsim->targetQubits[functionDef];
+  const auto targets = ddsim->targetQubits[functionDef];
 
   const auto found = std::find(targets.begin(), targets.end(), variable);
   if (found == targets.end()) {
-    throw std::runtime_error("Unknown variable name " + variable);
+    throw std::runtime_error("Unknown variable name " +
+                             ddsim->symbols.toString(variable));
   }
 
   return {static_cast<size_t>(std::distance(targets.begin(), found)),
@@ -1046,29 +1894,6 @@ Complex complexAddition(const Complex& c1, const Complex& c2) {
   return {real, imaginary};
 }
 
-/**
- * @brief Compute the dot product of two state vectors.
- * @param sv1 The first state vector.
- * @param sv2 The second state vector.
- * @return The computed dot product.
- */
-double dotProduct(const Statevector& sv1, const Statevector& sv2) {
-  double resultReal = 0;
-  double resultImag = 0;
-
-  const Span<Complex> amplitudes1(sv1.amplitudes, sv1.numStates);
-  const Span<Complex> amplitudes2(sv2.amplitudes, sv2.numStates);
-
-  for (size_t i = 0; i < sv1.numStates; i++) {
-    resultReal += amplitudes1[i].real * amplitudes2[i].real -
-                  amplitudes1[i].imaginary * amplitudes2[i].imaginary;
-    resultImag += amplitudes1[i].real * amplitudes2[i].imaginary +
-                  amplitudes1[i].imaginary * amplitudes2[i].real;
-  }
-  Complex result{resultReal, resultImag};
-  return complexMagnitude(result);
-}
-
 /**
  * @brief For a given value, extract the bits at the given indices of its binary
  * representation.
@@ -1226,7 +2051,8 @@ getPartialTraceFromStateVector(const Statevector& sv,
       if (split1.first != split2.first) {
         continue;
       }
-      const auto product = complexMultiplication(amplitudes[i], amplitudes[j]);
+      const auto product =
+          complexMultiplication(amplitudes[i], complexConjugate(amplitudes[j]));
       const auto row = split1.second;
       const auto col = split2.second;
       traceMatrix[row][col] = complexAddition(traceMatrix[row][col], product);
@@ -1289,11 +2115,13 @@ bool isSubStateVectorLegal(const Statevector& full,
  * Checks the given entanglement assertion on the given state.
  * @param ddsim The simulation state.
  * @param assertion The entanglement assertion to check.
+ * @param qubits The qubit indices the assertion's targets resolve to.
  * @return True if the assertion is satisfied, false otherwise.
  */
 bool checkAssertionEntangled(
     DDSimulationState* ddsim,
-    std::unique_ptr<EntanglementAssertion>& assertion) {
+    [[maybe_unused]] std::unique_ptr<EntanglementAssertion>& assertion,
+    const std::vector<size_t>& qubits) {
   Statevector sv;
   sv.numQubits = ddsim->interface.getNumQubits(&ddsim->interface);
   sv.numStates = 1 << sv.numQubits;
@@ -1301,11 +2129,6 @@ bool checkAssertionEntangled(
   sv.amplitudes = amplitudes.data();
   ddsim->interface.getStateVectorFull(&ddsim->interface, &sv);
 
-  std::vector<size_t> qubits;
-  for (const auto& variable : assertion->getTargetQubits()) {
-    qubits.push_back(variableToQubit(ddsim, variable));
-  }
-
   std::vector<std::vector<Complex>> densityMatrix(
       sv.numStates, std::vector<Complex>(sv.numStates, {0, 0}));
   for (size_t i = 0; i < sv.numStates; i++) {
@@ -1332,17 +2155,13 @@ bool checkAssertionEntangled(
  * Checks the given superposition assertion on the given state.
  * @param ddsim The simulation state.
  * @param assertion The superposition assertion to check.
+ * @param qubits The qubit indices the assertion's targets resolve to.
  * @return True if the assertion is satisfied, false otherwise.
  */
 bool checkAssertionSuperposition(
     DDSimulationState* ddsim,
-    std::unique_ptr<SuperpositionAssertion>& assertion) {
-  std::vector<size_t> qubits;
-
-  for (const auto& variable : assertion->getTargetQubits()) {
-    qubits.push_back(variableToQubit(ddsim, variable));
-  }
-
+    [[maybe_unused]] std::unique_ptr<SuperpositionAssertion>& assertion,
+    const std::vector<size_t>& qubits) {
   Complex result;
   bool firstFound = false;
   std::vector<bool> bitstring;
@@ -1365,159 +2184,450 @@ bool checkAssertionSuperposition(
   return false;
 }
 
+qc::VectorDD getSubStateDD(DDSimulationState* ddsim,
+                           const std::vector<size_t>& qubits) {
+  const auto epsilon = 1e-8;
+  std::vector<size_t> sortedQubits = qubits;
+  std::sort(sortedQubits.begin(), sortedQubits.end());
+  const auto numTargets = sortedQubits.size();
+
+  // Move the target qubits to the lowest levels of the diagram. As the targets
+  // are sorted, each swap only moves a qubit that is not a target upwards.
+  auto state = ddsim->simulationState;
+  for (size_t i = 0; i < numTargets; i++) {
+    if (sortedQubits[i] == i) {
+      continue;
+    }
+    const qc::StandardOperation swap(
+        qc::Targets{static_cast<qc::Qubit>(i),
+                    static_cast<qc::Qubit>(sortedQubits[i])},
+        qc::SWAP);
+    state = ddsim->dd->multiply(dd::getDD(&swap, *ddsim->dd), state);
+    ddsim->metrics.ddMultiplications++;
+  }
+
+  // Every path through the upper levels ends in a sub-diagram for the targets.
+  // The sub-state is legal if and only if all of them are equal up to a
+  // scalar factor.
+  std::vector<dd::vNode*> subStates;
+  std::unordered_set<dd::vNode*> visited{state.p};
+  std::vector<dd::vNode*> stack{state.p};
+  while (!stack.empty()) {
+    auto* node = stack.back();
+    stack.pop_back();
+    if (static_cast<size_t>(node->v) < numTargets) {
+      subStates.push_back(node);
+      continue;
+    }
+    for (const auto& edge : node->e) {
+      if (!edge.isZeroTerminal() && visited.insert(edge.p).second) {
+        stack.push_back(edge.p);
+      }
+    }
+  }
+  if (subStates.empty()) {
+    throw std::runtime_error(
+        "Equality assertion on entangled sub-state is not allowed.");
+  }
+
+  const qc::VectorDD subState{subStates.front(), dd::Complex::one()};
+  const auto subStateNorm = static_cast<std::complex<double>>(
+                                ddsim->dd->innerProduct(subState, subState))
+                                .real();
+  for (size_t i = 1; i < subStates.size(); i++) {
+    const qc::VectorDD other{subStates[i], dd::Complex::one()};
+    const auto otherNorm = static_cast<std::complex<double>>(
+                               ddsim->dd->innerProduct(other, other))
+                               .real();
+    const auto overlap = std::norm(static_cast<std::complex<double>>(
+        ddsim->dd->innerProduct(subState, other)));
+    if (overlap < (1 - epsilon) * subStateNorm * otherNorm) {
+      throw std::runtime_error(
+          "Equality assertion on entangled sub-state is not allowed.");
+    }
+  }
+  return subState;
+}
+
+/**
+ * @brief Computes the similarity between a reference state and a sub-state,
+ * given by their amplitudes.
+ * @param reference The amplitudes of the reference state.
+ * @param subState The amplitudes of the sub-state, which may be unnormalized.
+ * @return The magnitude of the inner product of the reference state and the
+ * normalized sub-state.
+ */
+double getAmplitudeSimilarity(const dd::CVec& reference,
+                              const dd::CVec& subState) {
+  std::complex<double> result = 0;
+  double norm = 0;
+  for (size_t i = 0; i < subState.size(); i++) {
+    norm += std::norm(subState[i]);
+    if (i < reference.size()) {
+      result += std::conj(reference[i]) * subState[i];
+    }
+  }
+  return std::abs(result) / std::sqrt(norm);
+}
+
+/**
+ * @brief Converts a `Statevector` into a vector of complex amplitudes.
+ * @param sv The statevector to convert.
+ * @return The amplitudes of the statevector.
+ */
+dd::CVec toAmplitudeVector(const Statevector& sv) {
+  const Span<Complex> amplitudes(sv.amplitudes, sv.numStates);
+  dd::CVec result(sv.numStates);
+  for (size_t i = 0; i < sv.numStates; i++) {
+    result[i] = {amplitudes[i].real, amplitudes[i].imaginary};
+  }
+  return result;
+}
+
+double getSubStateSimilarityDD(DDSimulationState* ddsim,
+                               const std::vector<size_t>& qubits,
+                               const qc::VectorDD& reference) {
+  const auto subState = getSubStateDD(ddsim, qubits);
+  const auto overlap = std::abs(static_cast<std::complex<double>>(
+      ddsim->dd->innerProduct(reference, subState)));
+  const auto norm = static_cast<std::complex<double>>(
+                        ddsim->dd->innerProduct(subState, subState))
+                        .real();
+  return overlap / std::sqrt(norm);
+}
+
+double getSubStateSimilarityDD(DDSimulationState* ddsim,
+                               const std::vector<size_t>& qubits,
+                               const Statevector& reference) {
+  const auto referenceDD =
+      ddsim->dd->makeStateFromVector(toAmplitudeVector(reference));
+  return getSubStateSimilarityDD(ddsim, qubits, referenceDD);
+}
+
+double getSubStateSimilarity(DDSimulationState* ddsim,
+                             const std::vector<size_t>& qubits,
+                             const Statevector& reference) {
+  if (qubits.size() > DENSE_EQUALITY_MAX_QUBITS) {
+    return getSubStateSimilarityDD(ddsim, qubits, reference);
+  }
+  return getAmplitudeSimilarity(toAmplitudeVector(reference),
+                                getSubStateDD(ddsim, qubits).getVector());
+}
+
 /**
  * Checks the given statevector-equality assertion on the given state.
  * @param ddsim The simulation state.
  * @param assertion The equality assertion to check.
+ * @param qubits The qubit indices the assertion's targets resolve to.
  * @return True if the assertion is satisfied, false otherwise.
  */
 bool checkAssertionEqualityStatevector(
     DDSimulationState* ddsim,
-    std::unique_ptr<StatevectorEqualityAssertion>& assertion) {
-  std::vector<size_t> qubits;
-  for (const auto& variable : assertion->getTargetQubits()) {
-    qubits.push_back(variableToQubit(ddsim, variable));
-  }
+    std::unique_ptr<StatevectorEqualityAssertion>& assertion,
+    const std::vector<size_t>& qubits) {
+  const double similarityThreshold = assertion->getSimilarityThreshold();
 
-  Statevector sv;
-  sv.numQubits = qubits.size();
-  sv.numStates = 1 << sv.numQubits;
-  std::vector<Complex> amplitudes(sv.numStates);
-  sv.amplitudes = amplitudes.data();
+  const double similarity =
+      getSubStateSimilarity(ddsim, qubits, assertion->getTargetStatevector());
+
+  return similarity >= similarityThreshold;
+}
 
-  if (ddsim->interface.getStateVectorSub(&ddsim->interface, sv.numQubits,
-                                         qubits.data(), &sv) == ERROR) {
+/**
+ * @brief Build the quantum computation of the reference circuit of a
+ * circuit-equality assertion.
+ * @param parser An initialized simulation state without loaded code, whose
+ * instruction tables are filled with the reference circuit.
+ * @param circuitCode The code of the reference circuit.
+ * @return The quantum computation of the reference circuit.
+ */
+std::unique_ptr<qc::QuantumComputation>
+buildCircuitEqualityReference(DDSimulationState* parser,
+                              const std::string& circuitCode) {
+  std::vector<Instruction> instructions;
+  const auto validCode =
+      preprocessAssertionCode(circuitCode.c_str(), parser, instructions);
+  if (std::find(parser->instructionTypes.begin(),
+                parser->instructionTypes.end(),
+                ASSERTION) != parser->instructionTypes.end()) {
     throw std::runtime_error(
-        "Equality assertion on entangled sub-state is not allowed.");
+        "Circuit equality assertions cannot contain nested assertions");
   }
 
-  const double similarityThreshold = assertion->getSimilarityThreshold();
+  auto referenceQc = std::make_unique<qc::QuantumComputation>();
+  if (!buildQuantumComputation(parser, instructions, *referenceQc)) {
+    referenceQc = std::make_unique<qc::QuantumComputation>();
+    std::stringstream ss{validCode};
+    referenceQc->import(ss, qc::Format::OpenQASM3);
+    qc::CircuitOptimizer::flattenOperations(*referenceQc, true);
+  }
+  return referenceQc;
+}
+
+/**
+ * @brief Parse the code of the reference circuit of a circuit-equality
+ * assertion.
+ *
+ * The code is preprocessed by a temporary simulation state that is created and
+ * destroyed like any other. Its DD package is never used, as the reference
+ * circuit is simulated in the DD package of the asserting simulation state.
+ * @param circuitCode The code of the reference circuit.
+ * @return The quantum computation of the reference circuit.
+ */
+std::unique_ptr<qc::QuantumComputation>
+parseCircuitEqualityReference(const std::string& circuitCode) {
+  DDSimulationState parser;
+  if (createDDSimulationState(&parser) != OK) {
+    destroyDDSimulationState(&parser);
+    throw std::runtime_error("Failed to parse the reference circuit of a "
+                             "circuit equality assertion");
+  }
+  try {
+    auto referenceQc = buildCircuitEqualityReference(&parser, circuitCode);
+    destroyDDSimulationState(&parser);
+    return referenceQc;
+  } catch (...) {
+    destroyDDSimulationState(&parser);
+    throw;
+  }
+}
 
-  const double similarity = dotProduct(sv, assertion->getTargetStatevector());
+/**
+ * @brief Get the final state of the reference circuit of a circuit-equality
+ * assertion.
+ *
+ * The reference circuit is simulated in the DD package of `ddsim` the first
+ * time this is called for the given assertion. It acts on the lowest levels of
+ * the package, all other levels remain in the zero state. The final state is
+ * cached until new code is loaded.
+ * @param ddsim The simulation state.
+ * @param instruction The instruction of the circuit-equality assertion.
+ * @param circuitCode The code of the reference circuit.
+ * @param numTargets The number of target qubits of the assertion.
+ * @return The final state of the reference circuit.
+ */
+const qc::VectorDD&
+getCircuitEqualityReference(DDSimulationState* ddsim, size_t instruction,
+                            const std::string& circuitCode,
+                            size_t numTargets) {
+  const auto found = ddsim->circuitEqualityReferences.find(instruction);
+  if (found != ddsim->circuitEqualityReferences.end()) {
+    return found->second;
+  }
+
+  const auto referenceQc = parseCircuitEqualityReference(circuitCode);
+  if (referenceQc->getNqubits() != numTargets) {
+    throw std::runtime_error("The reference circuit of a circuit equality "
+                             "assertion must have one qubit per target");
+  }
+  for (const auto& op : *referenceQc) {
+    if (op->isNonUnitaryOperation() || op->isClassicControlledOperation()) {
+      throw std::runtime_error("The reference circuit of a circuit equality "
+                               "assertion must be unitary");
+    }
+  }
 
-  return similarity >= similarityThreshold;
+  auto reference = ddsim->dd->makeZeroState(ddsim->qc->getNqubits());
+  ddsim->dd->incRef(reference);
+  for (const auto& op : *referenceQc) {
+    if (op->getType() == qc::Barrier) {
+      continue;
+    }
+    const auto next =
+        ddsim->dd->multiply(dd::getDD(op.get(), *ddsim->dd), reference);
+    ddsim->metrics.ddMultiplications++;
+    ddsim->dd->incRef(next);
+    ddsim->dd->decRef(reference);
+    reference = next;
+  }
+  return ddsim->circuitEqualityReferences.insert({instruction, reference})
+      .first->second;
 }
 
 /**
  * Checks the given circuit-equality assertion on the given state.
  * @param ddsim The simulation state.
+ * @param instruction The instruction of the assertion.
  * @param assertion The equality assertion to check.
+ * @param qubits The qubit indices the assertion's targets resolve to.
  * @return True if the assertion is satisfied, false otherwise.
  */
 bool checkAssertionEqualityCircuit(
-    DDSimulationState* ddsim,
-    std::unique_ptr<CircuitEqualityAssertion>& assertion) {
-  std::vector<size_t> qubits;
-  for (const auto& variable : assertion->getTargetQubits()) {
-    qubits.push_back(variableToQubit(ddsim, variable));
-  }
-
-  DDSimulationState secondSimulation;
-  createDDSimulationState(&secondSimulation);
-  secondSimulation.interface.loadCode(&secondSimulation.interface,
-                                      assertion->getCircuitCode().c_str());
-  if (!secondSimulation.assertionInstructions.empty()) {
-    destroyDDSimulationState(&secondSimulation);
-    throw std::runtime_error(
-        "Circuit equality assertions cannot contain nested assertions");
-  }
-  secondSimulation.interface.runSimulation(&secondSimulation.interface);
-
-  Statevector sv2;
-  sv2.numQubits =
-      secondSimulation.interface.getNumQubits(&secondSimulation.interface);
-  sv2.numStates = 1 << sv2.numQubits;
-  std::vector<Complex> amplitudes2(sv2.numStates);
-  sv2.amplitudes = amplitudes2.data();
-  secondSimulation.interface.getStateVectorFull(&secondSimulation.interface,
-                                                &sv2);
-  destroyDDSimulationState(&secondSimulation);
+    DDSimulationState* ddsim, size_t instruction,
+    std::unique_ptr<CircuitEqualityAssertion>& assertion,
+    const std::vector<size_t>& qubits) {
+  const auto& reference = getCircuitEqualityReference(
+      ddsim, instruction, assertion->getCircuitCode(), qubits.size());
+  const double similarityThreshold = assertion->getSimilarityThreshold();
 
-  Statevector sv;
-  sv.numQubits = qubits.size();
-  sv.numStates = 1 << sv.numQubits;
-  std::vector<Complex> amplitudes(sv.numStates);
-  sv.amplitudes = amplitudes.data();
-  if (ddsim->interface.getStateVectorSub(&ddsim->interface, sv.numQubits,
-                                         qubits.data(), &sv) == ERROR) {
-    throw std::runtime_error(
-        "Equality assertion on entangled sub-state is not allowed.");
+  // All levels above the targets of the reference circuit are in the zero
+  // state, so its state is found at the end of their zero-successors.
+  auto referenceState = reference;
+  while (static_cast<size_t>(referenceState.p->v) >= qubits.size()) {
+    referenceState = referenceState.p->e[0];
   }
 
-  const double similarityThreshold = assertion->getSimilarityThreshold();
-
-  const double similarity = dotProduct(sv, sv2);
+  const double similarity =
+      qubits.size() > DENSE_EQUALITY_MAX_QUBITS
+          ? getSubStateSimilarityDD(ddsim, qubits, referenceState)
+          : getAmplitudeSimilarity(referenceState.getVector(),
+                                   getSubStateDD(ddsim, qubits).getVector());
 
   return similarity >= similarityThreshold;
 }
 
-bool checkAssertion(DDSimulationState* ddsim,
-                    std::unique_ptr<Assertion>& assertion) {
+bool checkAssertion(DDSimulationState* ddsim, size_t instruction,
+                    std::unique_ptr<Assertion>& assertion,
+                    const std::vector<size_t>& qubits) {
   if (assertion->getType() == AssertionType::Entanglement) {
+    const ScopedTimer timer(ddsim->metrics.entanglementAssertionTime);
+    ddsim->metrics.entanglementAssertionChecks++;
     std::unique_ptr<EntanglementAssertion> entanglementAssertion(
         dynamic_cast<EntanglementAssertion*>(assertion.release()));
-    auto result = checkAssertionEntangled(ddsim, entanglementAssertion);
+    auto result = checkAssertionEntangled(ddsim, entanglementAssertion, qubits);
     assertion = std::move(entanglementAssertion);
     return result;
   }
   if (assertion->getType() == AssertionType::Superposition) {
+    const ScopedTimer timer(ddsim->metrics.superpositionAssertionTime);
+    ddsim->metrics.superpositionAssertionChecks++;
     std::unique_ptr<SuperpositionAssertion> superpositionAssertion(
         dynamic_cast<SuperpositionAssertion*>(assertion.release()));
-    auto result = checkAssertionSuperposition(ddsim, superpositionAssertion);
+    auto result = checkAssertionSuperposition(ddsim, superpositionAssertion,
+                                              qubits);
     assertion = std::move(superpositionAssertion);
     return result;
   }
   if (assertion->getType() == AssertionType::StatevectorEquality) {
+    const ScopedTimer timer(ddsim->metrics.statevectorEqualityAssertionTime);
+    ddsim->metrics.statevectorEqualityAssertionChecks++;
     std::unique_ptr<StatevectorEqualityAssertion> svEqualityAssertion(
         dynamic_cast<StatevectorEqualityAssertion*>(assertion.release()));
-    auto result = checkAssertionEqualityStatevector(ddsim, svEqualityAssertion);
+    auto result = checkAssertionEqualityStatevector(ddsim, svEqualityAssertion,
+                                                    qubits);
     assertion = std::move(svEqualityAssertion);
     return result;
   }
   if (assertion->getType() == AssertionType::CircuitEquality) {
+    const ScopedTimer timer(ddsim->metrics.circuitEqualityAssertionTime);
+    ddsim->metrics.circuitEqualityAssertionChecks++;
     std::unique_ptr<CircuitEqualityAssertion> circuitEqualityAssertion(
         dynamic_cast<CircuitEqualityAssertion*>(assertion.release()));
-    auto result =
-        checkAssertionEqualityCircuit(ddsim, circuitEqualityAssertion);
+    auto result = checkAssertionEqualityCircuit(
+        ddsim, instruction, circuitEqualityAssertion, qubits);
     assertion = std::move(circuitEqualityAssertion);
     return result;
   }
   throw std::runtime_error("Unknown assertion type");
 }
 
+std::vector<size_t> getAssertionQubits(DDSimulationState* ddsim,
+                                       size_t instruction) {
+  const auto targets = ddsim->assertionTargets[instruction];
+  std::vector<size_t> qubits(targets.size());
+  std::transform(targets.begin(), targets.end(), qubits.begin(),
+                 [&ddsim](const VariableReference& target) {
+                   return variableToQubit(ddsim, target);
+                 });
+  return qubits;
+}
+
+bool AssertionCacheKey::operator==(const AssertionCacheKey& other) const {
+  return state == other.state && instruction == other.instruction &&
+         qubits == other.qubits;
+}
+
+size_t AssertionCacheKeyHash::operator()(const AssertionCacheKey& key) const {
+  size_t hash = std::hash<const void*>{}(key.state.p);
+  const auto combine = [&hash](size_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  };
+  combine(std::hash<const void*>{}(key.state.w.r));
+  combine(std::hash<const void*>{}(key.state.w.i));
+  combine(key.instruction);
+  for (const auto qubit : key.qubits) {
+    combine(qubit);
+  }
+  return hash;
+}
+
+bool checkAssertionCached(DDSimulationState* ddsim, size_t instruction) {
+  auto& assertion = ddsim->assertionInstructions[instruction];
+  AssertionCacheKey key{ddsim->simulationState, instruction,
+                        getAssertionQubits(ddsim, instruction)};
+
+  const auto found = ddsim->assertionCache.find(key);
+  if (found != ddsim->assertionCache.end()) {
+    ddsim->metrics.assertionCacheHits++;
+    return found->second;
+  }
+  ddsim->metrics.assertionCacheMisses++;
+
+  const auto result = checkAssertion(ddsim, instruction, assertion, key.qubits);
+
+  if (ddsim->assertionCacheOrder.size() >= ASSERTION_CACHE_CAPACITY) {
+    const auto& oldest = ddsim->assertionCacheOrder.front();
+    ddsim->dd->decRef(oldest.state);
+    ddsim->assertionCache.erase(oldest);
+    ddsim->assertionCacheOrder.pop_front();
+  }
+  ddsim->dd->incRef(key.state);
+  ddsim->assertionCacheOrder.push_back(key);
+  ddsim->assertionCache.insert({std::move(key), result});
+  return result;
+}
+
+void clearAssertionCache(DDSimulationState* ddsim) {
+  if (ddsim->dd != nullptr) {
+    for (const auto& key : ddsim->assertionCacheOrder) {
+      ddsim->dd->decRef(key.state);
+    }
+    for (const auto& reference : ddsim->circuitEqualityReferences) {
+      ddsim->dd->decRef(reference.second);
+    }
+  }
+  ddsim->assertionCache.clear();
+  ddsim->assertionCacheOrder.clear();
+  ddsim->circuitEqualityReferences.clear();
+}
+
 /**
- * @brief For an instruction that has a child block, extract the valid code from
- * the block's body.
+ * @brief Append the valid code of an instruction, including the valid code of
+ * its child block, to the given output.
  *
  * Valid code is code that can be passed to the simulation backend. Assertions
  * are removed.
  * @param parent The parent instruction.
  * @param allInstructions All instructions in the program.
- * @return The extracted valid code.
+ * @param output The string to append the extracted valid code to.
  */
-std::string validCodeFromChildren(const Instruction& parent,
-                                  std::vector<Instruction>& allInstructions) {
-  std::string code = parent.code;
+void appendValidCode(const Instruction& parent,
+                     const std::vector<Instruction>& allInstructions,
+                     std::string& output) {
+  output += parent.code;
   if (!parent.block.valid) {
-    return code;
+    return;
   }
-  code += " { ";
+  output += " { ";
   for (auto child : parent.childInstructions) {
     const auto& childInstruction = allInstructions[child];
     if (childInstruction.assertion != nullptr) {
       continue;
     }
-    code += validCodeFromChildren(childInstruction, allInstructions);
+    appendValidCode(childInstruction, allInstructions, output);
   }
-  code += " } ";
-  return code;
+  output += " } ";
 }
 
-std::string preprocessAssertionCode(const char* code,
-                                    DDSimulationState* ddsim) {
+std::string preprocessAssertionCode(const char* code, DDSimulationState* ddsim,
+                                    std::vector<Instruction>& instructions) {
 
-  auto instructions = preprocessCode(code, ddsim->processedCode);
-  std::vector<std::string> correctLines;
+  ddsim->symbols.clear();
+  instructions = preprocessCode(code, ddsim->processedCode, ddsim->symbols);
+  // All valid code is collected in a single buffer. It is at most slightly
+  // larger than the original code.
+  std::string result;
+  result.reserve(ddsim->processedCode.size());
   ddsim->instructionTypes.clear();
   ddsim->functionDefinitions.clear();
   ddsim->instructionStarts.clear();
@@ -1525,22 +2635,30 @@ std::string preprocessAssertionCode(const char* code,
   ddsim->callSubstitutions.clear();
   ddsim->classicalRegisters.clear();
   ddsim->qubitRegisters.clear();
+  ddsim->qubitRegisterIndices.clear();
   ddsim->successorInstructions.clear();
   ddsim->dataDependencies.clear();
   ddsim->functionCallers.clear();
   ddsim->targetQubits.clear();
+  ddsim->assertionTargets.clear();
+  ddsim->assertionInstructions.clear();
+
+  // All per-instruction tables are indexed by the instruction, so they can be
+  // sized once up front.
+  ddsim->instructionTypes.reserve(instructions.size());
+  ddsim->instructionStarts.reserve(instructions.size());
+  ddsim->instructionEnds.reserve(instructions.size());
+  ddsim->successorInstructions.reserve(instructions.size());
+  ddsim->functionDefinitions.assign(instructions.size(), false);
+  ddsim->assertionInstructions.resize(instructions.size());
 
   for (auto& instruction : instructions) {
-    ddsim->targetQubits.push_back(instruction.targets);
-    ddsim->successorInstructions.insert(
-        {instruction.lineNumber, instruction.successorIndex});
+    ddsim->targetQubits.addRow(instruction.targetReferences);
+    ddsim->successorInstructions.push_back(instruction.successorIndex);
     ddsim->instructionStarts.push_back(instruction.originalCodeStartPosition);
     ddsim->instructionEnds.push_back(instruction.originalCodeEndPosition);
-    ddsim->dataDependencies.insert({instruction.lineNumber, {}});
-    for (const auto& dependency : instruction.dataDependencies) {
-      ddsim->dataDependencies[instruction.lineNumber].emplace_back(
-          dependency.first, dependency.second);
-    }
+    ddsim->dataDependencies.addRow(instruction.dataDependencies.begin(),
+                                   instruction.dataDependencies.end());
     if (instruction.isFunctionCall) {
       const size_t successorInFunction = instruction.successorIndex;
       const size_t functionIndex = successorInFunction - 1;
@@ -1561,35 +2679,41 @@ std::string preprocessAssertionCode(const char* code,
     // - Instructions inside function definitions are not added to the final
     // code because they were already added when the function definition was
     // first encountered.
+    std::vector<VariableReference> assertionTargets;
     if (instruction.code == "RETURN") {
       ddsim->instructionTypes.push_back(RETURN);
     } else if (instruction.assertion != nullptr) {
       ddsim->instructionTypes.push_back(ASSERTION);
-      ddsim->assertionInstructions.insert(
-          {instruction.lineNumber, std::move(instruction.assertion)});
+      for (const auto& target : instruction.assertion->getTargetQubits()) {
+        assertionTargets.push_back(ddsim->symbols.parseVariable(target));
+      }
+      ddsim->assertionInstructions[instruction.lineNumber] =
+          std::move(instruction.assertion);
     } else if (instruction.isFunctionDefinition) {
       if (!instruction.inFunctionDefinition) {
-        correctLines.push_back(
-            validCodeFromChildren(instruction, instructions));
+        appendValidCode(instruction, instructions, result);
       }
-      ddsim->functionDefinitions.insert(instruction.lineNumber);
+      ddsim->functionDefinitions[instruction.lineNumber] = true;
       ddsim->instructionTypes.push_back(NOP);
     } else if (instruction.isFunctionCall) {
       if (!instruction.inFunctionDefinition) {
-        correctLines.push_back(instruction.code);
+        result += instruction.code;
       }
       ddsim->callSubstitutions.insert(
           {instruction.lineNumber, instruction.callSubstitution});
       ddsim->instructionTypes.push_back(CALL);
-    } else if (instruction.code.find("OPENQASM 2.0") != std::string::npos ||
-               instruction.code.find("OPENQASM 3.0") != std::string::npos ||
-               instruction.code.find("include") != std::string::npos) {
+    } else if (instruction.code.find("OPENQASM 2.0") !=
+                   std::string_view::npos ||
+               instruction.code.find("OPENQASM 3.0") !=
+                   std::string_view::npos ||
+               instruction.code.find("include") != std::string_view::npos) {
       if (!instruction.inFunctionDefinition) {
-        correctLines.push_back(instruction.code);
+        result += instruction.code;
       }
       ddsim->instructionTypes.push_back(NOP);
-    } else if (instruction.code.find("qreg") != std::string::npos) {
-      auto declaration = replaceString(instruction.code, "qreg", "");
+    } else if (instruction.code.find("qreg") != std::string_view::npos) {
+      auto declaration =
+          replaceString(std::string(instruction.code), "qreg", "");
       declaration = replaceString(declaration, " ", "");
       declaration = replaceString(declaration, "\n", "");
       declaration = replaceString(declaration, "\t", "");
@@ -1603,14 +2727,17 @@ std::string preprocessAssertionCode(const char* code,
                                : ddsim->qubitRegisters.back().index +
                                      ddsim->qubitRegisters.back().size;
       const QubitRegisterDefinition reg{name, index, size};
+      ddsim->qubitRegisterIndices.emplace(ddsim->symbols.intern(name),
+                                          ddsim->qubitRegisters.size());
       ddsim->qubitRegisters.push_back(reg);
 
       if (!instruction.inFunctionDefinition) {
-        correctLines.push_back(instruction.code);
+        result += instruction.code;
       }
       ddsim->instructionTypes.push_back(NOP);
-    } else if (instruction.code.find("creg") != std::string::npos) {
-      auto declaration = replaceString(instruction.code, "creg", "");
+    } else if (instruction.code.find("creg") != std::string_view::npos) {
+      auto declaration =
+          replaceString(std::string(instruction.code), "creg", "");
       declaration = replaceString(declaration, " ", "");
       declaration = replaceString(declaration, "\t", "");
       declaration = replaceString(declaration, ";", "");
@@ -1637,26 +2764,244 @@ std::string preprocessAssertionCode(const char* code,
       }
 
       if (!instruction.inFunctionDefinition) {
-        correctLines.push_back(instruction.code);
+        result += instruction.code;
       }
       ddsim->instructionTypes.push_back(NOP);
     } else {
       if (!instruction.inFunctionDefinition) {
-        correctLines.push_back(
-            validCodeFromChildren(instruction, instructions));
+        appendValidCode(instruction, instructions, result);
       }
       ddsim->instructionTypes.push_back(SIMULATE);
     }
+    ddsim->assertionTargets.addRow(assertionTargets);
   }
 
-  // Transform all the correct lines into a single code string.
-  const auto result = std::accumulate(
-      correctLines.begin(), correctLines.end(), std::string(),
-      [](const std::string& a, const std::string& b) { return a + b; });
+  // Breakpoints are looked up among the instructions outside of gate bodies
+  // first, so the bodies are skipped here.
+  ddsim->topLevelInstructions.clear();
+  for (size_t i = 0; i < instructions.size();
+       i = ddsim->functionDefinitions[i] ? ddsim->successorInstructions[i]
+                                         : i + 1) {
+    ddsim->topLevelInstructions.push_back(i);
+  }
+  ddsim->breakpoints.resize(instructions.size(), false);
 
   return result;
 }
 
+/**
+ * @brief Describes a standard gate that can be added to a quantum computation
+ * directly.
+ */
+struct DirectGate {
+  /**
+   * @brief The operation type of the gate.
+   */
+  qc::OpType type;
+  /**
+   * @brief The number of control qubits of the gate.
+   */
+  size_t numControls;
+  /**
+   * @brief The number of target qubits of the gate.
+   */
+  size_t numTargets;
+};
+
+/**
+ * @brief Get the parameter-free standard gate with the given name.
+ * @param name The name of the gate.
+ * @return A pointer to the gate, or `nullptr` if the gate cannot be added to a
+ * quantum computation directly.
+ */
+const DirectGate* findDirectGate(const std::string& name) {
+  static const std::unordered_map<std::string, DirectGate> gates{
+      {"id", {qc::I, 0, 1}},       {"x", {qc::X, 0, 1}},
+      {"y", {qc::Y, 0, 1}},        {"z", {qc::Z, 0, 1}},
+      {"h", {qc::H, 0, 1}},        {"s", {qc::S, 0, 1}},
+      {"sdg", {qc::Sdg, 0, 1}},    {"t", {qc::T, 0, 1}},
+      {"tdg", {qc::Tdg, 0, 1}},    {"sx", {qc::SX, 0, 1}},
+      {"sxdg", {qc::SXdg, 0, 1}},  {"swap", {qc::SWAP, 0, 2}},
+      {"cx", {qc::X, 1, 1}},       {"CX", {qc::X, 1, 1}},
+      {"cy", {qc::Y, 1, 1}},       {"cz", {qc::Z, 1, 1}},
+      {"ch", {qc::H, 1, 1}},       {"ccx", {qc::X, 2, 1}},
+      {"cswap", {qc::SWAP, 1, 2}},
+  };
+  const auto found = gates.find(name);
+  return found == gates.end() ? nullptr : &found->second;
+}
+
+/**
+ * @brief Resolve the classical bit targeted by a measurement.
+ * @param ddsim The simulation state.
+ * @param code The code of the measurement, such as `measure q[0] -> c[1];`.
+ * @return The index of the classical bit, or -1 if the measurement does not
+ * target a single valid classical bit.
+ */
+size_t getMeasuredBit(DDSimulationState* ddsim, const std::string& code) {
+  const auto arrow = code.find("->");
+  if (arrow == std::string::npos) {
+    return -1ULL;
+  }
+  const auto bit =
+      removeWhitespace(replaceString(code.substr(arrow + 2), ";", ""));
+  const auto open = bit.find('[');
+  if (open == std::string::npos || open == 0 || bit.back() != ']') {
+    return -1ULL;
+  }
+  const auto name = bit.substr(0, open);
+  const auto index = std::stoul(bit.substr(open + 1, bit.size() - open - 2));
+  for (const auto& reg : ddsim->classicalRegisters) {
+    if (reg.name == name) {
+      return index < reg.size ? reg.index + index : -1ULL;
+    }
+  }
+  return -1ULL;
+}
+
+/**
+ * @brief Add the operation of the given instruction to a quantum computation.
+ *
+ * Custom gate calls are expanded recursively. Their parameters are resolved
+ * using the call stack of `ddsim`.
+ * @param ddsim The simulation state.
+ * @param instructions The preprocessed instructions of the program.
+ * @param index The index of the instruction to add.
+ * @param qc The quantum computation to add the operation to.
+ * @return True if the operation was added, false if it is not supported.
+ */
+bool addDirectOperation(DDSimulationState* ddsim,
+                        const std::vector<Instruction>& instructions,
+                        size_t index, qc::QuantumComputation& qc) {
+  const auto& instruction = instructions[index];
+  const auto type = ddsim->instructionTypes[index];
+  if (type == ASSERTION) {
+    return true;
+  }
+  const auto code = trim(std::string(instruction.code));
+  // Parameters and classical conditions are left to the importer.
+  if (code.find('(') != std::string::npos) {
+    return false;
+  }
+  if (type == CALL) {
+    // Recursive custom gates cannot be expanded.
+    if (ddsim->callFrames.size() >= instructions.size()) {
+      return false;
+    }
+    const auto& definition = instructions[instruction.successorIndex - 1];
+    pushCallFrame(ddsim, index);
+    for (const auto child : definition.childInstructions) {
+      if (!addDirectOperation(ddsim, instructions, child, qc)) {
+        return false;
+      }
+    }
+    popCallFrame(ddsim);
+    return true;
+  }
+  if (type != SIMULATE) {
+    return false;
+  }
+
+  qc::Targets qubits;
+  for (const auto& target : ddsim->targetQubits[index]) {
+    const auto variable = resolveVariable(ddsim, target);
+    if (variable.isFullRegister()) {
+      return false;
+    }
+    const auto qubit =
+        static_cast<qc::Qubit>(globalVariableToQubit(ddsim, variable));
+    // Qubits have to be declared before they are used.
+    if (qubit >= qc.getNqubits() ||
+        std::find(qubits.begin(), qubits.end(), qubit) != qubits.end()) {
+      return false;
+    }
+    qubits.push_back(qubit);
+  }
+
+  const auto name = code.substr(0, code.find_first_of(" \t\r\n"));
+  if (name == "measure") {
+    const auto bit = getMeasuredBit(ddsim, code);
+    if (qubits.size() != 1 || bit >= qc.getNcbits()) {
+      return false;
+    }
+    qc.emplace_back<qc::NonUnitaryOperation>(qubits, std::vector<qc::Bit>{bit});
+    return true;
+  }
+  if (name == "reset") {
+    if (qubits.size() != 1) {
+      return false;
+    }
+    qc.emplace_back<qc::NonUnitaryOperation>(qubits, qc::Reset);
+    return true;
+  }
+  if (name == "barrier") {
+    // A barrier without targets applies to all qubits.
+    for (qc::Qubit qubit = 0; qubits.empty() && qubit < qc.getNqubits();
+         qubit++) {
+      qubits.push_back(qubit);
+    }
+    qc.emplace_back<qc::StandardOperation>(qubits, qc::Barrier);
+    return true;
+  }
+
+  const auto* gate = findDirectGate(name);
+  if (gate == nullptr ||
+      qubits.size() != gate->numControls + gate->numTargets) {
+    return false;
+  }
+  qc::Controls controls;
+  for (size_t i = 0; i < gate->numControls; i++) {
+    controls.insert(qc::Control{qubits[i]});
+  }
+  const qc::Targets targets(
+      qubits.begin() + static_cast<std::ptrdiff_t>(gate->numControls),
+      qubits.end());
+  qc.emplace_back<qc::StandardOperation>(controls, targets, gate->type);
+  return true;
+}
+
+bool buildQuantumComputation(DDSimulationState* ddsim,
+                             const std::vector<Instruction>& instructions,
+                             qc::QuantumComputation& qc) {
+  size_t nextQubitRegister = 0;
+  size_t nextClassicalRegister = 0;
+  bool supported = true;
+  try {
+    for (size_t i = 0; i < instructions.size() && supported; i++) {
+      const auto& instruction = instructions[i];
+      const auto& code = instruction.code;
+      if (instruction.inFunctionDefinition ||
+          instruction.isFunctionDefinition) {
+        continue;
+      }
+      if (ddsim->instructionTypes[i] != NOP) {
+        supported = addDirectOperation(ddsim, instructions, i, qc);
+      } else if (code.find("OPENQASM 2.0") != std::string_view::npos ||
+                 code.find("OPENQASM 3.0") != std::string_view::npos) {
+        continue;
+      } else if (code.find("include") != std::string_view::npos) {
+        supported = code.find("\"qelib1.inc\"") != std::string_view::npos ||
+                    code.find("\"stdgates.inc\"") != std::string_view::npos;
+      } else if (code.find("qreg") != std::string_view::npos) {
+        const auto& reg = ddsim->qubitRegisters[nextQubitRegister++];
+        qc.addQubitRegister(reg.size, reg.name);
+      } else if (code.find("creg") != std::string_view::npos) {
+        const auto& reg = ddsim->classicalRegisters[nextClassicalRegister++];
+        qc.addClassicalRegister(reg.size, reg.name);
+      }
+    }
+    // Registers declared inside custom gates would change the qubit indices.
+    supported = supported &&
+                nextQubitRegister == ddsim->qubitRegisters.size() &&
+                nextClassicalRegister == ddsim->classicalRegisters.size();
+  } catch (const std::exception&) {
+    // Invalid programs are reported by the importer instead.
+    supported = false;
+  }
+  clearCallFrames(ddsim);
+  return supported;
+}
+
 std::string getClassicalBitName(DDSimulationState* ddsim, size_t index) {
   for (auto& reg : ddsim->classicalRegisters) {
     if (index >= reg.index && index < reg.index + reg.size) {
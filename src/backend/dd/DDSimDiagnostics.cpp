@@ -8,6 +8,7 @@
 #include "backend/dd/DDSimDebug.hpp"
 #include "backend/diagnostics.h"
 #include "common.h"
+#include "common/QubitTupleTable.hpp"
 #include "common/Span.hpp"
 #include "common/parsing/AssertionParsing.hpp"
 
@@ -19,6 +20,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 /**
@@ -60,6 +62,9 @@ Result createDDDiagnostics(DDDiagnostics* self, DDSimulationState* state) {
   self->interface.getZeroControlInstructions =
       dddiagnosticsGetZeroControlInstructions;
   self->interface.potentialErrorCauses = dddiagnosticsPotentialErrorCauses;
+  self->interface.potentialErrorCausesAll =
+      dddiagnosticsPotentialErrorCausesAll;
+  self->interface.getStatistics = dddiagnosticsGetStatistics;
 
   return self->interface.init(&self->interface);
 }
@@ -85,7 +90,10 @@ Result dddiagnosticsInit(Diagnostics* self) {
   auto* ddd = toDDDiagnostics(self);
   ddd->zeroControls.clear();
   ddd->nonZeroControls.clear();
+  ddd->qubitTuples.clear();
   ddd->actualQubits.clear();
+  ddd->qubitUsageLog.clear();
+  ddd->failedAssertions.clear();
   return OK;
 }
 
@@ -121,21 +129,19 @@ void visitCall(DDSimulationState* ddsim, size_t current, size_t qubitIndex,
                std::set<size_t>& visited, std::set<size_t>& toVisit) {
   const auto gateStart = ddsim->successorInstructions[current];
   const auto gateDefinition = gateStart - 1;
-  const std::string stringToSearch =
-      ddsim->targetQubits[gateDefinition][qubitIndex];
+  const auto variableToSearch = ddsim->targetQubits[gateDefinition][qubitIndex];
   auto checkInstruction = findReturn(ddsim, gateStart);
   while (checkInstruction >= gateStart) {
+    const auto targets = ddsim->targetQubits[checkInstruction];
     const auto found =
-        std::find(ddsim->targetQubits[checkInstruction].begin(),
-                  ddsim->targetQubits[checkInstruction].end(), stringToSearch);
+        std::find(targets.begin(), targets.end(), variableToSearch);
     if (ddsim->instructionTypes[checkInstruction] != RETURN &&
-        found != ddsim->targetQubits[checkInstruction].end()) {
+        found != targets.end()) {
       if (visited.find(checkInstruction) == visited.end()) {
         toVisit.insert(checkInstruction);
       }
       if (ddsim->instructionTypes[checkInstruction] == CALL) {
-        const auto position =
-            std::distance(ddsim->targetQubits[checkInstruction].begin(), found);
+        const auto position = std::distance(targets.begin(), found);
         visitCall(ddsim, checkInstruction, static_cast<size_t>(position),
                   visited, toVisit);
       }
@@ -168,8 +174,7 @@ std::set<size_t> getUnknownCallers(DDSimulationState* ddsim,
 
   while (true) {
     instruction--;
-    if (ddsim->functionDefinitions.find(instruction) !=
-        ddsim->functionDefinitions.end()) {
+    if (ddsim->functionDefinitions[instruction]) {
       unknownCallers.insert(instruction);
       for (const auto caller : ddsim->functionCallers[instruction]) {
         if (visited.find(caller) == visited.end()) {
@@ -179,8 +184,7 @@ std::set<size_t> getUnknownCallers(DDSimulationState* ddsim,
     }
 
     if (instruction == 0 || ddsim->instructionTypes[instruction] == RETURN ||
-        ddsim->functionDefinitions.find(instruction) !=
-            ddsim->functionDefinitions.end()) {
+        ddsim->functionDefinitions[instruction]) {
       if (toVisit.empty()) {
         break;
       }
@@ -252,9 +256,7 @@ Result dddiagnosticsGetInteractions(Diagnostics* self, size_t beforeInstruction,
   while (found) {
     found = false;
     for (auto i = beforeInstruction - 1; i < beforeInstruction; i--) {
-      if (std::find(ddsim->functionDefinitions.begin(),
-                    ddsim->functionDefinitions.end(),
-                    i) != ddsim->functionDefinitions.end()) {
+      if (ddsim->functionDefinitions[i]) {
         break;
       }
       if (ddsim->instructionTypes[i] != SIMULATE &&
@@ -304,15 +306,186 @@ size_t dddiagnosticsPotentialErrorCauses(Diagnostics* self, ErrorCause* output,
   size_t index = 0;
 
   if (assertionInstruction->getType() == AssertionType::Entanglement) {
-    index +=
-        tryFindMissingInteraction(ddd, ddsim, assertion, assertionInstruction,
-                                  &outputs[index], count - index);
+    index += tryFindMissingInteraction(ddd, ddsim, assertion, &outputs[index],
+                                       count - index);
   }
   index += tryFindZeroControls(ddd, assertion, &outputs[index], count - index);
 
   return index;
 }
 
+/**
+ * @brief Find the representative of the set containing the given qubit.
+ *
+ * Used as part of a union-find structure that groups interacting qubits.
+ * @param parents The parent of each qubit in the union-find structure.
+ * @param qubit The qubit to find the representative for.
+ * @return The representative qubit of the set.
+ */
+size_t findInteractionRoot(std::vector<size_t>& parents, size_t qubit) {
+  while (parents[qubit] != qubit) {
+    parents[qubit] = parents[parents[qubit]];
+    qubit = parents[qubit];
+  }
+  return qubit;
+}
+
+size_t dddiagnosticsPotentialErrorCausesAll(Diagnostics* self,
+                                            ErrorCause* output, size_t count) {
+  auto* ddd = toDDDiagnostics(self);
+  auto* ddsim = ddd->simulationState;
+  auto outputs = Span(output, count);
+  if (count == 0 || ddd->failedAssertions.empty()) {
+    return 0;
+  }
+
+  // Failed assertions are analyzed in the order in which they occurred, so the
+  // interactions can be built up incrementally from the qubit usage log.
+  std::vector<size_t> order(ddd->failedAssertions.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [ddd](size_t a, size_t b) {
+    return ddd->failedAssertions[a].qubitUsageLogSize <
+           ddd->failedAssertions[b].qubitUsageLogSize;
+  });
+
+  const auto numQubits = dddiagnosticsGetNumQubits(self);
+  const auto instructionCount = dddiagnosticsGetInstructionCount(self);
+  std::vector<size_t> parents(numQubits);
+  for (size_t i = 0; i < numQubits; i++) {
+    parents[i] = i;
+  }
+  size_t processedLogEntries = 0;
+
+  // Zero-control causes only depend on the assertion instruction, so they are
+  // shared between all failures of the same assertion.
+  std::map<size_t, std::vector<ErrorCause>> zeroControlCauses;
+
+  // For each distinct cause: the call sites of the failures it explains and
+  // the order in which it was first found. A call site is the instruction of
+  // the failed assertion together with the call stack it failed in, so a
+  // failure is only counted once per call site.
+  using CallSite = std::pair<size_t, std::vector<size_t>>;
+  std::map<std::pair<ErrorCauseType, size_t>,
+           std::pair<std::set<CallSite>, size_t>>
+      causes;
+  const auto addCause = [&causes](ErrorCauseType type, size_t instruction,
+                                  const FailedAssertionRecord& failure) {
+    const auto key = std::make_pair(type, instruction);
+    auto found = causes.find(key);
+    if (found == causes.end()) {
+      found = causes.insert({key, {{}, causes.size()}}).first;
+    }
+    found->second.first.emplace(failure.instruction, failure.callStack);
+  };
+
+  for (const auto index : order) {
+    const auto& failure = ddd->failedAssertions[index];
+    while (processedLogEntries < failure.qubitUsageLogSize) {
+      const auto [instruction, tupleId] =
+          ddd->qubitUsageLog[processedLogEntries++];
+      if (instruction >= ddsim->instructionTypes.size() ||
+          ddsim->instructionTypes[instruction] != SIMULATE) {
+        continue;
+      }
+      size_t root = -1ULL;
+      for (const auto qubit : ddd->qubitTuples.get(tupleId)) {
+        if (qubit >= numQubits) {
+          continue;
+        }
+        const auto qubitRoot = findInteractionRoot(parents, qubit);
+        if (root == -1ULL) {
+          root = qubitRoot;
+        } else {
+          parents[qubitRoot] = root;
+        }
+      }
+    }
+
+    const auto& assertion = ddsim->assertionInstructions[failure.instruction];
+    if (assertion->getType() == AssertionType::Entanglement) {
+      const auto& targets = failure.targetQubits;
+      for (size_t i = 0; i < targets.size(); i++) {
+        for (size_t j = i + 1; j < targets.size(); j++) {
+          if (findInteractionRoot(parents, targets[i]) !=
+              findInteractionRoot(parents, targets[j])) {
+            addCause(ErrorCauseType::MissingInteraction, failure.instruction,
+                     failure);
+          }
+        }
+      }
+    }
+
+    if (zeroControlCauses.find(failure.instruction) ==
+        zeroControlCauses.end()) {
+      std::vector<ErrorCause> found(instructionCount);
+      found.resize(tryFindZeroControls(ddd, failure.instruction, found.data(),
+                                       found.size()));
+      zeroControlCauses.insert({failure.instruction, found});
+    }
+    for (const auto& cause : zeroControlCauses[failure.instruction]) {
+      addCause(cause.type, cause.instruction, failure);
+    }
+  }
+
+  std::vector<std::pair<std::pair<ErrorCauseType, size_t>,
+                        std::pair<size_t, size_t>>>
+      ranked;
+  for (const auto& [key, found] : causes) {
+    ranked.push_back({key, {found.first.size(), found.second}});
+  }
+  std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+    if (a.second.first != b.second.first) {
+      return a.second.first > b.second.first;
+    }
+    return a.second.second < b.second.second;
+  });
+
+  const auto resultCount = std::min(count, ranked.size());
+  for (size_t i = 0; i < resultCount; i++) {
+    outputs[i].type = ranked[i].first.first;
+    outputs[i].instruction = ranked[i].first.second;
+  }
+  return resultCount;
+}
+
+void dddiagnosticsOnAssertionFailed(DDDiagnostics* diagnostics,
+                                    size_t instruction) {
+  auto* ddsim = diagnostics->simulationState;
+  diagnostics->failedAssertions.push_back(
+      {instruction, ddsim->callReturnStack,
+       getAssertionQubits(ddsim, instruction),
+       diagnostics->qubitUsageLog.size()});
+}
+
+void dddiagnosticsClearFailedAssertions(DDDiagnostics* diagnostics) {
+  diagnostics->failedAssertions.clear();
+}
+
+void dddiagnosticsDiscardRuntimeData(DDDiagnostics* diagnostics,
+                                     size_t firstInstruction) {
+  const auto discarded = [firstInstruction](const auto& entry) {
+    return entry.first >= firstInstruction;
+  };
+  for (auto* controls :
+       {&diagnostics->zeroControls, &diagnostics->nonZeroControls}) {
+    controls->erase(controls->lower_bound(firstInstruction), controls->end());
+  }
+  if (diagnostics->actualQubits.size() > firstInstruction) {
+    diagnostics->actualQubits.resize(firstInstruction);
+  }
+  diagnostics->qubitUsageLog.erase(
+      std::remove_if(diagnostics->qubitUsageLog.begin(),
+                     diagnostics->qubitUsageLog.end(), discarded),
+      diagnostics->qubitUsageLog.end());
+  if (firstInstruction == 0) {
+    diagnostics->qubitTuples.clear();
+  }
+  // The records refer to positions in the usage log, which may have moved.
+  diagnostics->failedAssertions.clear();
+}
+
 /**
  * @brief Get interactions of the given qubit at runtime.
  *
@@ -335,12 +508,12 @@ std::set<size_t> getInteractionsAtRuntime(DDDiagnostics* ddd, size_t qubit) {
       if (ddsim->instructionTypes[i] != SIMULATE) {
         continue;
       }
-      if (ddd->actualQubits.find(i) == ddd->actualQubits.end()) {
-        continue;
+      if (i >= ddd->actualQubits.size()) {
+        break;
       }
 
-      auto& actualQubits = ddd->actualQubits[i];
-      for (const auto& actualQubitVector : actualQubits) {
+      for (const auto tupleId : ddd->actualQubits[i]) {
+        const auto actualQubitVector = ddd->qubitTuples.get(tupleId);
         if (!std::none_of(actualQubitVector.begin(), actualQubitVector.end(),
                           [&interactions](size_t elem) {
                             return interactions.find(elem) !=
@@ -362,32 +535,25 @@ std::set<size_t> getInteractionsAtRuntime(DDDiagnostics* ddd, size_t qubit) {
 
 size_t tryFindMissingInteraction(DDDiagnostics* diagnostics,
                                  DDSimulationState* state, size_t instruction,
-                                 const std::unique_ptr<Assertion>& assertion,
                                  ErrorCause* output, size_t count) {
   if (count == 0) {
     return 0;
   }
 
-  auto targets = assertion->getTargetQubits();
   auto outputs = Span(output, count);
-  std::vector<size_t> targetQubits(targets.size());
+  const auto targetQubits = getAssertionQubits(state, instruction);
   size_t index = 0;
 
-  std::transform(targets.begin(), targets.end(), targetQubits.begin(),
-                 [&state](const std::string& target) {
-                   return variableToQubit(state, target);
-                 });
-
   std::map<size_t, std::set<size_t>> allInteractions;
 
-  for (size_t i = 0; i < targets.size(); i++) {
+  for (size_t i = 0; i < targetQubits.size(); i++) {
     allInteractions.insert(
         {targetQubits[i],
          getInteractionsAtRuntime(diagnostics, targetQubits[i])});
   }
 
-  for (size_t i = 0; i < targets.size(); i++) {
-    for (size_t j = i + 1; j < targets.size(); j++) {
+  for (size_t i = 0; i < targetQubits.size(); i++) {
+    for (size_t j = i + 1; j < targetQubits.size(); j++) {
       if (allInteractions[targetQubits[i]].find(targetQubits[j]) ==
           allInteractions[targetQubits[i]].end()) {
         outputs[index].type = ErrorCauseType::MissingInteraction;
@@ -442,6 +608,26 @@ size_t tryFindZeroControls(DDDiagnostics* diagnostics, size_t instruction,
   return index;
 }
 
+Result dddiagnosticsGetStatistics(Diagnostics* self,
+                                  DiagnosticsStatistics* output) {
+  const auto* ddd = toDDDiagnostics(self);
+  size_t entries = 0;
+  size_t bytes = ddd->qubitTuples.memoryUsage() +
+                 (ddd->actualQubits.capacity() *
+                  sizeof(std::vector<QubitTupleTable::TupleId>)) +
+                 (ddd->qubitUsageLog.capacity() *
+                  sizeof(std::pair<size_t, QubitTupleTable::TupleId>));
+  for (const auto& usedTuples : ddd->actualQubits) {
+    entries += usedTuples.size();
+    bytes += usedTuples.capacity() * sizeof(QubitTupleTable::TupleId);
+  }
+
+  output->distinctQubitTuples = ddd->qubitTuples.size();
+  output->qubitUsageEntries = entries;
+  output->qubitUsageBytes = bytes;
+  return OK;
+}
+
 /**
  * @brief Check if the given qubit is always zero in the given statevector.
  *
@@ -496,14 +682,20 @@ void dddiagnosticsOnStepForward(DDDiagnostics* diagnostics,
       ddsim->instructionTypes[instruction] == CALL) {
     std::vector<size_t> targetQubits(targets.size());
     std::transform(targets.begin(), targets.end(), targetQubits.begin(),
-                   [&ddsim](const std::string& target) {
+                   [&ddsim](const VariableReference& target) {
                      return variableToQubit(ddsim, target);
                    });
-    if (diagnostics->actualQubits.find(instruction) ==
-        diagnostics->actualQubits.end()) {
-      diagnostics->actualQubits[instruction] = std::set<std::vector<size_t>>();
+    if (diagnostics->actualQubits.size() <= instruction) {
+      diagnostics->actualQubits.resize(ddsim->instructionTypes.size());
+    }
+    const auto tupleId = diagnostics->qubitTuples.intern(targetQubits);
+    auto& usedTuples = diagnostics->actualQubits[instruction];
+    const auto position =
+        std::lower_bound(usedTuples.begin(), usedTuples.end(), tupleId);
+    if (position == usedTuples.end() || *position != tupleId) {
+      usedTuples.insert(position, tupleId);
+      diagnostics->qubitUsageLog.emplace_back(instruction, tupleId);
     }
-    diagnostics->actualQubits[instruction].insert(targetQubits);
   }
 
   // Check for zero controls.
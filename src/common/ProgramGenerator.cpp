@@ -0,0 +1,260 @@
+/**
+ * @file ProgramGenerator.cpp
+ * @brief Implementation of the generator for large synthetic programs.
+ */
+
+#include "common/ProgramGenerator.hpp"
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Writes the instructions of a generated program, adding noise if
+ * requested.
+ */
+class ProgramWriter {
+public:
+  /**
+   * @brief Constructs a new writer.
+   * @param generatorOptions The options of the generated program.
+   */
+  explicit ProgramWriter(const ProgramGeneratorOptions& generatorOptions)
+      : options(generatorOptions), rng(generatorOptions.seed),
+        qubitDistribution(0, generatorOptions.numQubits - 1) {}
+
+  /**
+   * @brief Gets a random qubit index.
+   * @return The qubit index.
+   */
+  size_t qubit() { return qubitDistribution(rng); }
+
+  /**
+   * @brief Gets a random qubit index that differs from the given one.
+   * @param other The qubit index to avoid.
+   * @return The qubit index.
+   */
+  size_t otherQubit(size_t other) {
+    const auto result = qubit();
+    return result == other ? (other + 1) % options.numQubits : result;
+  }
+
+  /**
+   * @brief Gets a random index.
+   * @param count The number of possible indices.
+   * @return An index between 0 and `count - 1`.
+   */
+  size_t index(size_t count) {
+    return std::uniform_int_distribution<size_t>(0, count - 1)(rng);
+  }
+
+  /**
+   * @brief Gets a random number between 0 and 1.
+   * @return The random number.
+   */
+  double probability() { return probabilityDistribution(rng); }
+
+  /**
+   * @brief Writes a single instruction, surrounded by noise with the
+   * configured probability.
+   * @param instruction The instruction, which may contain `, ` separators
+   * that are replaced by irregular whitespace when adding noise.
+   * @param indent The indentation of the instruction.
+   */
+  void write(const std::string& instruction, const std::string& indent = "") {
+    if (probability() >= options.noiseDensity) {
+      ss << indent << instruction << "\n";
+      return;
+    }
+    switch (index(4)) {
+    case 0:
+      ss << indent << "// generated comment " << comments++ << "\n";
+      ss << indent << instruction << "\n";
+      break;
+    case 1:
+      ss << "\n\n" << indent << instruction << "\n";
+      break;
+    case 2:
+      ss << indent << instruction << " // trailing comment " << comments++
+         << "\n";
+      break;
+    default:
+      ss << indent << "  \t" << withIrregularSpacing(instruction) << "  \n";
+      break;
+    }
+  }
+
+  /**
+   * @brief Gets the code written so far.
+   * @return The code.
+   */
+  [[nodiscard]] std::string str() const { return ss.str(); }
+
+private:
+  /**
+   * @brief Replace the separators of an instruction by irregular whitespace.
+   * @param instruction The instruction.
+   * @return The instruction with irregular whitespace.
+   */
+  static std::string withIrregularSpacing(const std::string& instruction) {
+    std::string result;
+    for (size_t i = 0; i < instruction.size(); i++) {
+      if (instruction[i] == ',' && i + 1 < instruction.size() &&
+          instruction[i + 1] == ' ') {
+        result += " ,\t";
+        i++;
+      } else {
+        result += instruction[i];
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief The options of the generated program.
+   */
+  const ProgramGeneratorOptions& options;
+  /**
+   * @brief The random number generator.
+   */
+  std::mt19937 rng;
+  /**
+   * @brief The distribution of qubit indices.
+   */
+  std::uniform_int_distribution<size_t> qubitDistribution;
+  /**
+   * @brief The distribution of probabilities.
+   */
+  std::uniform_real_distribution<double> probabilityDistribution{0, 1};
+  /**
+   * @brief The stream the code is written to.
+   */
+  std::ostringstream ss;
+  /**
+   * @brief The number of comments written so far.
+   */
+  size_t comments = 0;
+};
+
+/**
+ * @brief Gets the name of the custom gate at the given nesting level.
+ * @param level The nesting level.
+ * @return The name of the custom gate.
+ */
+std::string gateName(size_t level) { return "g" + std::to_string(level); }
+
+/**
+ * @brief Gets the qubit with the given index as a variable reference.
+ * @param index The index of the qubit.
+ * @return The variable reference, such as `q[0]`.
+ */
+std::string qubitName(size_t index) {
+  return "q[" + std::to_string(index) + "]";
+}
+
+} // namespace
+
+std::string generateProgram(const ProgramGeneratorOptions& options) {
+  if (options.numQubits < 2) {
+    throw std::invalid_argument("Programs require at least two qubits");
+  }
+  const std::array<double, 7> densities{
+      options.entanglementAssertionDensity,
+      options.superpositionAssertionDensity,
+      options.statevectorEqualityAssertionDensity,
+      options.circuitEqualityAssertionDensity,
+      options.measurementDensity,
+      options.classicControlDensity,
+      options.nestingDepth > 0 ? options.callDensity : 0};
+  double totalDensity = 0;
+  for (const auto density : densities) {
+    if (density < 0) {
+      throw std::invalid_argument("Densities must not be negative");
+    }
+    totalDensity += density;
+  }
+  if (totalDensity > 1) {
+    throw std::invalid_argument("The sum of all densities must not exceed 1");
+  }
+
+  ProgramWriter writer(options);
+  writer.write("qreg q[" + std::to_string(options.numQubits) + "];");
+  writer.write("creg c[" + std::to_string(options.numQubits) + "];");
+
+  for (size_t level = 0; level < options.nestingDepth; level++) {
+    writer.write("gate " + gateName(level) + " a, b {");
+    if (level == 0) {
+      writer.write("h a;", "  ");
+      writer.write("cx a, b;", "  ");
+      writer.write("t b;", "  ");
+    } else {
+      for (size_t call = 0; call < options.callFanOut; call++) {
+        const auto* const arguments = call % 2 == 0 ? " a, b;" : " b, a;";
+        writer.write(gateName(level - 1) + arguments, "  ");
+        writer.write("s a;", "  ");
+      }
+    }
+    writer.write("}");
+  }
+
+  static constexpr std::array<const char*, 4> SINGLE_QUBIT_GATES{"h", "s", "t",
+                                                                 "x"};
+  for (size_t i = 0; i < options.numInstructions; i++) {
+    const auto first = writer.qubit();
+    const auto second = writer.otherQubit(first);
+    auto kind = densities.size();
+    auto threshold = writer.probability();
+    for (size_t k = 0; k < densities.size(); k++) {
+      if (threshold < densities.at(k)) {
+        kind = k;
+        break;
+      }
+      threshold -= densities.at(k);
+    }
+
+    switch (kind) {
+    case 0:
+      writer.write("assert-ent " + qubitName(first) + ", " +
+                   qubitName(second) + ";");
+      break;
+    case 1:
+      writer.write("assert-sup " + qubitName(first) + ";");
+      break;
+    case 2:
+      writer.write("assert-eq 0.9, " + qubitName(first) +
+                   " { 0.707, 0.707 }");
+      break;
+    case 3:
+      writer.write("assert-eq 0.9, " + qubitName(first) +
+                   " { qreg q[1]; h q[0]; }");
+      break;
+    case 4:
+      writer.write("measure " + qubitName(first) + " -> c[" +
+                   std::to_string(first) + "];");
+      break;
+    case 5:
+      writer.write("if(c==1) x " + qubitName(first) + ";");
+      break;
+    case 6:
+      writer.write(gateName(options.nestingDepth - 1) + " " +
+                   qubitName(first) + ", " + qubitName(second) + ";");
+      break;
+    default: {
+      const auto gate = writer.index(SINGLE_QUBIT_GATES.size() + 1);
+      if (gate == SINGLE_QUBIT_GATES.size()) {
+        writer.write("cx " + qubitName(first) + ", " + qubitName(second) +
+                     ";");
+      } else {
+        writer.write(std::string(SINGLE_QUBIT_GATES.at(gate)) + " " +
+                     qubitName(first) + ";");
+      }
+    }
+    }
+  }
+  return writer.str();
+}
@@ -0,0 +1,67 @@
+/**
+ * @file QubitTupleTable.cpp
+ * @brief Implementation of the table for interning tuples of qubit indices.
+ */
+
+#include "common/QubitTupleTable.hpp"
+
+#include "common/Span.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+QubitTupleTable::TupleId
+QubitTupleTable::intern(const std::vector<size_t>& qubits) {
+  const auto hash = hashTuple(qubits);
+  const auto [begin, end] = lookup.equal_range(hash);
+  for (auto it = begin; it != end; ++it) {
+    const auto start = offsets[it->second];
+    const auto length = offsets[it->second + 1] - start;
+    if (length == qubits.size() &&
+        std::equal(qubits.begin(), qubits.end(),
+                   storage.begin() + static_cast<std::ptrdiff_t>(start))) {
+      return it->second;
+    }
+  }
+
+  const auto id = static_cast<TupleId>(offsets.size() - 1);
+  storage.insert(storage.end(), qubits.begin(), qubits.end());
+  offsets.push_back(storage.size());
+  lookup.emplace(hash, id);
+  return id;
+}
+
+Span<const size_t> QubitTupleTable::get(TupleId id) const {
+  const auto start = offsets[id];
+  return {storage.data() + start, offsets[id + 1] - start};
+}
+
+size_t QubitTupleTable::size() const { return offsets.size() - 1; }
+
+size_t QubitTupleTable::memoryUsage() const {
+  // Each entry of the lookup table is a separate node holding the key, the
+  // value and a pointer to the next node, plus one bucket pointer.
+  const auto lookupNodeSize =
+      sizeof(size_t) + sizeof(TupleId) + 2 * sizeof(void*);
+  return (storage.capacity() * sizeof(size_t)) +
+         (offsets.capacity() * sizeof(size_t)) +
+         (lookup.size() * lookupNodeSize) +
+         (lookup.bucket_count() * sizeof(void*));
+}
+
+void QubitTupleTable::clear() {
+  storage.clear();
+  offsets.assign(1, 0);
+  lookup.clear();
+}
+
+size_t QubitTupleTable::hashTuple(const std::vector<size_t>& qubits) {
+  size_t hash = qubits.size();
+  for (const auto qubit : qubits) {
+    hash ^= std::hash<size_t>{}(qubit) + 0x9e3779b97f4a7c15ULL + (hash << 6) +
+            (hash >> 2);
+  }
+  return hash;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file SymbolTable.cpp
+ * @brief Implementation of the table for interning names.
+ */
+
+#include "common/SymbolTable.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <string>
+
+SymbolId SymbolTable::intern(const std::string& name) {
+  const auto found = ids.find(name);
+  if (found != ids.end()) {
+    return found->second;
+  }
+  const auto id = static_cast<SymbolId>(names.size());
+  names.push_back(name);
+  ids.emplace(name, id);
+  return id;
+}
+
+const std::string& SymbolTable::getName(SymbolId id) const {
+  return names[id];
+}
+
+VariableReference SymbolTable::parseVariable(const std::string& variable) {
+  const auto open = variable.find('[');
+  if (open == std::string::npos || open == 0 || variable.back() != ']' ||
+      variable.size() - open < 3) {
+    return {intern(variable), VariableReference::FULL_REGISTER};
+  }
+  const auto begin = variable.begin() + static_cast<std::ptrdiff_t>(open) + 1;
+  const auto end = variable.end() - 1;
+  // Indices with more digits might not fit into `size_t`.
+  constexpr std::ptrdiff_t maxDigits = 18;
+  if (end - begin > maxDigits || !std::all_of(begin, end, [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c)) != 0;
+      })) {
+    return {intern(variable), VariableReference::FULL_REGISTER};
+  }
+  return {intern(variable.substr(0, open)),
+          std::stoul(std::string(begin, end))};
+}
+
+std::string SymbolTable::toString(const VariableReference& variable) const {
+  if (variable.isFullRegister()) {
+    return getName(variable.symbol);
+  }
+  return getName(variable.symbol) + "[" + std::to_string(variable.index) + "]";
+}
+
+size_t SymbolTable::size() const { return names.size(); }
+
+void SymbolTable::clear() {
+  names.clear();
+  ids.clear();
+}
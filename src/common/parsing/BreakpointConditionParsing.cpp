@@ -0,0 +1,193 @@
+/**
+ * @file BreakpointConditionParsing.cpp
+ * @brief Implementation of the parsing functions for breakpoint conditions.
+ */
+
+#include "common/parsing/BreakpointConditionParsing.hpp"
+
+#include "common/parsing/ParsingError.hpp"
+#include "common/parsing/Utils.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+/**
+ * @brief Check whether the given string is a valid identifier.
+ * @param name The string to check.
+ * @return True if the string is a valid identifier, false otherwise.
+ */
+bool isIdentifier(const std::string& name) {
+  if (name.empty() ||
+      (std::isalpha(static_cast<unsigned char>(name[0])) == 0 &&
+       name[0] != '_')) {
+    return false;
+  }
+  return std::all_of(name.begin(), name.end(), [](char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_';
+  });
+}
+
+/**
+ * @brief Check whether the given string refers to a single index of a
+ * register, such as `q[0]`.
+ * @param variable The string to check.
+ * @return True if the string refers to a single index, false otherwise.
+ */
+bool isIndexedVariable(const std::string& variable) {
+  const auto open = variable.find('[');
+  if (open == std::string::npos || variable.back() != ']' ||
+      open + 2 >= variable.size()) {
+    return false;
+  }
+  const auto index = variable.substr(open + 1, variable.size() - open - 2);
+  return isIdentifier(variable.substr(0, open)) &&
+         std::all_of(index.begin(), index.end(), [](char c) {
+           return std::isdigit(static_cast<unsigned char>(c)) != 0;
+         });
+}
+
+/**
+ * @brief Find the first comparison operator in an expression.
+ * @param expression The expression to search.
+ * @param length A reference to store the number of characters of the operator.
+ * @return A pair of the operator's position and the operator.
+ * @throws ParsingError If the expression does not contain a valid operator.
+ */
+std::pair<size_t, ComparisonOperator>
+findComparisonOperator(const std::string& expression, size_t& length) {
+  const auto position = expression.find_first_of("=!<>%");
+  if (position == std::string::npos) {
+    throw ParsingError("Missing comparison operator in condition `" +
+                       expression + "`");
+  }
+  const auto first = expression[position];
+  const auto followedByEqual = position + 1 < expression.size() &&
+                               expression[position + 1] == '=';
+  length = followedByEqual ? 2 : 1;
+  switch (first) {
+  case '=':
+    if (followedByEqual) {
+      return {position, ComparisonOperator::Equal};
+    }
+    break;
+  case '!':
+    if (followedByEqual) {
+      return {position, ComparisonOperator::NotEqual};
+    }
+    break;
+  case '<':
+    return {position, followedByEqual ? ComparisonOperator::LessEqual
+                                      : ComparisonOperator::Less};
+  case '>':
+    return {position, followedByEqual ? ComparisonOperator::GreaterEqual
+                                      : ComparisonOperator::Greater};
+  default:
+    if (!followedByEqual) {
+      return {position, ComparisonOperator::Multiple};
+    }
+    break;
+  }
+  throw ParsingError("Invalid comparison operator in condition `" +
+                     expression + "`");
+}
+
+/**
+ * @brief Parse a number on the right-hand side of a condition.
+ * @param text The text to parse.
+ * @return The parsed number.
+ * @throws ParsingError If the text is not a number.
+ */
+double parseConditionValue(const std::string& text) {
+  try {
+    size_t parsed = 0;
+    const auto value = std::stod(text, &parsed);
+    if (parsed == text.size() && std::isfinite(value)) {
+      return value;
+    }
+  } catch (const std::logic_error&) {
+    // Handled below.
+  }
+  throw ParsingError("Invalid value `" + text + "` in condition");
+}
+
+BreakpointCondition parseBreakpointCondition(const std::string& condition) {
+  const auto expression = removeWhitespace(condition);
+  size_t length = 0;
+  const auto [position, comparison] =
+      findComparisonOperator(expression, length);
+  if (comparison == ComparisonOperator::Multiple) {
+    throw ParsingError("The operator `%` is only supported in hit conditions");
+  }
+
+  BreakpointCondition result{ConditionTarget::ClassicalRegister,
+                             expression.substr(0, position), comparison,
+                             parseConditionValue(expression.substr(
+                                 position + length))};
+  auto& variable = result.variable;
+  if (variable.size() > 3 && variable.rfind("P(", 0) == 0 &&
+      variable.back() == ')') {
+    result.target = ConditionTarget::QubitProbability;
+    variable = variable.substr(2, variable.size() - 3);
+    if (!isIndexedVariable(variable)) {
+      throw ParsingError("Probabilities can only be computed for single "
+                         "qubits, such as `P(q[0])`");
+    }
+  } else if (isIndexedVariable(variable)) {
+    result.target = ConditionTarget::ClassicalBit;
+  } else if (!isIdentifier(variable)) {
+    throw ParsingError("Invalid variable `" + variable + "` in condition");
+  }
+  return result;
+}
+
+HitCondition parseHitCondition(const std::string& hitCondition) {
+  auto expression = removeWhitespace(hitCondition);
+  HitCondition result{ComparisonOperator::Equal, 0};
+  if (!expression.empty() &&
+      std::string("=!<>%").find(expression[0]) != std::string::npos) {
+    size_t length = 0;
+    result.comparison = findComparisonOperator(expression, length).second;
+    expression = expression.substr(length);
+  }
+  if (expression.empty() ||
+      !std::all_of(expression.begin(), expression.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c)) != 0;
+      })) {
+    throw ParsingError("Invalid hit condition `" + hitCondition + "`");
+  }
+  try {
+    result.count = std::stoul(expression);
+  } catch (const std::out_of_range&) {
+    throw ParsingError("Invalid hit condition `" + hitCondition + "`");
+  }
+  if (result.comparison == ComparisonOperator::Multiple && result.count == 0) {
+    throw ParsingError("The hit count cannot be a multiple of 0");
+  }
+  return result;
+}
+
+bool compareValues(ComparisonOperator comparison, double lhs, double rhs) {
+  constexpr double tolerance = 1e-9;
+  switch (comparison) {
+  case ComparisonOperator::Equal:
+    return std::abs(lhs - rhs) < tolerance;
+  case ComparisonOperator::NotEqual:
+    return std::abs(lhs - rhs) >= tolerance;
+  case ComparisonOperator::Less:
+    return lhs < rhs;
+  case ComparisonOperator::LessEqual:
+    return lhs <= rhs;
+  case ComparisonOperator::Greater:
+    return lhs > rhs;
+  case ComparisonOperator::GreaterEqual:
+    return lhs >= rhs;
+  case ComparisonOperator::Multiple:
+    return rhs > 0 && std::fmod(lhs, rhs) == 0;
+  }
+  return false;
+}
@@ -5,224 +5,410 @@
 
 #include "common/parsing/CodePreprocessing.hpp"
 
+#include "common/Span.hpp"
+#include "common/SymbolTable.hpp"
 #include "common/parsing/AssertionParsing.hpp"
+#include "common/parsing/Lexer.hpp"
 #include "common/parsing/ParsingError.hpp"
-#include "common/parsing/Utils.hpp"
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
-Instruction::Instruction(size_t inputLineNumber, std::string inputCode,
+Instruction::Instruction(size_t inputLineNumber, std::string_view inputCode,
                          std::unique_ptr<Assertion>& inputAssertion,
                          std::vector<std::string> inputTargets, size_t startPos,
                          size_t endPos, size_t successor, bool isFuncCall,
-                         std::string function, bool inFuncDef, bool isFuncDef,
-                         Block inputBlock)
-    : lineNumber(inputLineNumber), code(std::move(inputCode)),
+                         std::string_view function, bool inFuncDef,
+                         bool isFuncDef, Block inputBlock)
+    : lineNumber(inputLineNumber), code(inputCode),
       assertion(std::move(inputAssertion)), targets(std::move(inputTargets)),
       originalCodeStartPosition(startPos), originalCodeEndPosition(endPos),
       successorIndex(successor), isFunctionCall(isFuncCall),
-      calledFunction(std::move(function)), inFunctionDefinition(inFuncDef),
-      isFunctionDefinition(isFuncDef), block(std::move(inputBlock)) {}
+      calledFunction(function), inFunctionDefinition(inFuncDef),
+      isFunctionDefinition(isFuncDef), block(inputBlock) {}
 
 /**
- * @brief Sweep a given code string for blocks and replace them with a unique
- * identifier.
- * @param code The code to sweep.
- * @param blocks A map to store the blocks and their respective identifiers in.
- * @return The code with the blocks replaced by their identifiers.
+ * @brief The tokens of a single instruction and its optional block.
  */
-std::string sweepBlocks(const std::string& code,
-                        std::map<std::string, std::string>& blocks) {
-  std::string result = code;
-  size_t start = 0;
-  int level = 0;
-  size_t pos = 0;
-  while (pos < result.size()) {
-    auto c = result[pos];
-    if (c == '{') {
-      if (level == 0) {
-        start = pos;
+struct InstructionTokens {
+  /**
+   * @brief The position in the code from which the instruction starts.
+   *
+   * This includes all whitespace and comments preceding the instruction.
+   */
+  size_t start;
+  /**
+   * @brief The position of the `;` or `}` terminating the instruction.
+   */
+  size_t end;
+  /**
+   * @brief The tokens of the instruction, excluding its terminator and block.
+   */
+  Span<const Token> tokens;
+  /**
+   * @brief Indicates whether the instruction is followed by a block.
+   */
+  bool hasBlock;
+  /**
+   * @brief The position in the code after the `{` opening the block.
+   */
+  size_t blockStart;
+  /**
+   * @brief The tokens inside the block, excluding the curly braces.
+   */
+  Span<const Token> blockTokens;
+};
+
+/**
+ * @brief Get a span of the tokens with indices in the range `[first, last)`.
+ * @param tokens The tokens to get the span from.
+ * @param first The index of the first token in the span.
+ * @param last The index after the last token in the span.
+ * @return The span of the tokens.
+ */
+Span<const Token> subSpan(const Span<const Token>& tokens, size_t first,
+                          size_t last) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return {tokens.data() + first, last - first};
+}
+
+/**
+ * @brief Split a given token stream into instructions.
+ *
+ * Instructions are terminated either by a `;` or by a block in curly braces.
+ * @param tokens The tokens to split, not containing any comments.
+ * @param start The position in the code from which the first instruction
+ * starts.
+ * @return The tokens of each instruction.
+ */
+std::vector<InstructionTokens>
+splitInstructions(const Span<const Token>& tokens, size_t start) {
+  std::vector<InstructionTokens> instructions;
+  size_t first = 0;
+  size_t index = 0;
+  while (index < tokens.size()) {
+    const auto& token = tokens[index];
+    if (token.type == TokenType::RightBrace) {
+      throw ParsingError("Unmatched '}' in code");
+    }
+    if (token.type == TokenType::Semicolon) {
+      instructions.push_back({start, token.start,
+                              subSpan(tokens, first, index), false, 0,
+                              subSpan(tokens, index, index)});
+    } else if (token.type == TokenType::LeftBrace) {
+      size_t level = 1;
+      size_t closing = index + 1;
+      for (; closing < tokens.size(); closing++) {
+        if (tokens[closing].type == TokenType::LeftBrace) {
+          level++;
+        } else if (tokens[closing].type == TokenType::RightBrace) {
+          level--;
+          if (level == 0) {
+            break;
+          }
+        }
       }
-      level++;
-    } else if (c == '}') {
-      level--;
-      if (level == 0) {
-        const std::string block = result.substr(start + 1, pos - 1 - start);
-        const std::string blockName =
-            "$__block" + std::to_string(blocks.size()) + "$;";
-        blocks[blockName] = block;
-        result.replace(start, pos + 1 - start, blockName);
-        pos = start;
+      if (level != 0) {
+        throw ParsingError("Unmatched '{' in code");
       }
+      instructions.push_back({start, tokens[closing].start,
+                              subSpan(tokens, first, index), true, token.end,
+                              subSpan(tokens, index + 1, closing)});
+      index = closing;
+    } else {
+      index++;
+      continue;
     }
-    pos++;
+    start = tokens[index].end;
+    index++;
+    first = index;
+  }
+  return instructions;
+}
+
+/**
+ * @brief Get the text of the tokens in a given span without the whitespace
+ * between them.
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens to get the text of.
+ * @param first The index of the first token.
+ * @param last The index after the last token.
+ * @return The text of the tokens.
+ */
+std::string tokenText(const std::string& code, const Span<const Token>& tokens,
+                      size_t first, size_t last) {
+  std::string text;
+  for (size_t i = first; i < last; i++) {
+    text.append(code, tokens[i].start, tokens[i].end - tokens[i].start);
   }
-  return result;
+  return text;
+}
+
+/**
+ * @brief Check if a given token is a word with the given text.
+ * @param code The code the token was taken from.
+ * @param token The token to check.
+ * @param keyword The text to compare the token to.
+ * @return True if the token is a word with the given text, false otherwise.
+ */
+bool isKeyword(const std::string& code, const Token& token,
+               const std::string& keyword) {
+  return token.type == TokenType::Word &&
+         token.end - token.start == keyword.size() &&
+         code.compare(token.start, keyword.size(), keyword) == 0;
+}
+
+/**
+ * @brief Check if the given tokens start with a keyword followed by whitespace.
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens to check.
+ * @param keyword The keyword to check for.
+ * @return True if the tokens start with the keyword, false otherwise.
+ */
+bool startsWithKeyword(const std::string& code, const Span<const Token>& tokens,
+                       const std::string& keyword) {
+  return tokens.size() > 1 && isKeyword(code, tokens[0], keyword) &&
+         tokens[1].start != tokens[0].end;
 }
 
 /**
- * @brief Sweep a given code string for comments and replace them with
- * whitespace.
- * @param code The code to sweep.
- * @return The code with the comments replaced by whitespace.
+ * @brief Skip the head of an instruction, i.e., the gate name and its
+ * parameters.
+ *
+ * The head consists of all tokens up to the first whitespace that is not
+ * located inside parentheses.
+ * @param tokens The tokens of the instruction.
+ * @param first The index of the first token of the head.
+ * @return The index of the first token after the head.
  */
-std::string removeComments(const std::string& code) {
-  std::string result = code;
-  for (size_t pos = 0; pos < result.size(); pos++) {
-    auto nextComment = result.find("//", pos);
-    if (nextComment == std::string::npos) {
+size_t skipInstructionHead(const Span<const Token>& tokens, size_t first) {
+  int64_t openBrackets = 0;
+  size_t index = first;
+  while (index < tokens.size()) {
+    if (tokens[index].type == TokenType::LeftParen) {
+      openBrackets++;
+    } else if (tokens[index].type == TokenType::RightParen) {
+      openBrackets--;
+    }
+    index++;
+    const auto partEnds = index == tokens.size() ||
+                          tokens[index].start != tokens[index - 1].end;
+    if (partEnds && openBrackets == 0) {
       break;
     }
-    auto commentEnd = result.find('\n', nextComment);
-    if (commentEnd == std::string::npos) {
-      commentEnd = result.size();
+  }
+  return index;
+}
+
+/**
+ * @brief Split the given tokens into comma-separated arguments.
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens to split.
+ * @param first The index of the first token of the arguments.
+ * @return The arguments without whitespace.
+ */
+std::vector<std::string> splitArguments(const std::string& code,
+                                        const Span<const Token>& tokens,
+                                        size_t first) {
+  if (first >= tokens.size()) {
+    return {};
+  }
+  std::vector<std::string> arguments;
+  size_t argumentStart = first;
+  for (size_t i = first; i < tokens.size(); i++) {
+    if (tokens[i].type == TokenType::Comma) {
+      arguments.push_back(tokenText(code, tokens, argumentStart, i));
+      argumentStart = i + 1;
     }
-    const std::string spaces(commentEnd - nextComment, ' ');
-    result.replace(nextComment, commentEnd - nextComment, spaces);
   }
-  return result;
+  arguments.push_back(tokenText(code, tokens, argumentStart, tokens.size()));
+  return arguments;
 }
 
 /**
- * @brief Check if a given line is a function definition.
+ * @brief Check if a given instruction is a function definition.
  *
  * This is done by checking if it starts with `gate `.
- * @param line The line to check.
- * @return True if the line is a function definition, false otherwise.
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens of the instruction.
+ * @return True if the instruction is a function definition, false otherwise.
  */
-bool isFunctionDefinition(const std::string& line) {
-  return startsWith(trim(line), "gate ");
+bool isFunctionDefinition(const std::string& code,
+                          const Span<const Token>& tokens) {
+  return startsWithKeyword(code, tokens, "gate");
 }
 
 /**
- * @brief Check if a given line is a classic controlled gate.
+ * @brief Check if a given instruction is a classic controlled gate.
  *
  * This is done by checking if it starts with `if` and contains parentheses.
- * @param line The line to check.
- * @return True if the line is a classic controlled gate, false otherwise.
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens of the instruction.
+ * @return True if the instruction is a classic controlled gate, false
+ * otherwise.
  */
-bool isClassicControlledGate(const std::string& line) {
-  return startsWith(trim(line), "if") &&
-         (line.find('(') != std::string::npos) &&
-         (line.find(')') != std::string::npos);
+bool isClassicControlledGate(const std::string& code,
+                             const Span<const Token>& tokens) {
+  if (tokens.size() == 0 || !isKeyword(code, tokens[0], "if")) {
+    return false;
+  }
+  const auto hasToken = [&tokens](TokenType type) {
+    return std::any_of(tokens.begin(), tokens.end(),
+                       [type](const Token& t) { return t.type == type; });
+  };
+  return hasToken(TokenType::LeftParen) && hasToken(TokenType::RightParen);
 }
 
 /**
- * @brief Check if a given line is a variable declaration.
+ * @brief Check if a given instruction is a variable declaration.
  *
- * This is done by checking if it contains `creg ` or `qreg `.
- * @param line The line to check.
- * @return True if the line is a variable declaration, false otherwise.
+ * This is done by checking if it starts with `creg ` or `qreg `.
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens of the instruction.
+ * @return True if the instruction is a variable declaration, false otherwise.
  */
-bool isVariableDeclaration(const std::string& line) {
-  return startsWith(trim(line), "creg ") || startsWith(trim(line), "qreg ");
+bool isVariableDeclaration(const std::string& code,
+                           const Span<const Token>& tokens) {
+  return startsWithKeyword(code, tokens, "creg") ||
+         startsWithKeyword(code, tokens, "qreg");
 }
 
 /**
- * @brief Parse a function definition from a given signature.
- * @param signature The signature to parse.
- * @return The parsed function definition.
+ * @brief Parse the name and size of the register declared by a given
+ * instruction.
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens of the variable declaration.
+ * @return The name and size of the declared register.
  */
-FunctionDefinition parseFunctionDefinition(const std::string& signature) {
-  auto parts = splitString(
-      replaceString(replaceString(signature, "\n", " "), "\t", " "), ' ');
-  std::string name;
-  size_t index = 0;
-  for (auto& part : parts) {
-    index++;
-    if (part != "gate" && !part.empty()) {
-      name = part;
-      break;
-    }
+std::pair<std::string, size_t>
+parseVariableDeclaration(const std::string& code,
+                         const Span<const Token>& tokens) {
+  const auto* const open =
+      std::find_if(tokens.begin(), tokens.end(), [](const Token& t) {
+        return t.type == TokenType::LeftBracket;
+      });
+  const auto* const close =
+      std::find_if(open, tokens.end(), [](const Token& t) {
+        return t.type == TokenType::RightBracket;
+      });
+  if (close == tokens.end()) {
+    throw ParsingError("Register declarations require a size");
   }
+  const auto openIndex = static_cast<size_t>(open - tokens.begin());
+  const auto closeIndex = static_cast<size_t>(close - tokens.begin());
+  const auto name = tokenText(code, tokens, 1, openIndex);
+  const auto size = std::stoi(tokenText(code, tokens, openIndex + 1,
+                                        closeIndex));
+  return {name, static_cast<size_t>(size)};
+}
 
-  std::string parameterParts;
-  for (size_t i = index; i < parts.size(); i++) {
-    parameterParts += parts[i];
-  }
-  auto parameters = splitString(removeWhitespace(parameterParts), ',');
-
-  return {name, parameters};
+/**
+ * @brief Parse a function definition from a given signature.
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens of the signature.
+ * @return The parsed function definition.
+ */
+FunctionDefinition parseFunctionDefinition(const std::string& code,
+                                           const Span<const Token>& tokens) {
+  const auto nameEnd = skipInstructionHead(tokens, 1);
+  return {tokenText(code, tokens, 1, nameEnd),
+          splitArguments(code, tokens, nameEnd)};
 }
 
 /**
  * @brief Parse the parameters or arguments from a given instruction.
- * @param instruction The instruction to parse.
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens of the instruction.
  * @return A vector containing the parsed parameters.
  */
-std::vector<std::string> parseParameters(const std::string& instruction) {
-  if (isFunctionDefinition(instruction)) {
-    const auto fd = parseFunctionDefinition(instruction);
-    return fd.parameters;
+std::vector<std::string> parseParameters(const std::string& code,
+                                         const Span<const Token>& tokens) {
+  if (isFunctionDefinition(code, tokens)) {
+    return parseFunctionDefinition(code, tokens).parameters;
   }
 
-  if (instruction.find("->") != std::string::npos) {
-    // We only add the quantum variable to the measurement's targets.
-    return parseParameters(splitString(instruction, '-')[0]);
+  for (size_t i = 0; i + 1 < tokens.size(); i++) {
+    if (tokens[i].type == TokenType::Symbol && code[tokens[i].start] == '-' &&
+        tokens[i + 1].type == TokenType::Symbol &&
+        code[tokens[i + 1].start] == '>' &&
+        tokens[i + 1].start == tokens[i].end) {
+      // We only add the quantum variable to the measurement's targets.
+      const auto* const minus =
+          std::find_if(tokens.begin(), tokens.end(), [&code](const Token& t) {
+            return t.type == TokenType::Symbol && code[t.start] == '-';
+          });
+      const auto targetsEnd = static_cast<size_t>(minus - tokens.begin());
+      return parseParameters(code, subSpan(tokens, 0, targetsEnd));
+    }
   }
 
-  if (isClassicControlledGate(instruction)) {
-    const auto end = instruction.find(')');
-
+  if (isClassicControlledGate(code, tokens)) {
+    const auto* const end =
+        std::find_if(tokens.begin(), tokens.end(), [](const Token& t) {
+          return t.type == TokenType::RightParen;
+        });
     return parseParameters(
-        instruction.substr(end + 1, instruction.length() - end - 1));
+        code, subSpan(tokens, static_cast<size_t>(end - tokens.begin()) + 1,
+                      tokens.size()));
   }
 
-  auto parts = splitString(
-      replaceString(
-          replaceString(replaceString(instruction, ";", " "), "\n", " "), "\t",
-          " "),
-      ' ');
-  size_t index = 0;
-  size_t openBrackets = 0;
-  for (auto& part : parts) {
-    index++;
-    openBrackets +=
-        static_cast<size_t>(std::count(part.begin(), part.end(), '('));
-    openBrackets -=
-        static_cast<size_t>(std::count(part.begin(), part.end(), ')'));
-    if (!part.empty() && openBrackets == 0) {
-      break;
-    }
-  }
+  return splitArguments(code, tokens, skipInstructionHead(tokens, 0));
+}
 
-  std::string parameterParts;
-  for (size_t i = index; i < parts.size(); i++) {
-    if (parts[i].empty()) {
-      continue;
-    }
-    parameterParts += parts[i];
+/**
+ * @brief Get the name of the gate applied by a given instruction.
+ *
+ * This is the text of the instruction up to the first whitespace.
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens of the instruction.
+ * @return The name of the gate applied by the instruction.
+ */
+std::string_view getGateName(const std::string& code,
+                             const Span<const Token>& tokens) {
+  if (tokens.size() == 0) {
+    return "";
   }
-  auto parameters = splitString(removeWhitespace(parameterParts), ',');
-  if (parameters.size() == 1 && parameters[0].empty()) {
-    return {};
+  size_t end = 1;
+  while (end < tokens.size() && tokens[end].start == tokens[end - 1].end) {
+    end++;
   }
-  return parameters;
+  return std::string_view(code).substr(tokens[0].start,
+                                       tokens[end - 1].end - tokens[0].start);
 }
 
 /**
- * @brief Sweep a given code string for function names.
- * @param code The code to sweep.
- * @return A vector containing the function names.
+ * @brief Check if the instruction given by its tokens is an assertion.
+ *
+ * For that, the instruction has to start with the keywords "assert-eq",
+ * "assert-ent", or "assert-sup".
+ * @param code The code the tokens were taken from.
+ * @param tokens The tokens of the instruction.
+ * @return True if the instruction is an assertion, false otherwise.
  */
-std::vector<std::string> sweepFunctionNames(const std::string& code) {
-  std::vector<std::string> result;
-  const std::vector<char> delimiters{';', '}'};
-  const auto instructions = splitString(code, delimiters);
-  for (const auto& instruction : instructions) {
-    if (isFunctionDefinition(instruction)) {
-      const auto f = parseFunctionDefinition(instruction);
-      result.push_back(f.name);
+bool isAssertionInstruction(const std::string& code,
+                            const Span<const Token>& tokens) {
+  if (tokens.size() == 0) {
+    return false;
+  }
+  const auto text = std::string_view(code).substr(tokens[0].start);
+  for (const std::string_view keyword : {"assert-eq", "assert-ent",
+                                         "assert-sup"}) {
+    if (text.substr(0, keyword.size()) == keyword) {
+      return true;
     }
   }
-  return result;
+  return false;
 }
 
 /**
@@ -261,91 +447,202 @@ void unfoldAssertionTargetRegisters(
   }
 }
 
-std::vector<Instruction> preprocessCode(const std::string& code,
-                                        std::string& processedCode) {
-  std::map<std::string, size_t> definedRegisters;
-  return preprocessCode(code, 0, 0, {}, definedRegisters, {}, processedCode);
+/**
+ * @brief The last usages of a register, used to compute data dependencies.
+ *
+ * Usages are stored as pairs of the instruction index and the index of the
+ * variable in the instruction's argument list.
+ */
+struct RegisterUsages {
+  /**
+   * @brief Indicates whether the full register has been used before.
+   */
+  bool hasFullUsage = false;
+  /**
+   * @brief The last usage of the full register.
+   */
+  std::pair<size_t, size_t> fullUsage;
+  /**
+   * @brief The last usage of each index of the register since the last usage
+   * of the full register.
+   */
+  std::unordered_map<size_t, std::pair<size_t, size_t>> indexUsages;
+};
+
+/**
+ * @brief Maps the symbol of each register to its last usages.
+ */
+using LastUsageTable = std::unordered_map<SymbolId, RegisterUsages>;
+
+/**
+ * @brief Add the data dependencies of an instruction based on the last usages
+ * of its targets.
+ *
+ * An indexed variable `q[i]` depends on the last usage of `q[i]` or of the full
+ * register `q`, whichever happened later. A full register `q` depends on its
+ * last full usage and on the last usage of each index since then.
+ * @param instruction The instruction to add the dependencies to.
+ * @param lastUsages The last usages of all registers in the current scope.
+ */
+void addDataDependencies(Instruction& instruction,
+                         const LastUsageTable& lastUsages) {
+  const auto addDependency = [&instruction](
+                                 const std::pair<size_t, size_t>& usage) {
+    auto& dependencies = instruction.dataDependencies;
+    if (std::find(dependencies.begin(), dependencies.end(), usage) ==
+        dependencies.end()) {
+      dependencies.push_back(usage);
+    }
+  };
+
+  for (const auto& target : instruction.targetReferences) {
+    const auto found = lastUsages.find(target.symbol);
+    if (found == lastUsages.end()) {
+      continue;
+    }
+    const auto& usages = found->second;
+    if (target.isFullRegister()) {
+      for (const auto& [_, usage] : usages.indexUsages) {
+        addDependency(usage);
+      }
+      if (usages.hasFullUsage) {
+        addDependency(usages.fullUsage);
+      }
+      continue;
+    }
+    const auto indexUsage = usages.indexUsages.find(target.index);
+    if (indexUsage != usages.indexUsages.end()) {
+      addDependency(indexUsage->second);
+    } else if (usages.hasFullUsage) {
+      addDependency(usages.fullUsage);
+    }
+  }
 }
 
-std::vector<Instruction>
-preprocessCode(const std::string& code, size_t startIndex,
-               size_t initialCodeOffset,
-               const std::vector<std::string>& allFunctionNames,
-               std::map<std::string, size_t>& definedRegisters,
-               const std::vector<std::string>& shadowedRegisters,
-               std::string& processedCode) {
+/**
+ * @brief Record the targets of an instruction as the last usages of the
+ * respective variables.
+ * @param instruction The instruction that uses the variables.
+ * @param lastUsages The last usages of all registers in the current scope.
+ */
+void recordVariableUsages(const Instruction& instruction,
+                          LastUsageTable& lastUsages) {
+  for (size_t i = 0; i < instruction.targetReferences.size(); i++) {
+    const auto& target = instruction.targetReferences[i];
+    auto& usages = lastUsages[target.symbol];
+    const std::pair<size_t, size_t> usage{instruction.lineNumber, i};
+    if (target.isFullRegister()) {
+      // Using the full register supersedes all previous usages of its indices.
+      usages.hasFullUsage = true;
+      usages.fullUsage = usage;
+      usages.indexUsages.clear();
+    } else {
+      usages.indexUsages[target.index] = usage;
+    }
+  }
+}
 
-  std::map<std::string, std::string> blocks;
-  std::map<std::string, size_t> functionFirstLine;
-  std::map<std::string, FunctionDefinition> functionDefinitions;
-  std::map<size_t, std::vector<std::string>> variableUsages;
+/**
+ * @brief Intern the given variables in a symbol table.
+ * @param variables The variables to intern.
+ * @param symbols The symbol table to intern the variables in.
+ * @return The references to the interned variables.
+ */
+std::vector<VariableReference>
+internVariables(const std::vector<std::string>& variables,
+                SymbolTable& symbols) {
+  std::vector<VariableReference> references;
+  references.reserve(variables.size());
+  for (const auto& variable : variables) {
+    references.push_back(symbols.parseVariable(variable));
+  }
+  return references;
+}
 
-  processedCode = removeComments(code);
-  const std::string blocksRemoved = sweepBlocks(processedCode, blocks);
-  std::vector<std::string> functionNames = sweepFunctionNames(processedCode);
+/**
+ * @brief Process the instructions given by a token stream.
+ * @param code The code with comments removed that the tokens were taken from.
+ * @param tokens The tokens to process, not containing any comments.
+ * @param rangeStart The position in the code from which the first instruction
+ * starts.
+ * @param startIndex The line number index from which the tokens start in the
+ * full code.
+ * @param codeOffset The index of the character in the full source code string
+ * that corresponds to the start of `code`.
+ * @param allFunctionNames The names of the functions defined in the previous
+ * scope.
+ * @param definedRegisters The registers defined in the previous scope.
+ * @param shadowedRegisters The registers shadowed by the current or previous
+ * scopes.
+ * @param symbols The symbol table to intern variable names in.
+ * @return A vector of all processed instructions.
+ */
+std::vector<Instruction>
+preprocessTokens(const std::string& code, const Span<const Token>& tokens,
+                 size_t rangeStart, size_t startIndex, size_t codeOffset,
+                 const std::vector<std::string>& allFunctionNames,
+                 std::map<std::string, size_t>& definedRegisters,
+                 const std::vector<std::string>& shadowedRegisters,
+                 SymbolTable& symbols) {
+
+  std::map<std::string, size_t, std::less<>> functionFirstLine;
+  std::map<std::string, FunctionDefinition, std::less<>> functionDefinitions;
+  LastUsageTable lastUsages;
+
+  const auto instructionTokens = splitInstructions(tokens, rangeStart);
+  std::vector<std::string> functionNames;
+  for (const auto& instruction : instructionTokens) {
+    if (isFunctionDefinition(code, instruction.tokens)) {
+      functionNames.push_back(
+          parseFunctionDefinition(code, instruction.tokens).name);
+    }
+  }
   for (const auto& name : allFunctionNames) {
     functionNames.push_back(name);
   }
 
   std::vector<Instruction> instructions;
+  instructions.reserve(instructionTokens.size());
 
-  size_t pos = 0;
   size_t i = startIndex;
-  size_t blocksOffset = initialCodeOffset;
-
-  while (pos != std::string::npos) {
-    const size_t end = blocksRemoved.find(';', pos);
-    if (end == std::string::npos) {
-      break;
-    }
 
-    std::string line = blocksRemoved.substr(pos, end - pos + 1);
-    auto trimmedLine = trim(line);
-    auto tokens = splitString(trimmedLine, ' ');
-    auto isAssert = isAssertion(line);
-    auto blockPos = line.find("$__block");
+  for (const auto& instructionToken : instructionTokens) {
+    const auto& lineTokens = instructionToken.tokens;
+    const auto lineEnd = instructionToken.hasBlock
+                             ? instructionToken.blockStart - 1
+                             : instructionToken.end + 1;
+    const auto line = std::string_view(code).substr(
+        instructionToken.start, lineEnd - instructionToken.start);
+    const auto isAssert = isAssertionInstruction(code, lineTokens);
 
-    const size_t trueStart = pos + blocksOffset;
+    const size_t trueStart = instructionToken.start + codeOffset;
+    const size_t trueEnd = instructionToken.end + codeOffset;
 
     Block block{false, ""};
-    if (blockPos != std::string::npos) {
-      const auto endPos = line.find('$', blockPos + 1) + 1;
-      const auto blockName = line.substr(blockPos, endPos - blockPos + 1);
-      const auto blockContent = blocks[blockName];
-
-      // in the actual code, the current instruction is longer, because we
-      // replaced the block with its name. Also, we add +2 because the block
-      // also had `{` and `}`, which is not included in `blockContent`.
-      blocksOffset += blockContent.size() + 2 - blockName.size();
-      block.code = blockContent;
+    if (instructionToken.hasBlock) {
+      block.code = std::string_view(code).substr(
+          instructionToken.blockStart,
+          instructionToken.end - instructionToken.blockStart);
       block.valid = true;
-      line.replace(blockPos, endPos - blockPos + 1, "");
     }
 
-    const auto targets = parseParameters(line);
+    const auto targets = parseParameters(code, lineTokens);
+    const auto targetReferences = internVariables(targets, symbols);
 
-    const size_t trueEnd = end + blocksOffset;
-
-    if (isVariableDeclaration(line)) {
-      const auto declaration = removeWhitespace(
-          replaceString(replaceString(trimmedLine, "creg", ""), "qreg", ""));
-      const auto parts = splitString(declaration, {'[', ']'});
-      const auto& name = parts[0];
-      const auto size = std::stoi(parts[1]);
-      definedRegisters.insert({name, size});
+    if (isVariableDeclaration(code, lineTokens)) {
+      definedRegisters.insert(parseVariableDeclaration(code, lineTokens));
     }
 
-    if (isFunctionDefinition(line)) {
+    if (isFunctionDefinition(code, lineTokens)) {
       if (!block.valid) {
         throw ParsingError("Gate definitions require a body block");
       }
-      const auto f = parseFunctionDefinition(line);
+      const auto f = parseFunctionDefinition(code, lineTokens);
       functionDefinitions.insert({f.name, f});
       i++;
-      std::string processedSubCode;
-      auto subInstructions = preprocessCode(
-          block.code, i, code.find('{', trueStart) + 1, functionNames,
-          definedRegisters, f.parameters, processedSubCode);
+      auto subInstructions = preprocessTokens(
+          code, instructionToken.blockTokens, instructionToken.blockStart, i,
+          codeOffset, functionNames, definedRegisters, f.parameters, symbols);
       for (auto& instr : subInstructions) {
         instr.inFunctionDefinition = true;
       }
@@ -357,6 +654,7 @@ preprocessCode(const std::string& code, size_t startIndex,
       instructions.emplace_back(i - subInstructions.size() - 1, line, a,
                                 targets, trueStart, trueEnd, i + 1, false, "",
                                 false, true, block);
+      instructions.back().targetReferences = targetReferences;
       for (auto& instr : subInstructions) {
         instructions.back().childInstructions.push_back(instr.lineNumber);
       }
@@ -364,88 +662,109 @@ preprocessCode(const std::string& code, size_t startIndex,
                           std::make_move_iterator(subInstructions.begin()),
                           std::make_move_iterator(subInstructions.end()));
 
-      const auto closingBrace = code.find(
-          '}', instructions[instructions.size() - 1].originalCodeEndPosition);
       const Block noBlock{false, ""};
-      instructions.emplace_back(i, "RETURN", a, targets, closingBrace,
-                                closingBrace, 0, false, "", true, false,
-                                noBlock);
+      instructions.emplace_back(i, "RETURN", a, targets, trueEnd, trueEnd, 0,
+                                false, "", true, false, noBlock);
+      instructions.back().targetReferences = targetReferences;
       i++;
-      pos = end + 1;
 
       continue;
     }
 
     bool isFunctionCall = false;
-    std::string calledFunction;
-    if (!tokens.empty() && std::find(functionNames.begin(), functionNames.end(),
-                                     tokens[0]) != functionNames.end()) {
+    std::string_view calledFunction;
+    const auto gateName = getGateName(code, lineTokens);
+    if (std::find(functionNames.begin(), functionNames.end(), gateName) !=
+        functionNames.end()) {
       isFunctionCall = true;
-      calledFunction = tokens[0];
+      calledFunction = gateName;
     }
 
     if (isAssert) {
-      auto a = parseAssertion(line, block.code);
+      auto a = parseAssertion(std::string(line), std::string(block.code));
       unfoldAssertionTargetRegisters(*a, definedRegisters, shadowedRegisters);
       a->validate();
       instructions.emplace_back(i, line, a, targets, trueStart, trueEnd, i + 1,
                                 isFunctionCall, calledFunction, false, false,
                                 block);
+      instructions.back().targetReferences = targetReferences;
+      addDataDependencies(instructions.back(), lastUsages);
     } else {
       std::unique_ptr<Assertion> a(nullptr);
       instructions.emplace_back(i, line, a, targets, trueStart, trueEnd, i + 1,
                                 isFunctionCall, calledFunction, false, false,
                                 block);
-
-      variableUsages.insert({i, parseParameters(line)});
+      instructions.back().targetReferences = targetReferences;
+      addDataDependencies(instructions.back(), lastUsages);
+      recordVariableUsages(instructions.back(), lastUsages);
     }
 
     i++;
-    pos = end + 1;
   }
 
   for (auto& instr : instructions) {
-    auto vars = parseParameters(instr.code);
-    size_t idx = instr.lineNumber - 1;
-    while (instr.lineNumber != 0 && !vars.empty() &&
-           (instr.lineNumber < instructions.size() ||
-            idx > instr.lineNumber - instructions.size())) {
-      size_t foundIndex = 0;
-      for (const auto& var : variableUsages[idx]) {
-        const auto found =
-            std::find_if(vars.begin(), vars.end(), [&var](const auto& v) {
-              return variablesEqual(v, var);
-            });
-        if (found != vars.end()) {
-          const auto newEnd = std::remove(vars.begin(), vars.end(), var);
-          vars.erase(newEnd, vars.end());
-          instr.dataDependencies.emplace_back(idx, foundIndex);
-        }
-        foundIndex++;
-      }
-      if (idx - 1 == instr.lineNumber - instructions.size() || idx == 0) {
-        break;
-      }
-      idx--;
-    }
     if (instr.isFunctionCall) {
-      instr.successorIndex = functionFirstLine[instr.calledFunction];
-      if (functionDefinitions.find(instr.calledFunction) ==
-          functionDefinitions.end()) {
+      const auto firstLine = functionFirstLine.find(instr.calledFunction);
+      instr.successorIndex =
+          firstLine != functionFirstLine.end() ? firstLine->second : 0;
+      const auto found = functionDefinitions.find(instr.calledFunction);
+      if (found == functionDefinitions.end()) {
         continue;
       }
       instr.callSubstitution.clear();
-      const auto func = functionDefinitions[instr.calledFunction];
-      const auto arguments = parseParameters(instr.code);
+      const auto& func = found->second;
+      const auto& arguments = instr.targetReferences;
       if (func.parameters.size() != arguments.size()) {
         throw ParsingError(
             "Custom gate call uses incorrect number of arguments.");
       }
       for (size_t j = 0; j < func.parameters.size(); j++) {
-        instr.callSubstitution.insert({func.parameters[j], arguments[j]});
+        instr.callSubstitution.insert(
+            {symbols.intern(func.parameters[j]), arguments[j]});
       }
     }
   }
 
   return instructions;
 }
+
+std::vector<Instruction> preprocessCode(const std::string& code,
+                                        std::string& processedCode) {
+  SymbolTable symbols;
+  return preprocessCode(code, processedCode, symbols);
+}
+
+std::vector<Instruction> preprocessCode(const std::string& code,
+                                        std::string& processedCode,
+                                        SymbolTable& symbols) {
+  std::map<std::string, size_t> definedRegisters;
+  return preprocessCode(code, 0, 0, {}, definedRegisters, {}, processedCode,
+                        symbols);
+}
+
+std::vector<Instruction>
+preprocessCode(const std::string& code, size_t startIndex,
+               size_t initialCodeOffset,
+               const std::vector<std::string>& allFunctionNames,
+               std::map<std::string, size_t>& definedRegisters,
+               const std::vector<std::string>& shadowedRegisters,
+               std::string& processedCode, SymbolTable& symbols) {
+  processedCode = code;
+  // Comments are replaced by whitespace, so that all positions in the
+  // processed code still refer to the original code.
+  std::vector<Token> tokens;
+  for (const auto& token : tokenize(code)) {
+    if (token.type == TokenType::Comment) {
+      std::fill(processedCode.begin() +
+                    static_cast<std::ptrdiff_t>(token.start),
+                processedCode.begin() + static_cast<std::ptrdiff_t>(token.end),
+                ' ');
+      continue;
+    }
+    tokens.push_back(token);
+  }
+
+  return preprocessTokens(processedCode, {tokens.data(), tokens.size()}, 0,
+                          startIndex, initialCodeOffset, allFunctionNames,
+                          definedRegisters, shadowedRegisters, symbols);
+}
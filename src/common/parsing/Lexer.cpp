@@ -0,0 +1,90 @@
+/**
+ * @file Lexer.cpp
+ * @brief Implementation of the lexer that splits source code into tokens.
+ */
+
+#include "common/parsing/Lexer.hpp"
+
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Check if a given character can be part of a word token.
+ * @param c The character to check.
+ * @return True if the character can be part of a word token, false otherwise.
+ */
+bool isWordCharacter(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' ||
+         c == '.';
+}
+
+/**
+ * @brief Get the type of a token consisting of a single character.
+ * @param c The character of the token.
+ * @return The type of the token.
+ */
+TokenType getSingleCharacterTokenType(char c) {
+  switch (c) {
+  case ';':
+    return TokenType::Semicolon;
+  case ',':
+    return TokenType::Comma;
+  case '{':
+    return TokenType::LeftBrace;
+  case '}':
+    return TokenType::RightBrace;
+  case '(':
+    return TokenType::LeftParen;
+  case ')':
+    return TokenType::RightParen;
+  case '[':
+    return TokenType::LeftBracket;
+  case ']':
+    return TokenType::RightBracket;
+  default:
+    return TokenType::Symbol;
+  }
+}
+
+std::vector<Token> tokenize(const std::string& code) {
+  std::vector<Token> tokens;
+  const auto length = code.size();
+  size_t pos = 0;
+  while (pos < length) {
+    const auto c = code[pos];
+    if (std::isspace(static_cast<unsigned char>(c)) != 0) {
+      pos++;
+      continue;
+    }
+
+    const auto start = pos;
+    TokenType type = TokenType::Symbol;
+    if (isWordCharacter(c)) {
+      type = TokenType::Word;
+      while (pos < length && isWordCharacter(code[pos])) {
+        pos++;
+      }
+    } else if (c == '/' && pos + 1 < length && code[pos + 1] == '/') {
+      type = TokenType::Comment;
+      while (pos < length && code[pos] != '\n') {
+        pos++;
+      }
+    } else if (c == '"') {
+      type = TokenType::String;
+      pos++;
+      while (pos < length && code[pos] != '"') {
+        pos++;
+      }
+      if (pos < length) {
+        pos++;
+      }
+    } else {
+      type = getSingleCharacterTokenType(c);
+      pos++;
+    }
+    tokens.push_back({type, start, pos});
+  }
+  return tokens;
+}
@@ -10,7 +10,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -39,6 +41,7 @@ void CliFrontEnd::run(const char* code, SimulationState* state) {
 
   bool wasError = false;
   bool wasGet = false;
+  bool wasMetrics = false;
   size_t inspecting = -1ULL;
 
   while (command != "exit") {
@@ -54,6 +57,8 @@ void CliFrontEnd::run(const char* code, SimulationState* state) {
       std::cout << "get <variable>\t";
       std::cout << "reset\t";
       std::cout << "inspect\t";
+      std::cout << "metrics\t";
+      std::cout << "metrics reset\t";
       std::cout << "exit\n\n";
       wasError = false;
     }
@@ -77,6 +82,10 @@ void CliFrontEnd::run(const char* code, SimulationState* state) {
       }
       wasGet = false;
     }
+    if (wasMetrics) {
+      printMetrics(state);
+      wasMetrics = false;
+    }
     printState(state, inspecting, state->getNumQubits(state) >= 6);
 
     std::cout << "Enter command: ";
@@ -99,6 +108,10 @@ void CliFrontEnd::run(const char* code, SimulationState* state) {
       wasGet = true;
     } else if (command == "inspect") {
       inspecting = state->getCurrentInstruction(state);
+    } else if (command == "metrics") {
+      wasMetrics = true;
+    } else if (command == "metrics reset") {
+      state->resetMetrics(state);
     } else if (command == "diagnose") {
       std::vector<ErrorCause> problems(10);
       const auto count = state->getDiagnostics(state)->potentialErrorCauses(
@@ -206,3 +219,45 @@ void CliFrontEnd::printState(SimulationState* state, size_t inspecting,
     std::cout << "THIS LINE FAILED AN ASSERTION\n";
   }
 }
+
+/**
+ * @brief Format a duration given in nanoseconds in milliseconds.
+ * @param nanoseconds The duration in nanoseconds.
+ * @return The formatted duration.
+ */
+std::string formatTime(size_t nanoseconds) {
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(3)
+     << static_cast<double>(nanoseconds) / 1e6 << " ms";
+  return ss.str();
+}
+
+void CliFrontEnd::printMetrics(SimulationState* state) {
+  Metrics metrics{};
+  if (state->getMetrics(state, &metrics) == ERROR) {
+    std::cout << "Metrics not available\n";
+    return;
+  }
+  std::cout << "Code loads:\t\t" << metrics.codeLoads << " (preprocessing "
+            << formatTime(metrics.preprocessingTime) << ", construction "
+            << formatTime(metrics.circuitConstructionTime) << ")\n";
+  std::cout << "DD multiplications:\t" << metrics.ddMultiplications << "\n";
+  std::cout << "Garbage collections:\t" << metrics.garbageCollections << " ("
+            << formatTime(metrics.garbageCollectionTime) << ")\n";
+  std::cout << "assert-ent checks:\t" << metrics.entanglementAssertionChecks
+            << " (" << formatTime(metrics.entanglementAssertionTime) << ")\n";
+  std::cout << "assert-sup checks:\t" << metrics.superpositionAssertionChecks
+            << " (" << formatTime(metrics.superpositionAssertionTime) << ")\n";
+  std::cout << "assert-eq checks:\t"
+            << metrics.statevectorEqualityAssertionChecks << " ("
+            << formatTime(metrics.statevectorEqualityAssertionTime)
+            << "), circuits: " << metrics.circuitEqualityAssertionChecks
+            << " (" << formatTime(metrics.circuitEqualityAssertionTime)
+            << ")\n";
+  std::cout << "Assertion cache:\t" << metrics.assertionCacheHits
+            << " hits, " << metrics.assertionCacheMisses << " misses\n";
+  std::cout << "State expansions:\t" << metrics.stateVectorExpansions << " ("
+            << metrics.stateVectorExpansionAmplitudes << " amplitudes)\n";
+  std::cout << "Diagnostics callbacks:\t" << metrics.diagnosticsCallbacks
+            << " (" << formatTime(metrics.diagnosticsCallbackTime) << ")\n";
+}
@@ -7,24 +7,36 @@ from ._version import version as __version__
 from .pydebugger import (
     Complex,
     Diagnostics,
+    DiagnosticsStatistics,
     ErrorCause,
     ErrorCauseType,
+    MemoryStatistics,
+    Metrics,
     SimulationState,
     Statevector,
+    StopReason,
+    TraceEventType,
     Variable,
     VariableType,
     VariableValue,
     create_ddsim_simulation_state,
     destroy_ddsim_simulation_state,
+    get_dd_package_pool_size,
+    set_dd_package_pool_capacity,
 )
 
 __all__ = [
     "Complex",
     "Diagnostics",
+    "DiagnosticsStatistics",
     "ErrorCause",
     "ErrorCauseType",
+    "MemoryStatistics",
+    "Metrics",
     "SimulationState",
     "Statevector",
+    "StopReason",
+    "TraceEventType",
     "Variable",
     "VariableType",
     "VariableValue",
@@ -32,4 +44,6 @@ __all__ = [
     "create_ddsim_simulation_state",
     "dap",
     "destroy_ddsim_simulation_state",
+    "get_dd_package_pool_size",
+    "set_dd_package_pool_capacity",
 ]
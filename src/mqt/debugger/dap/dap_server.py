@@ -2,13 +2,17 @@
 
 from __future__ import annotations
 
+import contextlib
 import json
+import queue
 import socket
 import sys
+import threading
 from typing import Any, cast
 
 import mqt.debugger
 
+from .message_parser import DAPMessageParser
 from .messages import (
     ConfigurationDoneDAPMessage,
     ContinueDAPMessage,
@@ -58,6 +62,18 @@ supported_messages: list[type[Request]] = [
     RestartFrameDAPMessage,
 ]
 
+# Requests that are answered as soon as they arrive, even while the worker thread executes another request.
+# Apart from pausing the simulation, they must not access the simulation state.
+immediate_commands: set[str] = {
+    PauseDAPMessage.message_type_name,
+    ThreadsDAPMessage.message_type_name,
+}
+
+RECEIVE_BUFFER_SIZE = 65536
+
+# Responses and events are sent from both the connection thread and the worker thread.
+send_lock = threading.Lock()
+
 
 def send_message(msg: str, client: socket.socket) -> None:
     """Send a message to the client according to the DAP messaging protocol.
@@ -67,9 +83,29 @@ def send_message(msg: str, client: socket.socket) -> None:
         client (socket.socket): The client socket to send the message to.
     """
     msg = msg.replace("\n", "\r\n")
-    length = len(msg)
-    header = f"Content-Length: {length}\r\n\r\n".encode("ascii")
-    client.sendall(header + msg.encode("utf-8"))
+    body = msg.encode("utf-8")
+    header = f"Content-Length: {len(body)}\r\n\r\n".encode("ascii")
+    with send_lock:
+        client.sendall(header + body)
+
+
+def error_response(payload: dict[str, Any], error: Exception) -> dict[str, Any]:
+    """Create the response to a request that could not be handled.
+
+    Args:
+        payload (dict[str, Any]): The request read from the client.
+        error (Exception): The exception raised while handling the request.
+
+    Returns:
+        dict[str, Any]: The response, reporting the failure and the message of the exception.
+    """
+    return {
+        "type": "response",
+        "request_seq": payload.get("seq", 0),
+        "success": False,
+        "command": payload.get("command", ""),
+        "message": str(error),
+    }
 
 
 class DAPServer:
@@ -85,6 +121,10 @@ class DAPServer:
     exception_breakpoints: list[str]
     lines_start_at_one: bool
     columns_start_at_one: bool
+    request_lock: threading.Lock
+    pending_requests: int
+    pause_requested: bool
+    worker_error: Exception | None
 
     def __init__(self, host: str = "127.0.0.1", port: int = 4711) -> None:
         """Create a new DAP server instance.
@@ -99,6 +139,10 @@ class DAPServer:
         self.simulation_state = mqt.debugger.SimulationState()
         self.lines_start_at_one = True
         self.columns_start_at_one = True
+        self.request_lock = threading.Lock()
+        self.pending_requests = 0
+        self.pause_requested = False
+        self.worker_error = None
 
     def start(self) -> None:
         """Start the DAP server and listen for one connection."""
@@ -125,103 +169,192 @@ class DAPServer:
     def handle_client(self, connection: socket.socket) -> None:
         """Handle incoming messages from the client.
 
+        Messages are read on the calling thread. Requests that do not access the simulation state, such as 'pause' and 'threads', are answered as soon as they arrive. All other requests are executed in order by a worker thread, so that a long-running simulation command can still be paused by the client.
+
         Args:
             connection (socket.socket): The client socket.
         """
-        data_str = ""
-        message_str = ""
-        while True:
-            if not message_str or not data_str:
-                data = connection.recv(1024)
-                data_str += data.decode()
-            first_end = data_str.find("Content-Length:", 1)
-            if first_end != -1:
-                message_str = data_str[:first_end]
-                data_str = data_str[first_end:]
-            elif data_str.count("{") == data_str.count("}"):
-                message_str = data_str
-                data_str = ""
-            else:
-                message_str = ""
-                continue
-            parts = message_str.split("\n")
-            if not parts or not data:
-                break
-            payload = json.loads(parts[-1])
+        parser = DAPMessageParser()
+        requests: queue.Queue[dict[str, Any] | None] = queue.Queue()
+        self.worker_error = None
+        self.pending_requests = 0
+        self.pause_requested = False
+        worker = threading.Thread(target=self.process_requests, args=(requests, connection), daemon=True)
+        worker.start()
+        try:
+            while True:
+                data = connection.recv(RECEIVE_BUFFER_SIZE)
+                if not data:
+                    break
+                for payload in parser.feed(data):
+                    if payload.get("command") in immediate_commands:
+                        self.handle_immediate_request(payload, connection)
+                    else:
+                        # Counting the request before it is queued lets a pause that arrives before the worker
+                        # starts it be reported by the worker, instead of also being reported right away.
+                        with self.request_lock:
+                            self.pending_requests += 1
+                        requests.put(payload)
+        finally:
+            requests.put(None)
+            worker.join()
+        if self.worker_error is not None:
+            raise self.worker_error
+
+    def handle_immediate_request(self, payload: dict[str, Any], connection: socket.socket) -> None:
+        """Handle a request on the connection thread, while the worker thread may still be busy.
+
+        Args:
+            payload (dict[str, Any]): The request read from the client.
+            connection (socket.socket): The client socket.
+        """
+        try:
             result, cmd = self.handle_command(payload)
-            result_payload = json.dumps(result)
-            send_message(result_payload, connection)
-
-            e: mqt.debugger.dap.messages.DAPEvent | None = None
-            if isinstance(cmd, mqt.debugger.dap.messages.LaunchDAPMessage):
-                e = mqt.debugger.dap.messages.InitializedDAPEvent()
-                event_payload = json.dumps(e.encode())
-                send_message(event_payload, connection)
-            if (
-                isinstance(
-                    cmd, (mqt.debugger.dap.messages.LaunchDAPMessage, mqt.debugger.dap.messages.RestartDAPMessage)
-                )
-                and cmd.stop_on_entry
-            ):
-                e = mqt.debugger.dap.messages.StoppedDAPEvent(
-                    mqt.debugger.dap.messages.StopReason.ENTRY, "Stopped on entry"
-                )
-                event_payload = json.dumps(e.encode())
-                send_message(event_payload, connection)
-            if isinstance(
+        except Exception as e:  # noqa: BLE001
+            send_message(json.dumps(error_response(payload, e)), connection)
+            return
+        send_message(json.dumps(result), connection)
+        if isinstance(cmd, mqt.debugger.dap.messages.PauseDAPMessage):
+            with self.request_lock:
+                # The worker reports the pause once it is done with the next pending request.
+                self.pause_requested = self.pending_requests > 0
+                if self.pause_requested:
+                    return
+            e = mqt.debugger.dap.messages.StoppedDAPEvent(
+                mqt.debugger.dap.messages.StopReason.PAUSE, "Stopped after pause"
+            )
+            send_message(json.dumps(e.encode()), connection)
+
+    def process_requests(self, requests: queue.Queue[dict[str, Any] | None], connection: socket.socket) -> None:
+        """Execute the queued requests in order until `None` is received.
+
+        This runs on the worker thread. Requests that cannot be handled are answered with an error response. If sending the response or the resulting events raises an exception, it is stored in `worker_error` and the connection is shut down, so that the connection thread stops reading and re-raises it.
+
+        Args:
+            requests (queue.Queue[dict[str, Any] | None]): The queue of requests to execute.
+            connection (socket.socket): The client socket.
+        """
+        while (payload := requests.get()) is not None:
+            try:
+                self.process_request(payload, connection)
+                self.finish_request(connection)
+            except Exception as e:  # noqa: BLE001
+                self.worker_error = e
+                with contextlib.suppress(OSError):
+                    connection.shutdown(socket.SHUT_RDWR)
+                return
+
+    def finish_request(self, connection: socket.socket) -> None:
+        """Mark a queued request as done and report a pause that arrived after the request checked for it.
+
+        If another request is still pending, the pause is reported by that request instead.
+
+        Args:
+            connection (socket.socket): The client socket.
+        """
+        with self.request_lock:
+            self.pending_requests -= 1
+            paused = self.pause_requested and self.pending_requests == 0
+            if paused:
+                self.pause_requested = False
+        if paused:
+            e = mqt.debugger.dap.messages.StoppedDAPEvent(
+                mqt.debugger.dap.messages.StopReason.PAUSE, "Stopped after pause"
+            )
+            send_message(json.dumps(e.encode()), connection)
+
+    def process_request(self, payload: dict[str, Any], connection: socket.socket) -> None:
+        """Execute a single request and send its response and the resulting events to the client.
+
+        Args:
+            payload (dict[str, Any]): The request read from the client.
+            connection (socket.socket): The client socket.
+        """
+        try:
+            result, cmd = self.handle_command(payload)
+        except Exception as e:  # noqa: BLE001
+            send_message(json.dumps(error_response(payload, e)), connection)
+            return
+        result_payload = json.dumps(result)
+        send_message(result_payload, connection)
+        with self.request_lock:
+            paused = self.pause_requested
+            self.pause_requested = False
+
+        e: mqt.debugger.dap.messages.DAPEvent | None = None
+        if isinstance(cmd, mqt.debugger.dap.messages.LaunchDAPMessage):
+            e = mqt.debugger.dap.messages.InitializedDAPEvent()
+            event_payload = json.dumps(e.encode())
+            send_message(event_payload, connection)
+        if (
+            isinstance(
+                cmd, (mqt.debugger.dap.messages.LaunchDAPMessage, mqt.debugger.dap.messages.RestartDAPMessage)
+            )
+            and cmd.stop_on_entry
+        ):
+            e = mqt.debugger.dap.messages.StoppedDAPEvent(
+                mqt.debugger.dap.messages.StopReason.ENTRY, "Stopped on entry"
+            )
+            event_payload = json.dumps(e.encode())
+            send_message(event_payload, connection)
+        elif isinstance(
+            cmd,
+            (
+                mqt.debugger.dap.messages.NextDAPMessage,
+                mqt.debugger.dap.messages.StepBackDAPMessage,
+                mqt.debugger.dap.messages.StepInDAPMessage,
+                mqt.debugger.dap.messages.StepOutDAPMessage,
+                mqt.debugger.dap.messages.ContinueDAPMessage,
+                mqt.debugger.dap.messages.ReverseContinueDAPMessage,
+                mqt.debugger.dap.messages.RestartFrameDAPMessage,
+            ),
+        ) or (
+            isinstance(
                 cmd,
                 (
-                    mqt.debugger.dap.messages.NextDAPMessage,
-                    mqt.debugger.dap.messages.StepBackDAPMessage,
-                    mqt.debugger.dap.messages.StepInDAPMessage,
-                    mqt.debugger.dap.messages.StepOutDAPMessage,
-                    mqt.debugger.dap.messages.ContinueDAPMessage,
-                    mqt.debugger.dap.messages.ReverseContinueDAPMessage,
-                    mqt.debugger.dap.messages.RestartFrameDAPMessage,
+                    mqt.debugger.dap.messages.LaunchDAPMessage,
+                    mqt.debugger.dap.messages.RestartDAPMessage,
                 ),
-            ) or (
-                isinstance(
-                    cmd,
-                    (
-                        mqt.debugger.dap.messages.LaunchDAPMessage,
-                        mqt.debugger.dap.messages.RestartDAPMessage,
-                    ),
-                )
-                and not cmd.stop_on_entry
-            ):
-                event = (
-                    mqt.debugger.dap.messages.StopReason.EXCEPTION
-                    if self.simulation_state.did_assertion_fail()
-                    else mqt.debugger.dap.messages.StopReason.BREAKPOINT_INSTRUCTION
-                    if self.simulation_state.was_breakpoint_hit()
-                    else mqt.debugger.dap.messages.StopReason.STEP
-                )
-                message = (
-                    "An assertion failed"
-                    if self.simulation_state.did_assertion_fail()
-                    else "Stopped at breakpoint"
-                    if self.simulation_state.was_breakpoint_hit()
-                    else "Stopped after step"
-                )
-                e = mqt.debugger.dap.messages.StoppedDAPEvent(event, message)
-                event_payload = json.dumps(e.encode())
-                send_message(event_payload, connection)
-                if self.simulation_state.did_assertion_fail():
-                    self.handle_assertion_fail(connection)
-            if isinstance(cmd, mqt.debugger.dap.messages.TerminateDAPMessage):
-                e = mqt.debugger.dap.messages.TerminatedDAPEvent()
-                event_payload = json.dumps(e.encode())
-                send_message(event_payload, connection)
-                e = mqt.debugger.dap.messages.ExitedDAPEvent(143)
-                event_payload = json.dumps(e.encode())
-                send_message(event_payload, connection)
-            if isinstance(cmd, mqt.debugger.dap.messages.PauseDAPMessage):
-                e = mqt.debugger.dap.messages.StoppedDAPEvent(
-                    mqt.debugger.dap.messages.StopReason.PAUSE, "Stopped after pause"
-                )
-                event_payload = json.dumps(e.encode())
-                send_message(event_payload, connection)
-            self.regular_checks(connection)
+            )
+            and not cmd.stop_on_entry
+        ):
+            event = (
+                mqt.debugger.dap.messages.StopReason.EXCEPTION
+                if self.simulation_state.did_assertion_fail()
+                else mqt.debugger.dap.messages.StopReason.BREAKPOINT_INSTRUCTION
+                if self.simulation_state.was_breakpoint_hit()
+                else mqt.debugger.dap.messages.StopReason.PAUSE
+                if paused
+                else mqt.debugger.dap.messages.StopReason.STEP
+            )
+            message = (
+                "An assertion failed"
+                if self.simulation_state.did_assertion_fail()
+                else "Stopped at breakpoint"
+                if self.simulation_state.was_breakpoint_hit()
+                else "Stopped after pause"
+                if paused
+                else "Stopped after step"
+            )
+            e = mqt.debugger.dap.messages.StoppedDAPEvent(event, message)
+            event_payload = json.dumps(e.encode())
+            send_message(event_payload, connection)
+            if self.simulation_state.did_assertion_fail():
+                self.handle_assertion_fail(connection)
+        elif paused:
+            e = mqt.debugger.dap.messages.StoppedDAPEvent(
+                mqt.debugger.dap.messages.StopReason.PAUSE, "Stopped after pause"
+            )
+            event_payload = json.dumps(e.encode())
+            send_message(event_payload, connection)
+        if isinstance(cmd, mqt.debugger.dap.messages.TerminateDAPMessage):
+            e = mqt.debugger.dap.messages.TerminatedDAPEvent()
+            event_payload = json.dumps(e.encode())
+            send_message(event_payload, connection)
+            e = mqt.debugger.dap.messages.ExitedDAPEvent(143)
+            event_payload = json.dumps(e.encode())
+            send_message(event_payload, connection)
+        self.regular_checks(connection)
 
     def regular_checks(self, connection: socket.socket) -> None:
         """Perform regular checks and send events to the client if necessary.
@@ -265,13 +398,12 @@ class DAPServer:
             connection (socket.socket): The client socket.
         """
         current_instruction = self.simulation_state.get_current_instruction()
-        dependencies = self.simulation_state.get_diagnostics().get_data_dependencies(current_instruction)
-        gray_out_areas: list[tuple[int, int]] = []
-        for i in range(self.simulation_state.get_instruction_count()):
-            if i in dependencies:
-                continue
-            start, end = self.simulation_state.get_instruction_position(i)
-            gray_out_areas.append((start, end))
+        dependencies = set(self.simulation_state.get_diagnostics().get_data_dependencies(current_instruction))
+        gray_out_areas: list[tuple[int, int]] = [
+            position
+            for i, position in enumerate(self.simulation_state.get_instruction_positions())
+            if i not in dependencies
+        ]
 
         e = mqt.debugger.dap.messages.GrayOutDAPEvent(gray_out_areas, self.source_file)
         event_payload = json.dumps(e.encode())
@@ -306,29 +438,28 @@ class DAPServer:
     def code_pos_to_coordinates(self, pos: int) -> tuple[int, int]:
         """Helper method to convert a code position to line and column.
 
+        The lookup uses the line starts computed by the simulation state when the code was loaded. Positions outside of the code are clamped to it, and if they still cannot be converted, because the source code does not match the loaded code, the start of the code is returned.
+
         Args:
             pos (int): The 0-indexed position in the code.
 
         Returns:
             tuple[int, int]: The line and column, 0-or-1-indexed.
         """
-        lines = self.source_code.split("\n")
-        line = 0
-        col = 0
-        for i, line_code in enumerate(lines):
-            if pos < len(line_code):
-                line = i + 1
-                col = pos
-                break
-            pos -= len(line_code) + 1
+        try:
+            line, col = self.simulation_state.get_code_coordinates(min(max(pos, 0), len(self.source_code)))
+        except RuntimeError:
+            line, col = 0, 0
+        if self.lines_start_at_one:
+            line += 1
         if self.columns_start_at_one:
             col += 1
-        if not self.lines_start_at_one:
-            line -= 1
         return (line, col)
 
     def code_coordinates_to_pos(self, line: int, col: int) -> int:
-        """Helper method to convert a code line and column to its position idnex.
+        """Helper method to convert a code line and column to its position index.
+
+        The lookup uses the line starts computed by the simulation state when the code was loaded. The client may send lines and columns of an edited version of the code, so columns beyond the end of a line are clamped to the line, and lines beyond the end of the code to its end.
 
         Args:
             line (int): The 0-or-1-indexed line in the code.
@@ -337,16 +468,20 @@ class DAPServer:
         Returns:
             int: The 0-indexed position in the code.
         """
-        lines = self.source_code.split("\n")
-        if not self.lines_start_at_one:
-            line += 1
-        pos = 0
-        for line_index in range(line - 1):
-            pos += len(lines[line_index]) + 1
-        pos += col
+        if self.lines_start_at_one:
+            line -= 1
         if self.columns_start_at_one:
-            pos -= 1
-        return pos
+            col -= 1
+        line = max(line, 0)
+        try:
+            return self.simulation_state.get_code_position(line, max(col, 0))
+        except RuntimeError:
+            pass
+        try:
+            # The last column of a line is the one right before the start of the next line.
+            return self.simulation_state.get_code_position(line + 1, 0) - 1
+        except RuntimeError:
+            return len(self.source_code)
 
     def format_error_cause(self, cause: mqt.debugger.ErrorCause) -> str:
         """Format an error cause for output.
@@ -0,0 +1,80 @@
+"""Splits the byte stream received from a DAP client into messages."""
+
+from __future__ import annotations
+
+import json
+from typing import Any
+
+HEADER_SEPARATOR = b"\r\n\r\n"
+
+
+class DAPMessageParser:
+    """Incrementally parses length-prefixed DAP messages.
+
+    Each message consists of a header with a `Content-Length` field, followed by an empty line and a JSON body of exactly that many bytes. Data can be fed in chunks of any size, and each byte is only scanned once, so large messages do not cause repeated re-parsing of the buffered data.
+    """
+
+    buffer: bytearray
+    content_length: int | None
+    search_start: int
+
+    def __init__(self) -> None:
+        """Create a new parser with an empty buffer."""
+        self.buffer = bytearray()
+        self.content_length = None
+        self.search_start = 0
+
+    def feed(self, data: bytes) -> list[dict[str, Any]]:
+        """Add received data to the buffer and extract all messages that are complete.
+
+        Args:
+            data (bytes): The received data.
+
+        Raises:
+            ValueError: If a message header is malformed.
+
+        Returns:
+            list[dict[str, Any]]: The decoded bodies of all completed messages, in the order they were received.
+        """
+        self.buffer += data
+        messages: list[dict[str, Any]] = []
+        while True:
+            if self.content_length is None:
+                header_end = self.buffer.find(HEADER_SEPARATOR, self.search_start)
+                if header_end == -1:
+                    # The separator may start within the last bytes, so they are scanned again next time.
+                    self.search_start = max(0, len(self.buffer) - len(HEADER_SEPARATOR) + 1)
+                    break
+                self.content_length = parse_content_length(bytes(self.buffer[:header_end]))
+                del self.buffer[: header_end + len(HEADER_SEPARATOR)]
+                self.search_start = 0
+            if len(self.buffer) < self.content_length:
+                break
+            body = bytes(self.buffer[: self.content_length])
+            del self.buffer[: self.content_length]
+            self.content_length = None
+            messages.append(json.loads(body.decode("utf-8")))
+        return messages
+
+
+def parse_content_length(header: bytes) -> int:
+    """Read the value of the `Content-Length` field from a message header.
+
+    Args:
+        header (bytes): The header, without the separating empty line.
+
+    Raises:
+        ValueError: If the header does not contain a valid `Content-Length` field.
+
+    Returns:
+        int: The length of the message body in bytes.
+    """
+    for field in header.decode("ascii").split("\r\n"):
+        name, _, value = field.partition(":")
+        if name.strip().lower() == "content-length":
+            length = int(value.strip())
+            if length < 0:
+                break
+            return length
+    msg = f"Invalid DAP message header: {header!r}"
+    raise ValueError(msg)
@@ -48,6 +48,8 @@ class RestartDAPMessage(DAPMessage):
     def handle(self, server: DAPServer) -> dict[str, Any]:
         """Performs the action requested by the 'restart' DAP request.
 
+        The simulation is reset before the program is reloaded, so it always restarts from the first instruction. Reloading the program instead of loading it still keeps the cached assertion results and circuit-equality references of the instructions that were not edited.
+
         Args:
             server (DAPServer): The DAP server that received the request.
 
@@ -59,7 +61,7 @@ class RestartDAPMessage(DAPMessage):
         with program_path.open("r", encoding=locale.getpreferredencoding(False)) as f:
             code = f.read()
             server.source_code = code
-            server.simulation_state.load_code(code)
+            server.simulation_state.reload_code(code)
         if not self.stop_on_entry:
             server.simulation_state.run_simulation()
         server.source_file = {"name": program_path.name, "path": self.program}
@@ -16,6 +16,7 @@ class SetBreakpointsDAPMessage(DAPMessage):
     message_type_name: str = "setBreakpoints"
 
     breakpoints: list[tuple[int, int]]
+    conditions: list[tuple[str | None, str | None]]
     source: dict[str, Any]
 
     def __init__(self, message: dict[str, Any]) -> None:
@@ -25,6 +26,7 @@ class SetBreakpointsDAPMessage(DAPMessage):
             message (dict[str, Any]): The object representing the 'setBreakpoints' request.
         """
         self.breakpoints = [(int(x["line"]), int(x.get("column", -1))) for x in message["arguments"]["breakpoints"]]
+        self.conditions = [(x.get("condition"), x.get("hitCondition")) for x in message["arguments"]["breakpoints"]]
         self.source = message["arguments"]["source"]
         super().__init__(message)
 
@@ -46,28 +48,37 @@ class SetBreakpointsDAPMessage(DAPMessage):
         d = super().handle(server)
 
         server.simulation_state.clear_breakpoints()
-        bpts = []
-        for i, breakpoint_position in enumerate(self.breakpoints):
-            position = server.code_coordinates_to_pos(
+        positions = [
+            server.code_coordinates_to_pos(
                 breakpoint_position[0],
                 breakpoint_position[1] if breakpoint_position[1] != -1 else 1 if server.columns_start_at_one else 0,
             )
-            try:
-                breakpoint_instruction = server.simulation_state.set_breakpoint(position)
-                start, end = server.simulation_state.get_instruction_position(breakpoint_instruction)
-                start_line, start_col = server.code_pos_to_coordinates(start)
-                end_line, end_col = server.code_pos_to_coordinates(end)
-                bpts.append({
-                    "id": i,
-                    "verified": True,
-                    "source": self.source,
-                    "line": start_line,
-                    "column": start_col,
-                    "endLine": end_line,
-                    "endColumn": end_col,
-                })
-            except RuntimeError:
+            for breakpoint_position in self.breakpoints
+        ]
+        bpts = []
+        for i, breakpoint_instruction in enumerate(server.simulation_state.set_breakpoints(positions)):
+            if breakpoint_instruction is None:
                 bpts.append({"id": i, "verified": False, "message": "Breakpoint could not be set", "reason": "failed"})
+                continue
+            start, end = server.simulation_state.get_instruction_position(breakpoint_instruction)
+            start_line, start_col = server.code_pos_to_coordinates(start)
+            end_line, end_col = server.code_pos_to_coordinates(end)
+            bpt = {
+                "id": i,
+                "verified": True,
+                "source": self.source,
+                "line": start_line,
+                "column": start_col,
+                "endLine": end_line,
+                "endColumn": end_col,
+            }
+            condition, hit_condition = self.conditions[i]
+            if condition or hit_condition:
+                try:
+                    server.simulation_state.set_breakpoint_condition(breakpoint_instruction, condition, hit_condition)
+                except RuntimeError:
+                    bpt["message"] = "Invalid breakpoint condition, the breakpoint will always be hit"
+            bpts.append(bpt)
         d["body"] = {"breakpoints": bpts}
         return d
 
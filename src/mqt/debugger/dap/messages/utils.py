@@ -14,8 +14,8 @@ def get_default_capabilities() -> dict[str, Any]:
     return {
         "supportsConfigurationDoneRequest": True,
         "supportsFunctionBreakpoints": False,
-        "supportsConditionalBreakpoints": False,
-        "supportsHitConditionalBreakpoints": False,
+        "supportsConditionalBreakpoints": True,
+        "supportsHitConditionalBreakpoints": True,
         "supportsEvaluateForHovers": False,
         "supportsExceptionInfoRequest": True,
         "exceptionBreakpointFilters": [],
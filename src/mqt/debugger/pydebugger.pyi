@@ -2,6 +2,9 @@
 
 import enum
 
+import numpy as np
+import numpy.typing as npt
+
 # Enums
 
 class VariableType(enum.Enum):
@@ -14,6 +17,34 @@ class VariableType(enum.Enum):
     VarFloat: VariableType
     """A floating-point variable."""
 
+class TraceEventType(enum.Enum):
+    """Represents the types of events in the execution trace."""
+
+    TraceStepForward: TraceEventType
+    """An instruction was executed."""
+    TraceStepBackward: TraceEventType
+    """An instruction was reverted."""
+    TraceCall: TraceEventType
+    """A custom gate was called. The value is the first instruction of the called gate."""
+    TraceReturn: TraceEventType
+    """A custom gate returned to its caller. The value is the instruction the execution continues at."""
+    TraceMeasurement: TraceEventType
+    """A qubit was measured. The value is twice the index of the measured qubit, plus 1 if the outcome was |1>."""
+    TraceNodeCount: TraceEventType
+    """The number of nodes of the decision diagram representing the state, stored in the value."""
+
+class StopReason(enum.Enum):
+    """Represents the reasons why `SimulationState.step_many` stopped executing instructions."""
+
+    StepLimit: StopReason
+    """The requested number of steps was executed."""
+    Finished: StopReason
+    """The simulation finished and cannot step forward anymore."""
+    AssertionFailed: StopReason
+    """An assertion failed."""
+    BreakpointHit: StopReason
+    """A breakpoint was hit."""
+
 # Classes
 class VariableValue:
     """Represents the value of a classical variable.
@@ -80,6 +111,95 @@ class Statevector:
     def __init__(self) -> None:
         """Creates a new `Statevector` instance."""
 
+class Metrics:
+    """Counters and timers describing the work of a simulation state.
+
+    They accumulate over all loaded programs until they are reset. All times are given in nanoseconds.
+    """
+
+    dd_multiplications: int
+    """The number of decision diagram multiplications applying an operation to the state."""
+    garbage_collections: int
+    """The number of garbage collections that freed unused nodes."""
+    garbage_collection_time: int
+    """The total time spent in garbage collections."""
+    entanglement_assertion_checks: int
+    """The number of checked entanglement assertions."""
+    entanglement_assertion_time: int
+    """The total time spent checking entanglement assertions."""
+    superposition_assertion_checks: int
+    """The number of checked superposition assertions."""
+    superposition_assertion_time: int
+    """The total time spent checking superposition assertions."""
+    statevector_equality_assertion_checks: int
+    """The number of checked equality assertions against a state vector."""
+    statevector_equality_assertion_time: int
+    """The total time spent checking equality assertions against a state vector."""
+    circuit_equality_assertion_checks: int
+    """The number of checked equality assertions against a circuit."""
+    circuit_equality_assertion_time: int
+    """The total time spent checking equality assertions against a circuit, including the simulation of the reference circuits."""
+    assertion_cache_hits: int
+    """The number of assertion checks answered by cached outcomes."""
+    assertion_cache_misses: int
+    """The number of assertion checks that had to be computed."""
+    state_vector_expansions: int
+    """The number of times the full state vector was computed from the decision diagram."""
+    state_vector_expansion_amplitudes: int
+    """The total number of amplitudes computed by state vector expansions."""
+    diagnostics_callbacks: int
+    """The number of diagnostics callbacks invoked while stepping through the program."""
+    diagnostics_callback_time: int
+    """The total time spent in diagnostics callbacks."""
+    code_loads: int
+    """The number of loaded programs."""
+    preprocessing_time: int
+    """The total time spent preprocessing loaded code."""
+    circuit_construction_time: int
+    """The total time spent building the quantum computation of loaded code."""
+
+    def __init__(self) -> None:
+        """Creates a new `Metrics` instance."""
+
+class MemoryStatistics:
+    """Describes the memory used by the decision diagrams of a simulation state."""
+
+    vector_nodes: int
+    """The number of vector nodes stored in the unique table, including unused nodes that were not yet collected."""
+    active_vector_nodes: int
+    """The number of vector nodes that are currently referenced."""
+    peak_active_vector_nodes: int
+    """The largest number of vector nodes that were referenced at the same time."""
+    matrix_nodes: int
+    """The number of matrix nodes stored in the unique table, including unused nodes that were not yet collected."""
+    active_matrix_nodes: int
+    """The number of matrix nodes that are currently referenced."""
+    node_memory: int
+    """The number of bytes used by all stored vector and matrix nodes."""
+    package_memory: int
+    """The number of bytes used by the decision diagram package, including the nodes and numbers in use, the unique tables, and the compute tables."""
+    memory_budget: int
+    """The number of bytes the decision diagram package may use, or 0 if there is no limit."""
+    budget_collections: int
+    """The number of times exceeding the memory budget forced a garbage collection."""
+    budget_exceeded: bool
+    """Whether the last step was refused because the decision diagram package exceeded the memory budget."""
+    multiplication_table_entries: int
+    """The number of entries in the compute table of matrix-vector multiplications."""
+    multiplication_table_buckets: int
+    """The number of buckets of the compute table of matrix-vector multiplications."""
+    multiplication_table_hit_ratio: float
+    """The ratio of lookups in the compute table of matrix-vector multiplications that found a result."""
+    addition_table_entries: int
+    """The number of entries in the compute table of vector additions."""
+    addition_table_buckets: int
+    """The number of buckets of the compute table of vector additions."""
+    addition_table_hit_ratio: float
+    """The ratio of lookups in the compute table of vector additions that found a result."""
+
+    def __init__(self) -> None:
+        """Creates a new `MemoryStatistics` instance."""
+
 class SimulationState:
     """Represents the state of a quantum simulation for debugging.
 
@@ -99,9 +219,33 @@ class SimulationState:
             code (str): The code to load.
         """
 
+    def reload_code(self, code: str) -> None:
+        """Loads an edited version of the current code into the simulation state.
+
+        Unlike `load_code`, this reuses results for the unchanged beginning of the code. If instructions executed so far were changed, the simulation first steps back to the last unchanged one, and then continues from there. The diagnostics data of unchanged instructions is kept as well. If no code was loaded before, it behaves like `load_code`.
+
+        Args:
+            code (str): The edited code to load.
+        """
+
     def step_forward(self) -> None:
         """Steps the simulation forward by one instruction."""
 
+    def step_many(
+        self, count: int, stop_on: list[StopReason] | None = None
+    ) -> tuple[npt.NDArray[np.uint64], StopReason]:
+        """Steps the simulation forward by up to `count` instructions.
+
+        All steps are executed in a single call, which avoids the overhead of calling `step_forward` and checking the simulation state from Python after every instruction. The execution stops early if the simulation finishes or if one of the reasons given in `stop_on` occurs.
+
+        Args:
+            count (int): The maximum number of steps to execute.
+            stop_on (list[StopReason] | None): The reasons that stop the execution early. Only `StopReason.AssertionFailed` and `StopReason.BreakpointHit` have an effect, as the execution always stops when the simulation finishes. Defaults to both of them.
+
+        Returns:
+            tuple[numpy.ndarray, StopReason]: The indices of the executed instructions, in order, and the reason why the execution stopped.
+        """
+
     def step_over_forward(self) -> None:
         """Steps the simulation forward by one instruction, skipping over possible custom gate calls."""
 
@@ -146,6 +290,8 @@ class SimulationState:
 
         If the simulation is running in a concurrent thread, the execution will
         stop as soon as possible, but it is not guaranteed to stop immediately.
+        The methods that run or step over several instructions release the GIL,
+        so that a concurrent Python thread can call this method meanwhile.
 
         If the simulation is not running, then the next call to continue the
         simulation will stop as soon as possible. `step over` and `step out`
@@ -227,6 +373,38 @@ class SimulationState:
             tuple[int, int]: The start and end positions of the instruction.
         """
 
+    def get_instruction_positions(self) -> list[tuple[int, int]]:
+        """Gets the positions of all instructions in the code.
+
+        This returns the same positions as `get_instruction_position` for each instruction, but only requires a single call.
+
+        Returns:
+            list[tuple[int, int]]: The start and end positions of each instruction.
+        """
+
+    def get_code_coordinates(self, position: int) -> tuple[int, int]:
+        """Converts a position in the loaded code to a line and column.
+
+        The start of each line is determined once when the code is loaded, so each conversion only requires a binary search. A line break belongs to the line it ends.
+
+        Args:
+            position (int): The 0-indexed position in the code.
+
+        Returns:
+            tuple[int, int]: The 0-indexed line and column.
+        """
+
+    def get_code_position(self, line: int, column: int) -> int:
+        """Converts a line and column in the loaded code to a position.
+
+        Args:
+            line (int): The 0-indexed line.
+            column (int): The 0-indexed column.
+
+        Returns:
+            int: The 0-indexed position in the code.
+        """
+
     def get_num_qubits(self) -> int:
         """Gets the number of qubits used by the program.
 
@@ -321,6 +499,35 @@ class SimulationState:
             Statevector: The sub-state vector of the current simulation state.
         """
 
+    def get_state_vector_full_array(
+        self, out: npt.NDArray[np.complex128] | None = None
+    ) -> npt.NDArray[np.complex128]:
+        """Gets the full state vector of the simulation at the current time as a NumPy array.
+
+        The amplitudes are written directly into the memory of the returned `complex128` array, without creating a Python object per amplitude. To avoid allocating a new array in every call, an existing array can be passed as `out`. It must be a writeable, contiguous `complex128` array with one element per amplitude.
+
+        Args:
+            out (numpy.ndarray | None): An optional array to store the amplitudes in.
+
+        Returns:
+            numpy.ndarray: The amplitudes of the full state vector.
+        """
+
+    def get_state_vector_sub_array(
+        self, qubits: list[int], out: npt.NDArray[np.complex128] | None = None
+    ) -> npt.NDArray[np.complex128]:
+        """Gets a sub-state of the state vector of the simulation at the current time as a NumPy array.
+
+        The amplitudes are written directly into the memory of the returned `complex128` array, without creating a Python object per amplitude. To avoid allocating a new array in every call, an existing array can be passed as `out`. It must be a writeable, contiguous `complex128` array with one element per amplitude.
+
+        Args:
+            qubits (list[int]): The qubits to include in the sub-state.
+            out (numpy.ndarray | None): An optional array to store the amplitudes in.
+
+        Returns:
+            numpy.ndarray: The amplitudes of the sub-state vector.
+        """
+
     def set_breakpoint(self, desired_position: int) -> int:
         """Sets a breakpoint at the desired position in the code.
 
@@ -334,6 +541,33 @@ class SimulationState:
             int: The index of the instruction where the breakpoint was set.
         """
 
+    def set_breakpoints(self, desired_positions: list[int]) -> list[int | None]:
+        """Sets breakpoints at multiple desired positions in the code.
+
+        The positions are given as 0-indexed character positions in the full code
+        string. Setting many breakpoints at once is faster than calling
+        `set_breakpoint` for each of them.
+
+        Args:
+            desired_positions (list[int]): The positions in the code to set the breakpoints.
+
+        Returns:
+            list[int | None]: For each position, the index of the instruction where the breakpoint was set, or `None` if no breakpoint could be set at that position.
+        """
+
+    def set_breakpoint_condition(
+        self, instruction: int, condition: str | None = None, hit_condition: str | None = None
+    ) -> None:
+        """Attaches conditions to the breakpoint at the given instruction.
+
+        The condition compares a classical bit (`c[0] == 1`), a classical register (`c >= 2`), or the probability of measuring a qubit in the state |1> (`P(q[0]) > 0.5`) to a value. The hit condition compares the number of times the breakpoint was reached while its condition held since the last reset to a number (`>= 3`) or checks whether it is a multiple of a number (`% 2`). The breakpoint is only hit if both conditions hold. Passing no conditions removes all conditions from the breakpoint.
+
+        Args:
+            instruction (int): The instruction of the breakpoint.
+            condition (str | None): The condition on the state of the simulation.
+            hit_condition (str | None): The condition on the hit count of the breakpoint.
+        """
+
     def clear_breakpoints(self) -> None:
         """Clears all breakpoints set in the simulation."""
 
@@ -360,6 +594,55 @@ class SimulationState:
             list[int]: The stack trace of the simulation.
         """
 
+    def set_trace_capacity(self, capacity: int, record_node_counts: bool = False) -> None:
+        """Sets the number of events kept in the execution trace.
+
+        While tracing is enabled, each step records its instruction, custom gate calls and returns, and measurement outcomes. The memory for the trace is allocated once, and when it is full, each new event replaces the oldest one.
+
+        The trace is cleared when the simulation is reset or new code is loaded. Setting the capacity also clears it.
+
+        Args:
+            capacity (int): The maximum number of events to keep, or 0 to disable tracing.
+            record_node_counts (bool): Whether to also record the number of nodes of the decision diagram after each step that changes the state.
+        """
+
+    def get_trace(self) -> npt.NDArray[np.uint64]:
+        """Gets the events stored in the execution trace.
+
+        Each row of the returned array represents one event, from the oldest to the most recent one. The columns contain the `TraceEventType` of the event as an integer, the instruction the event refers to, and a value that depends on the type of the event.
+
+        Returns:
+            numpy.ndarray: The events of the trace, with shape `(n, 3)`.
+        """
+
+    def get_metrics(self) -> Metrics:
+        """Gets the counters and timers describing the work performed so far.
+
+        They accumulate over all loaded programs until they are reset, so that slow sessions can be attributed to the responsible subsystem.
+
+        Returns:
+            Metrics: The current metrics of the simulation state.
+        """
+
+    def reset_metrics(self) -> None:
+        """Resets all counters and timers to zero."""
+
+    def get_memory_statistics(self) -> MemoryStatistics:
+        """Gets the memory used by the decision diagrams of the simulation.
+
+        Returns:
+            MemoryStatistics: The node counts, memory usage, and compute table statistics of the simulation.
+        """
+
+    def set_memory_budget(self, budget: int) -> None:
+        """Limits the memory used by the decision diagrams of the simulation.
+
+        Before a step applies an operation, the memory of the decision diagram package is compared to the budget. If it exceeds the budget, the compute tables are flushed, the states cached for assertions are released, and a garbage collection is forced. If the package still exceeds the budget afterwards, the step is refused without changing the state and raises an error, and `budget_exceeded` is set in the memory statistics, so that running the simulation stops before the process runs out of memory.
+
+        Args:
+            budget (int): The number of bytes the decision diagram package may use, or 0 to remove the limit.
+        """
+
     def get_diagnostics(self) -> Diagnostics:
         """Gets the diagnostics instance employed by this debugger.
 
@@ -388,6 +671,19 @@ class ErrorCause:
     def __init__(self) -> None:
         """Creates a new `ErrorCause` instance."""
 
+class DiagnosticsStatistics:
+    """Represents statistics about the runtime data collected by the diagnostics."""
+
+    distinct_qubit_tuples: int
+    """The number of distinct qubit tuples targeted by instructions at runtime."""
+    qubit_usage_entries: int
+    """The number of distinct (instruction, qubit tuple) pairs recorded at runtime."""
+    qubit_usage_bytes: int
+    """The approximate number of bytes used to store the runtime qubit usage."""
+
+    def __init__(self) -> None:
+        """Creates a new `DiagnosticsStatistics` instance."""
+
 class Diagnostics:
     """Provides diagnostics capabilities such as different analysis methods for the debugger."""
     def __init__(self) -> None:
@@ -478,6 +774,32 @@ class Diagnostics:
             list[ErrorCause]: A list of potential error causes encountered during execution.
         """
 
+    def potential_error_causes_all(self) -> list[ErrorCause]:
+        """Extract a ranked list of potential error causes for all assertions that failed during the last `run_all` call.
+
+        Each error cause is only reported once, even if it explains several failed
+        assertions. Error causes that explain failures at more call sites are reported
+        first. A call site is a failed assertion together with the custom gate calls it
+        was reached through, so an assertion inside a custom gate counts once for each
+        call it failed in.
+
+        This method should be run after the program has been executed using
+        `run_all`.
+
+        Returns:
+            list[ErrorCause]: A ranked list of potential error causes for all failed assertions.
+        """
+
+    def get_statistics(self) -> DiagnosticsStatistics:
+        """Get statistics about the runtime data collected by the diagnostics.
+
+        This can be used to monitor the memory consumption of the dynamic analysis
+        methods.
+
+        Returns:
+            DiagnosticsStatistics: The statistics of the diagnostics instance.
+        """
+
 def create_ddsim_simulation_state() -> SimulationState:
     """Creates a new `SimulationState` instance using the DD backend for simulation and the OpenQASM language as input format.
 
@@ -491,3 +813,19 @@ def destroy_ddsim_simulation_state(state: SimulationState) -> None:
     Args:
         state (SimulationState): The simulation state to delete.
     """
+
+def set_dd_package_pool_capacity(capacity: int) -> None:
+    """Set the number of DD packages of deleted simulation states kept for reuse.
+
+    New simulation states take their DD package from the pool if it is not empty, so that the nodes and tables allocated by previous sessions do not have to be allocated again. The capacity is 0 by default.
+
+    Args:
+        capacity (int): The maximum number of packages kept in the pool.
+    """
+
+def get_dd_package_pool_size() -> int:
+    """Get the number of DD packages currently kept for reuse.
+
+    Returns:
+        int: The number of packages in the pool.
+    """
@@ -7,12 +7,16 @@
 #include "backend/debug.h"
 #include "backend/diagnostics.h"
 #include "common.h"
+#include "pybind11/complex.h"
+#include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
 #include <algorithm>
+#include <complex>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -44,6 +48,109 @@ struct StatevectorCPP {
   std::vector<Complex> amplitudes;
 };
 
+/**
+ * @brief The reasons why `step_many` stopped executing instructions.
+ */
+enum class StopReason : uint8_t {
+  /**
+   * @brief The requested number of steps was executed.
+   */
+  StepLimit,
+  /**
+   * @brief The simulation finished and cannot step forward anymore.
+   */
+  Finished,
+  /**
+   * @brief An assertion failed.
+   */
+  AssertionFailed,
+  /**
+   * @brief A breakpoint was hit.
+   */
+  BreakpointHit
+};
+
+/**
+ * @brief Steps the simulation forward until the given number of steps was
+ * executed or one of the given stop reasons occurs.
+ *
+ * This runs the full loop in C++, so that scripted drivers do not have to
+ * cross the binding layer several times per instruction.
+ * @param self The simulation state to step.
+ * @param count The maximum number of steps to execute.
+ * @param stopOn The reasons, in addition to the end of the simulation, that
+ * stop the execution.
+ * @param trace Stores the instruction executed by each step.
+ * @return The reason why the execution stopped.
+ */
+StopReason stepMany(SimulationState* self, size_t count,
+                    const std::vector<StopReason>& stopOn,
+                    std::vector<size_t>& trace) {
+  const auto stopOnAssertions =
+      std::find(stopOn.begin(), stopOn.end(), StopReason::AssertionFailed) !=
+      stopOn.end();
+  const auto stopOnBreakpoints =
+      std::find(stopOn.begin(), stopOn.end(), StopReason::BreakpointHit) !=
+      stopOn.end();
+  for (size_t step = 0; step < count; step++) {
+    if (!self->canStepForward(self)) {
+      return StopReason::Finished;
+    }
+    trace.push_back(self->getCurrentInstruction(self));
+    checkOrThrow(self->stepForward(self));
+    if (stopOnAssertions && self->didAssertionFail(self)) {
+      return StopReason::AssertionFailed;
+    }
+    if (stopOnBreakpoints && self->wasBreakpointHit(self)) {
+      return StopReason::BreakpointHit;
+    }
+  }
+  return self->canStepForward(self) ? StopReason::StepLimit
+                                    : StopReason::Finished;
+}
+
+static_assert(sizeof(Complex) == sizeof(std::complex<double>),
+              "Complex must have the same layout as std::complex<double>");
+
+/**
+ * @brief Gets a NumPy array that can hold the given number of amplitudes.
+ *
+ * If the caller provided an output array, it is validated and reused, so that
+ * no new memory has to be allocated. Otherwise, a new array is allocated.
+ * @param out The output array provided by the caller, if any.
+ * @param numStates The number of amplitudes the array has to hold.
+ * @return The array to store the amplitudes in.
+ */
+py::array getAmplitudeArray(const std::optional<py::array>& out,
+                            size_t numStates) {
+  if (!out.has_value()) {
+    return py::array_t<std::complex<double>>(
+        static_cast<py::ssize_t>(numStates));
+  }
+  const auto& array = *out;
+  if (!py::isinstance<py::array_t<std::complex<double>>>(array) ||
+      (array.flags() & py::array::c_style) == 0 || !array.writeable() ||
+      static_cast<size_t>(array.size()) != numStates) {
+    throw py::value_error("The output array must be a writeable, contiguous "
+                          "complex128 array with " +
+                          std::to_string(numStates) + " elements");
+  }
+  return array;
+}
+
+/**
+ * @brief Gets the amplitudes stored in a NumPy array as a `Complex` pointer.
+ *
+ * This allows the backend to write the amplitudes directly into the memory of
+ * the array.
+ * @param array The array of `complex128` amplitudes.
+ * @return A pointer to the first amplitude of the array.
+ */
+Complex* getAmplitudeData(py::array& array) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return reinterpret_cast<Complex*>(array.mutable_data());
+}
+
 void bindFramework(py::module& m) {
   // Bind the VariableType enum
   py::enum_<VariableType>(m, "VariableType")
@@ -52,6 +159,32 @@ void bindFramework(py::module& m) {
       .value("VarFloat", VarFloat, "A floating-point variable.")
       .export_values();
 
+  // Bind the StopReason enum
+  py::enum_<StopReason>(m, "StopReason")
+      .value("StepLimit", StopReason::StepLimit,
+             "The requested number of steps was executed.")
+      .value("Finished", StopReason::Finished,
+             "The simulation finished and cannot step forward anymore.")
+      .value("AssertionFailed", StopReason::AssertionFailed,
+             "An assertion failed.")
+      .value("BreakpointHit", StopReason::BreakpointHit,
+             "A breakpoint was hit.");
+
+  // Bind the TraceEventType enum
+  py::enum_<TraceEventType>(m, "TraceEventType")
+      .value("TraceStepForward", TraceStepForward,
+             "An instruction was executed.")
+      .value("TraceStepBackward", TraceStepBackward,
+             "An instruction was reverted.")
+      .value("TraceCall", TraceCall, "A custom gate was called.")
+      .value("TraceReturn", TraceReturn,
+             "A custom gate returned to its caller.")
+      .value("TraceMeasurement", TraceMeasurement, "A qubit was measured.")
+      .value("TraceNodeCount", TraceNodeCount,
+             "The number of nodes of the decision diagram representing the "
+             "state.")
+      .export_values();
+
   // Bind the VariableValue union
   py::class_<VariableValue>(m, "VariableValue")
       .def(py::init<>())
@@ -126,6 +259,141 @@ This is always equal to 2^`num_qubits`.)")
 Contains one element for each of the `num_states` states in the state vector.)")
       .doc() = "Represents a state vector.";
 
+  // Bind the Metrics struct
+  py::class_<Metrics>(m, "Metrics")
+      .def(py::init<>(), "Creates a new `Metrics` instance.")
+      .def_readwrite("dd_multiplications", &Metrics::ddMultiplications,
+                     "The number of decision diagram multiplications applying "
+                     "an operation to the state.")
+      .def_readwrite("garbage_collections", &Metrics::garbageCollections,
+                     "The number of garbage collections that freed unused "
+                     "nodes.")
+      .def_readwrite("garbage_collection_time", &Metrics::garbageCollectionTime,
+                     "The total time spent in garbage collections.")
+      .def_readwrite("entanglement_assertion_checks",
+                     &Metrics::entanglementAssertionChecks,
+                     "The number of checked entanglement assertions.")
+      .def_readwrite("entanglement_assertion_time",
+                     &Metrics::entanglementAssertionTime,
+                     "The total time spent checking entanglement assertions.")
+      .def_readwrite("superposition_assertion_checks",
+                     &Metrics::superpositionAssertionChecks,
+                     "The number of checked superposition assertions.")
+      .def_readwrite("superposition_assertion_time",
+                     &Metrics::superpositionAssertionTime,
+                     "The total time spent checking superposition assertions.")
+      .def_readwrite("statevector_equality_assertion_checks",
+                     &Metrics::statevectorEqualityAssertionChecks,
+                     "The number of checked equality assertions against a "
+                     "state vector.")
+      .def_readwrite("statevector_equality_assertion_time",
+                     &Metrics::statevectorEqualityAssertionTime,
+                     "The total time spent checking equality assertions "
+                     "against a state vector.")
+      .def_readwrite("circuit_equality_assertion_checks",
+                     &Metrics::circuitEqualityAssertionChecks,
+                     "The number of checked equality assertions against a "
+                     "circuit.")
+      .def_readwrite("circuit_equality_assertion_time",
+                     &Metrics::circuitEqualityAssertionTime,
+                     "The total time spent checking equality assertions "
+                     "against a circuit, including the simulation of the "
+                     "reference circuits.")
+      .def_readwrite("assertion_cache_hits", &Metrics::assertionCacheHits,
+                     "The number of assertion checks answered by cached "
+                     "outcomes.")
+      .def_readwrite("assertion_cache_misses", &Metrics::assertionCacheMisses,
+                     "The number of assertion checks that had to be computed.")
+      .def_readwrite("state_vector_expansions", &Metrics::stateVectorExpansions,
+                     "The number of times the full state vector was computed "
+                     "from the decision diagram.")
+      .def_readwrite("state_vector_expansion_amplitudes",
+                     &Metrics::stateVectorExpansionAmplitudes,
+                     "The total number of amplitudes computed by state vector "
+                     "expansions.")
+      .def_readwrite("diagnostics_callbacks", &Metrics::diagnosticsCallbacks,
+                     "The number of diagnostics callbacks invoked while "
+                     "stepping through the program.")
+      .def_readwrite("diagnostics_callback_time",
+                     &Metrics::diagnosticsCallbackTime,
+                     "The total time spent in diagnostics callbacks.")
+      .def_readwrite("code_loads", &Metrics::codeLoads,
+                     "The number of loaded programs.")
+      .def_readwrite("preprocessing_time", &Metrics::preprocessingTime,
+                     "The total time spent preprocessing loaded code.")
+      .def_readwrite("circuit_construction_time",
+                     &Metrics::circuitConstructionTime,
+                     "The total time spent building the quantum computation of "
+                     "loaded code.")
+      .doc() = R"(Counters and timers describing the work of a simulation state.
+
+They accumulate over all loaded programs until they are reset. All times are
+given in nanoseconds.)";
+
+  // Bind the MemoryStatistics struct
+  py::class_<MemoryStatistics>(m, "MemoryStatistics")
+      .def(py::init<>(), "Creates a new `MemoryStatistics` instance.")
+      .def_readwrite("vector_nodes", &MemoryStatistics::vectorNodes,
+                     "The number of vector nodes stored in the unique table, "
+                     "including unused nodes that were not yet collected.")
+      .def_readwrite("active_vector_nodes",
+                     &MemoryStatistics::activeVectorNodes,
+                     "The number of vector nodes that are currently "
+                     "referenced.")
+      .def_readwrite("peak_active_vector_nodes",
+                     &MemoryStatistics::peakActiveVectorNodes,
+                     "The largest number of vector nodes that were referenced "
+                     "at the same time.")
+      .def_readwrite("matrix_nodes", &MemoryStatistics::matrixNodes,
+                     "The number of matrix nodes stored in the unique table, "
+                     "including unused nodes that were not yet collected.")
+      .def_readwrite("active_matrix_nodes",
+                     &MemoryStatistics::activeMatrixNodes,
+                     "The number of matrix nodes that are currently "
+                     "referenced.")
+      .def_readwrite("node_memory", &MemoryStatistics::nodeMemory,
+                     "The number of bytes used by all stored vector and matrix "
+                     "nodes.")
+      .def_readwrite("package_memory", &MemoryStatistics::packageMemory,
+                     "The number of bytes used by the decision diagram "
+                     "package, including the nodes and numbers in use, the "
+                     "unique tables, and the compute tables.")
+      .def_readwrite("memory_budget", &MemoryStatistics::memoryBudget,
+                     "The number of bytes the decision diagram package may "
+                     "use, or 0 if there is no limit.")
+      .def_readwrite("budget_collections", &MemoryStatistics::budgetCollections,
+                     "The number of times exceeding the memory budget forced a "
+                     "garbage collection.")
+      .def_readwrite("budget_exceeded", &MemoryStatistics::budgetExceeded,
+                     "Whether the last step was refused because the decision "
+                     "diagram package exceeded the memory budget.")
+      .def_readwrite("multiplication_table_entries",
+                     &MemoryStatistics::multiplicationTableEntries,
+                     "The number of entries in the compute table of "
+                     "matrix-vector multiplications.")
+      .def_readwrite("multiplication_table_buckets",
+                     &MemoryStatistics::multiplicationTableBuckets,
+                     "The number of buckets of the compute table of "
+                     "matrix-vector multiplications.")
+      .def_readwrite("multiplication_table_hit_ratio",
+                     &MemoryStatistics::multiplicationTableHitRatio,
+                     "The ratio of lookups in the compute table of "
+                     "matrix-vector multiplications that found a result.")
+      .def_readwrite("addition_table_entries",
+                     &MemoryStatistics::additionTableEntries,
+                     "The number of entries in the compute table of vector "
+                     "additions.")
+      .def_readwrite("addition_table_buckets",
+                     &MemoryStatistics::additionTableBuckets,
+                     "The number of buckets of the compute table of vector "
+                     "additions.")
+      .def_readwrite("addition_table_hit_ratio",
+                     &MemoryStatistics::additionTableHitRatio,
+                     "The ratio of lookups in the compute table of vector "
+                     "additions that found a result.")
+      .doc() = "Describes the memory used by the decision diagrams of a "
+               "simulation state.";
+
   py::class_<SimulationState>(m, "SimulationState")
       .def(py::init<>(), "Creates a new `SimulationState` instance.")
       .def(
@@ -140,15 +408,62 @@ Contains one element for each of the `num_states` states in the state vector.)")
 
 Args:
     code (str): The code to load.)")
+      .def(
+          "reload_code",
+          [](SimulationState* self, const char* code) {
+            checkOrThrow(self->reloadCode(self, code));
+          },
+          R"(Loads an edited version of the current code into the simulation state.
+
+Unlike `load_code`, this reuses results for the unchanged beginning of the code. If instructions executed so far were changed, the simulation first steps back to the last unchanged one, and then continues from there. The diagnostics data of unchanged instructions is kept as well. If no code was loaded before, it behaves like `load_code`.
+
+Args:
+    code (str): The edited code to load.)")
       .def(
           "step_forward",
           [](SimulationState* self) { checkOrThrow(self->stepForward(self)); },
           "Steps the simulation forward by one instruction.")
+      .def(
+          "step_many",
+          [](SimulationState* self, size_t count,
+             const std::optional<std::vector<StopReason>>& stopOn) {
+            std::vector<size_t> trace;
+            const auto stopReasons = stopOn.value_or(std::vector<StopReason>{
+                StopReason::AssertionFailed, StopReason::BreakpointHit});
+            StopReason reason{};
+            {
+              const py::gil_scoped_release release;
+              reason = stepMany(self, count, stopReasons, trace);
+            }
+            return py::make_tuple(
+                py::array_t<size_t>(static_cast<py::ssize_t>(trace.size()),
+                                    trace.data()),
+                reason);
+          },
+          py::arg("count"), py::arg("stop_on") = py::none(),
+          R"(Steps the simulation forward by up to `count` instructions.
+
+All steps are executed in a single call, which avoids the overhead of
+calling `step_forward` and checking the simulation state from Python after
+every instruction. The execution stops early if the simulation finishes or
+if one of the reasons given in `stop_on` occurs.
+
+Args:
+    count (int): The maximum number of steps to execute.
+    stop_on (list[StopReason] | None): The reasons that stop the execution
+        early. Only `StopReason.AssertionFailed` and
+        `StopReason.BreakpointHit` have an effect, as the execution always
+        stops when the simulation finishes. Defaults to both of them.
+
+Returns:
+    tuple[numpy.ndarray, StopReason]: The indices of the executed
+    instructions, in order, and the reason why the execution stopped.)")
       .def(
           "step_over_forward",
           [](SimulationState* self) {
             checkOrThrow(self->stepOverForward(self));
           },
+          py::call_guard<py::gil_scoped_release>(),
           "Steps the simulation forward by one instruction, skipping over "
           "possible custom gate calls.")
       .def(
@@ -156,6 +471,7 @@ Args:
           [](SimulationState* self) {
             checkOrThrow(self->stepOutForward(self));
           },
+          py::call_guard<py::gil_scoped_release>(),
           "Steps the simulation forward until the current custom gate call "
           "returns.")
       .def(
@@ -167,6 +483,7 @@ Args:
           [](SimulationState* self) {
             checkOrThrow(self->stepOverBackward(self));
           },
+          py::call_guard<py::gil_scoped_release>(),
           "Steps the simulation backward by one instruction, skipping over "
           "possible custom gate calls.")
       .def(
@@ -174,6 +491,7 @@ Args:
           [](SimulationState* self) {
             checkOrThrow(self->stepOutBackward(self));
           },
+          py::call_guard<py::gil_scoped_release>(),
           "Steps the simulation backward until the instruction calling the "
           "current custom gate is encountered.")
       .def(
@@ -183,6 +501,7 @@ Args:
             checkOrThrow(self->runAll(self, &errors));
             return errors;
           },
+          py::call_guard<py::gil_scoped_release>(),
           R"(Runs the simulation until it finishes, even if assertions fail.
 
 Returns:
@@ -192,6 +511,7 @@ int: The number of assertions that failed during execution.)")
           [](SimulationState* self) {
             checkOrThrow(self->runSimulation(self));
           },
+          py::call_guard<py::gil_scoped_release>(),
           R"(Runs the simulation until it finishes or an assertion fails.
 
 If an assertion fails, the simulation stops and the `did_assertion_fail`
@@ -201,6 +521,7 @@ method will return `True`.)")
           [](SimulationState* self) {
             checkOrThrow(self->runSimulationBackward(self));
           },
+          py::call_guard<py::gil_scoped_release>(),
           "Runs the simulation backward until it finishes or an assertion "
           "fails.")
       .def(
@@ -221,6 +542,8 @@ start of the code.)")
 
 If the simulation is running in a concurrent thread, the execution will
 stop as soon as possible, but it is not guaranteed to stop immediately.
+The methods that run or step over several instructions release the GIL,
+so that a concurrent Python thread can call this method meanwhile.
 
 If the simulation is not running, then the next call to continue the
 simulation will stop as soon as possible. `step over` and `step out`
@@ -308,6 +631,64 @@ Args:
 
 Returns:
     tuple[int, int]: The start and end positions of the instruction.)")
+      .def(
+          "get_instruction_positions",
+          [](SimulationState* self) {
+            const auto count = self->getInstructionCount(self);
+            std::vector<size_t> starts(count);
+            std::vector<size_t> ends(count);
+            checkOrThrow(self->getInstructionPositions(self, count,
+                                                       starts.data(),
+                                                       ends.data()));
+            std::vector<std::pair<size_t, size_t>> positions;
+            positions.reserve(count);
+            for (size_t i = 0; i < count; i++) {
+              positions.emplace_back(starts[i], ends[i]);
+            }
+            return positions;
+          },
+          R"(Gets the positions of all instructions in the code.
+
+This returns the same positions as `get_instruction_position` for each
+instruction, but only requires a single call.
+
+Returns:
+    list[tuple[int, int]]: The start and end positions of each instruction.)")
+      .def(
+          "get_code_coordinates",
+          [](SimulationState* self, size_t position) {
+            size_t line = 0;
+            size_t column = 0;
+            checkOrThrow(
+                self->getCodeCoordinates(self, position, &line, &column));
+            return std::make_pair(line, column);
+          },
+          R"(Converts a position in the loaded code to a line and column.
+
+The start of each line is determined once when the code is loaded, so each
+conversion only requires a binary search. A line break belongs to the line
+it ends.
+
+Args:
+    position (int): The 0-indexed position in the code.
+
+Returns:
+    tuple[int, int]: The 0-indexed line and column.)")
+      .def(
+          "get_code_position",
+          [](SimulationState* self, size_t line, size_t column) {
+            size_t position = 0;
+            checkOrThrow(self->getCodePosition(self, line, column, &position));
+            return position;
+          },
+          R"(Converts a line and column in the loaded code to a position.
+
+Args:
+    line (int): The 0-indexed line.
+    column (int): The 0-indexed column.
+
+Returns:
+    int: The 0-indexed position in the code.)")
       .def(
           "get_num_qubits",
           [](SimulationState* self) { return self->getNumQubits(self); },
@@ -403,8 +784,8 @@ Returns:
           "get_state_vector_full",
           [](SimulationState* self) {
             const size_t numQubits = self->getNumQubits(self);
-            const std::vector<Complex> amplitudes(1 << numQubits);
-            StatevectorCPP result{numQubits, 1ULL << numQubits, amplitudes};
+            StatevectorCPP result{numQubits, 1ULL << numQubits,
+                                  std::vector<Complex>(1ULL << numQubits)};
             Statevector output{numQubits, result.numStates,
                                result.amplitudes.data()};
             checkOrThrow(self->getStateVectorFull(self, &output));
@@ -421,8 +802,8 @@ Returns:
           "get_state_vector_sub",
           [](SimulationState* self, std::vector<size_t> qubits) {
             const size_t numQubits = qubits.size();
-            const std::vector<Complex> amplitudes(1 << numQubits);
-            StatevectorCPP result{numQubits, 1ULL << numQubits, amplitudes};
+            StatevectorCPP result{numQubits, 1ULL << numQubits,
+                                  std::vector<Complex>(1ULL << numQubits)};
             Statevector output{numQubits, result.numStates,
                                result.amplitudes.data()};
             checkOrThrow(self->getStateVectorSub(self, numQubits, qubits.data(),
@@ -442,6 +823,57 @@ Args:
 
 Returns:
     Statevector: The sub-state vector of the current simulation state.)")
+      .def(
+          "get_state_vector_full_array",
+          [](SimulationState* self, const std::optional<py::array>& out) {
+            const size_t numQubits = self->getNumQubits(self);
+            auto result = getAmplitudeArray(out, 1ULL << numQubits);
+            Statevector output{numQubits, 1ULL << numQubits,
+                               getAmplitudeData(result)};
+            checkOrThrow(self->getStateVectorFull(self, &output));
+            return result;
+          },
+          py::arg("out") = py::none(),
+          R"(Gets the full state vector of the simulation at the current time as a NumPy array.
+
+The amplitudes are written directly into the memory of the returned
+`complex128` array, without creating a Python object per amplitude. To avoid
+allocating a new array in every call, an existing array can be passed as
+`out`. It must be a writeable, contiguous `complex128` array with one
+element per amplitude.
+
+Args:
+    out (numpy.ndarray | None): An optional array to store the amplitudes in.
+
+Returns:
+    numpy.ndarray: The amplitudes of the full state vector.)")
+      .def(
+          "get_state_vector_sub_array",
+          [](SimulationState* self, std::vector<size_t> qubits,
+             const std::optional<py::array>& out) {
+            const size_t numQubits = qubits.size();
+            auto result = getAmplitudeArray(out, 1ULL << numQubits);
+            Statevector output{numQubits, 1ULL << numQubits,
+                               getAmplitudeData(result)};
+            checkOrThrow(self->getStateVectorSub(self, numQubits, qubits.data(),
+                                                 &output));
+            return result;
+          },
+          py::arg("qubits"), py::arg("out") = py::none(),
+          R"(Gets a sub-state of the state vector of the simulation at the current time as a NumPy array.
+
+The amplitudes are written directly into the memory of the returned
+`complex128` array, without creating a Python object per amplitude. To avoid
+allocating a new array in every call, an existing array can be passed as
+`out`. It must be a writeable, contiguous `complex128` array with one
+element per amplitude.
+
+Args:
+    qubits (list[int]): The qubits to include in the sub-state.
+    out (numpy.ndarray | None): An optional array to store the amplitudes in.
+
+Returns:
+    numpy.ndarray: The amplitudes of the sub-state vector.)")
       .def(
           "set_breakpoint",
           [](SimulationState* self, size_t desiredPosition) {
@@ -460,6 +892,61 @@ Args:
 
 Returns:
     int: The index of the instruction where the breakpoint was set.)")
+      .def(
+          "set_breakpoints",
+          [](SimulationState* self,
+             const std::vector<size_t>& desiredPositions) {
+            std::vector<size_t> targets(desiredPositions.size());
+            checkOrThrow(self->setBreakpoints(self, desiredPositions.data(),
+                                              desiredPositions.size(),
+                                              targets.data()));
+            std::vector<std::optional<size_t>> result(targets.size());
+            std::transform(targets.begin(), targets.end(), result.begin(),
+                           [](size_t target) -> std::optional<size_t> {
+                             if (target == -1ULL) {
+                               return std::nullopt;
+                             }
+                             return target;
+                           });
+            return result;
+          },
+          R"(Sets breakpoints at multiple desired positions in the code.
+
+The positions are given as 0-indexed character positions in the full code
+string. Setting many breakpoints at once is faster than calling
+`set_breakpoint` for each of them.
+
+Args:
+    desired_positions (list[int]): The positions in the code to set the breakpoints.
+
+Returns:
+    list[int | None]: For each position, the index of the instruction where the breakpoint was set, or `None` if no breakpoint could be set at that position.)")
+      .def(
+          "set_breakpoint_condition",
+          [](SimulationState* self, size_t instruction,
+             const std::optional<std::string>& condition,
+             const std::optional<std::string>& hitCondition) {
+            checkOrThrow(self->setBreakpointCondition(
+                self, instruction,
+                condition.has_value() ? condition->c_str() : nullptr,
+                hitCondition.has_value() ? hitCondition->c_str() : nullptr));
+          },
+          py::arg("instruction"), py::arg("condition") = py::none(),
+          py::arg("hit_condition") = py::none(),
+          R"(Attaches conditions to the breakpoint at the given instruction.
+
+The condition compares a classical bit (`c[0] == 1`), a classical register
+(`c >= 2`), or the probability of measuring a qubit in the state |1>
+(`P(q[0]) > 0.5`) to a value. The hit condition compares the number of times
+the breakpoint was reached since the last reset to a number (`>= 3`) or checks
+whether it is a multiple of a number (`% 2`). The breakpoint is only hit if
+both conditions hold. Passing no conditions removes all conditions from the
+breakpoint.
+
+Args:
+    instruction (int): The instruction of the breakpoint.
+    condition (str | None): The condition on the state of the simulation.
+    hit_condition (str | None): The condition on the hit count of the breakpoint.)")
       .def(
           "clear_breakpoints",
           [](SimulationState* self) {
@@ -501,6 +988,103 @@ Args:
 
 Returns:
     list[int]: The stack trace of the simulation.)")
+      .def(
+          "set_trace_capacity",
+          [](SimulationState* self, size_t capacity, bool recordNodeCounts) {
+            checkOrThrow(
+                self->setTraceCapacity(self, capacity, recordNodeCounts));
+          },
+          py::arg("capacity"), py::arg("record_node_counts") = false,
+          R"(Sets the number of events kept in the execution trace.
+
+While tracing is enabled, each step records its instruction, custom gate
+calls and returns, and measurement outcomes. The memory for the trace is
+allocated once, and when it is full, each new event replaces the oldest
+one.
+
+The trace is cleared when the simulation is reset or new code is loaded.
+Setting the capacity also clears it.
+
+Args:
+    capacity (int): The maximum number of events to keep, or 0 to disable
+        tracing.
+    record_node_counts (bool): Whether to also record the number of nodes of
+        the decision diagram after each step that changes the state.)")
+      .def(
+          "get_trace",
+          [](SimulationState* self) {
+            const auto length = self->getTraceLength(self);
+            std::vector<TraceEvent> events(length);
+            checkOrThrow(self->getTrace(self, 0, length, events.data()));
+            py::array_t<size_t> result(
+                {static_cast<py::ssize_t>(length), py::ssize_t{3}});
+            auto data = result.mutable_unchecked<2>();
+            for (size_t i = 0; i < length; i++) {
+              const auto row = static_cast<py::ssize_t>(i);
+              data(row, 0) = static_cast<size_t>(events[i].type);
+              data(row, 1) = events[i].instruction;
+              data(row, 2) = events[i].value;
+            }
+            return result;
+          },
+          R"(Gets the events stored in the execution trace.
+
+Each row of the returned array represents one event, from the oldest to the
+most recent one. The columns contain the `TraceEventType` of the event as an
+integer, the instruction the event refers to, and a value that depends on
+the type of the event.
+
+Returns:
+    numpy.ndarray: The events of the trace, with shape `(n, 3)`.)")
+      .def(
+          "get_metrics",
+          [](SimulationState* self) {
+            Metrics metrics{};
+            checkOrThrow(self->getMetrics(self, &metrics));
+            return metrics;
+          },
+          R"(Gets the counters and timers describing the work performed so far.
+
+They accumulate over all loaded programs until they are reset, so that slow
+sessions can be attributed to the responsible subsystem.
+
+Returns:
+    Metrics: The current metrics of the simulation state.)")
+      .def(
+          "reset_metrics",
+          [](SimulationState* self) { checkOrThrow(self->resetMetrics(self)); },
+          "Resets all counters and timers to zero.")
+      .def(
+          "get_memory_statistics",
+          [](SimulationState* self) {
+            MemoryStatistics statistics{};
+            checkOrThrow(self->getMemoryStatistics(self, &statistics));
+            return statistics;
+          },
+          R"(Gets the memory used by the decision diagrams of the simulation.
+
+Returns:
+    MemoryStatistics: The node counts, memory usage, and compute table
+        statistics of the simulation.)")
+      .def(
+          "set_memory_budget",
+          [](SimulationState* self, size_t bytes) {
+            checkOrThrow(self->setMemoryBudget(self, bytes));
+          },
+          py::arg("budget"),
+          R"(Limits the memory used by the decision diagrams of the simulation.
+
+Before a step applies an operation, the memory of the decision diagram package
+is compared to the budget. If it exceeds the budget, the compute tables are
+flushed, the states cached for assertions are released, and a garbage
+collection is forced. If the package still exceeds the budget afterwards, the
+step is refused without changing the state and raises an error, and
+`budget_exceeded` is set in the memory statistics, so that running the
+simulation stops before the process runs out of memory.
+
+Args:
+    budget (int): The number of bytes the decision diagram package may use, or
+        0 to remove the limit.)")
       .def(
           "get_diagnostics",
           [](SimulationState* self) { return self->getDiagnostics(self); },
@@ -536,6 +1120,24 @@ void bindDiagnostics(py::module& m) {
                      "The type of the potential error cause.")
       .doc() = "Represents a potential cause of an assertion error.";
 
+  // Bind the DiagnosticsStatistics struct
+  py::class_<DiagnosticsStatistics>(m, "DiagnosticsStatistics")
+      .def(py::init<>())
+      .def_readwrite("distinct_qubit_tuples",
+                     &DiagnosticsStatistics::distinctQubitTuples,
+                     "The number of distinct qubit tuples targeted by "
+                     "instructions at runtime.")
+      .def_readwrite("qubit_usage_entries",
+                     &DiagnosticsStatistics::qubitUsageEntries,
+                     "The number of distinct (instruction, qubit tuple) pairs "
+                     "recorded at runtime.")
+      .def_readwrite("qubit_usage_bytes",
+                     &DiagnosticsStatistics::qubitUsageBytes,
+                     "The approximate number of bytes used to store the "
+                     "runtime qubit usage.")
+      .doc() = "Represents statistics about the runtime data collected by the "
+               "diagnostics.";
+
   py::class_<Diagnostics>(m, "Diagnostics")
       .def(py::init<>(), "Creates a new `Diagnostics` instance.")
       .def(
@@ -677,6 +1279,48 @@ an assertion error.
 
 Returns:
    list[ErrorCause]: A list of potential error causes encountered during execution.)")
+      .def(
+          "potential_error_causes_all",
+          [](Diagnostics* self) {
+            size_t nextSize = 10;
+            while (true) {
+              std::vector<ErrorCause> output(nextSize);
+              const auto actualSize =
+                  self->potentialErrorCausesAll(self, output.data(), nextSize);
+              if (actualSize < nextSize) {
+                output.resize(actualSize);
+                return output;
+              }
+              nextSize = nextSize * 2;
+            }
+          },
+          R"(Extract a ranked list of potential error causes for all assertions that failed during the last `run_all` call.
+
+Each error cause is only reported once, even if it explains several failed
+assertions. Error causes that explain failures at more call sites are reported
+first. A call site is a failed assertion together with the custom gate calls it
+was reached through, so an assertion inside a custom gate counts once for each
+call it failed in.
+
+This method should be run after the program has been executed using
+`run_all`.
+
+Returns:
+   list[ErrorCause]: A ranked list of potential error causes for all failed assertions.)")
+      .def(
+          "get_statistics",
+          [](Diagnostics* self) {
+            DiagnosticsStatistics statistics{};
+            checkOrThrow(self->getStatistics(self, &statistics));
+            return statistics;
+          },
+          R"(Get statistics about the runtime data collected by the diagnostics.
+
+This can be used to monitor the memory consumption of the dynamic analysis
+methods.
+
+Returns:
+   DiagnosticsStatistics: The statistics of the diagnostics instance.)")
       .doc() = "Provides diagnostics capabilities such as different analysis "
                "methods for the debugger.";
 }
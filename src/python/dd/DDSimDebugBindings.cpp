@@ -8,10 +8,13 @@
 
 #include "python/dd/DDSimDebugBindings.hpp"
 
+#include "backend/dd/DDPackage.hpp"
 #include "backend/dd/DDSimDebug.hpp"
 #include "backend/debug.h"
 #include "pybind11/pybind11.h"
 
+#include <cstddef>
+
 void bindBackend(pybind11::module& m) {
 
   m.def(
@@ -38,4 +41,21 @@ Returns:
 
 Args:
     state (SimulationState): The simulation state to delete.)");
+
+  m.def("set_dd_package_pool_capacity", &setDDPackagePoolCapacity,
+        pybind11::arg("capacity"),
+        R"(Set the number of DD packages of deleted simulation states kept for reuse.
+
+New simulation states take their DD package from the pool if it is not
+empty, so that the nodes and tables allocated by previous sessions do not have
+to be allocated again. The capacity is 0 by default.
+
+Args:
+    capacity (int): The maximum number of packages kept in the pool.)");
+
+  m.def("get_dd_package_pool_size", &getDDPackagePoolSize,
+        R"(Get the number of DD packages currently kept for reuse.
+
+Returns:
+    int: The number of packages in the pool.)");
 }
@@ -0,0 +1,11 @@
+gate check_pair a, b {                          // 0
+    assert-ent a, b;                            // 1 (fails for both calls)
+}                                               // 2
+
+qreg q[3];                                      // 3
+
+h q[0];                                         // 4
+check_pair q[0], q[1];                          // 5
+check_pair q[0], q[2];                          // 6
+
+assert-ent q[1], q[2];                          // 7 (fails)
@@ -0,0 +1,7 @@
+qreg q[3];                      // 0
+
+h q[0];                         // 1
+cx q[2], q[1];                  // 2
+
+assert-ent q[0], q[1];          // 3 (fails)
+assert-sup q[1];                // 4 (fails)
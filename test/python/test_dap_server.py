@@ -0,0 +1,260 @@
+"""Tests the message handling of the DAP server."""
+
+from __future__ import annotations
+
+import json
+import socket
+import threading
+from typing import TYPE_CHECKING, Any
+
+import pytest
+
+from mqt.debugger.dap import DAPServer
+from mqt.debugger.dap.message_parser import DAPMessageParser
+
+if TYPE_CHECKING:
+    from collections.abc import Callable
+    from pathlib import Path
+
+
+def encode(message: dict[str, Any]) -> bytes:
+    """Encode a message according to the DAP messaging protocol.
+
+    Args:
+        message (dict[str, Any]): The message to encode.
+
+    Returns:
+        bytes: The encoded message, including its header.
+    """
+    body = json.dumps(message).encode("utf-8")
+    return f"Content-Length: {len(body)}\r\n\r\n".encode("ascii") + body
+
+
+def test_parse_split_messages() -> None:
+    """Test parsing messages that arrive in chunks of a single byte."""
+    first = {"seq": 1, "type": "request", "command": "threads"}
+    second = {"seq": 2, "type": "request", "command": "launch", "arguments": {"program": "ä" * 5000}}
+    data = encode(first) + encode(second)
+    parser = DAPMessageParser()
+    messages: list[dict[str, Any]] = []
+    for i in range(len(data)):
+        messages.extend(parser.feed(data[i : i + 1]))
+    assert messages == [first, second]
+    assert not parser.buffer
+
+
+def test_parse_multiple_messages_at_once() -> None:
+    """Test parsing several messages that arrive in a single chunk."""
+    messages = [{"seq": i, "type": "request", "command": "next"} for i in range(10)]
+    parser = DAPMessageParser()
+    assert parser.feed(b"".join(encode(message) for message in messages)) == messages
+
+
+def test_parse_invalid_header() -> None:
+    """Test that a header without a content length is rejected."""
+    parser = DAPMessageParser()
+    with pytest.raises(ValueError, match="Invalid DAP message header"):
+        parser.feed(b"Content-Type: application/json\r\n\r\n{}")
+
+
+def test_immediate_request() -> None:
+    """Test that a 'threads' request sent in small pieces is answered by the server."""
+    server = DAPServer()
+    server_socket, client_socket = socket.socketpair()
+    thread = threading.Thread(target=server.handle_client, args=(server_socket,))
+    thread.start()
+
+    data = encode({"seq": 1, "type": "request", "command": "threads"})
+    for i in range(0, len(data), 7):
+        client_socket.sendall(data[i : i + 7])
+    parser = DAPMessageParser()
+    responses: list[dict[str, Any]] = []
+    while not responses:
+        responses = parser.feed(client_socket.recv(1024))
+    client_socket.close()
+    thread.join()
+    server_socket.close()
+
+    assert responses[0]["request_seq"] == 1
+    assert responses[0]["success"]
+    assert responses[0]["body"]["threads"] == [{"id": 1, "name": "Main Thread"}]
+
+
+def run_session(server: DAPServer, send: Callable[[socket.socket], None]) -> list[dict[str, Any]]:
+    """Run a client session against the server and collect all messages it sends.
+
+    Args:
+        server (DAPServer): The server to connect to.
+        send (Callable[[socket.socket], None]): A function that receives the client socket and sends the requests of the session.
+
+    Returns:
+        list[dict[str, Any]]: The responses and events sent by the server, in the order they were received.
+    """
+    server_socket, client_socket = socket.socketpair()
+    thread = threading.Thread(target=server.handle_client, args=(server_socket,))
+    thread.start()
+    send(client_socket)
+    client_socket.shutdown(socket.SHUT_WR)
+    thread.join()
+    server_socket.close()
+    parser = DAPMessageParser()
+    messages: list[dict[str, Any]] = []
+    while data := client_socket.recv(1024):
+        messages.extend(parser.feed(data))
+    client_socket.close()
+    return messages
+
+
+def test_failing_request() -> None:
+    """Test that a request that cannot be handled is answered with an error and does not end the session."""
+    server = DAPServer()
+
+    def send(client: socket.socket) -> None:
+        client.sendall(encode({"seq": 1, "type": "request", "command": "unknown"}))
+        client.sendall(encode({"seq": 2, "type": "request", "command": "threads"}))
+
+    responses = {message["request_seq"]: message for message in run_session(server, send)}
+    assert not responses[1]["success"]
+    assert responses[1]["command"] == "unknown"
+    assert responses[1]["message"] == "Unsupported command: unknown"
+    assert responses[2]["success"]
+
+
+class PausableState:
+    """Records pause requests in place of a simulation state."""
+
+    paused: bool = False
+
+    def pause_simulation(self) -> None:
+        """Record that the simulation was paused."""
+        self.paused = True
+
+
+def test_pause_with_pending_requests() -> None:
+    """Test that a pause received while requests are pending is reported once, after the last of them."""
+    server = DAPServer()
+    server.simulation_state = PausableState()  # type: ignore[assignment]
+    started = threading.Event()
+    release = threading.Event()
+
+    def process_request(payload: dict[str, Any], connection: socket.socket) -> None:
+        started.set()
+        release.wait()
+        response = {"type": "response", "request_seq": payload["seq"], "success": True, "command": "next"}
+        connection.sendall(encode(response))
+
+    server.process_request = process_request  # type: ignore[method-assign]
+
+    def send(client: socket.socket) -> None:
+        client.sendall(encode({"seq": 1, "type": "request", "command": "next"}))
+        started.wait()
+        client.sendall(encode({"seq": 2, "type": "request", "command": "next"}))
+        client.sendall(encode({"seq": 3, "type": "request", "command": "pause"}))
+        parser = DAPMessageParser()
+        messages: list[dict[str, Any]] = []
+        try:
+            while not messages:
+                messages = parser.feed(client.recv(1024))
+        finally:
+            release.set()
+        assert messages == [{"type": "response", "request_seq": 3, "success": True, "command": "pause"}]
+
+    messages = run_session(server, send)
+    assert [message.get("request_seq", message.get("event")) for message in messages] == [1, 2, "stopped"]
+    assert messages[2]["body"]["reason"] == "pause"
+    assert server.simulation_state.paused
+
+
+class CodeState:
+    """Converts between positions and coordinates of a fixed code in place of a simulation state."""
+
+    line_starts: list[int]
+    length: int
+
+    def __init__(self, code: str) -> None:
+        """Determine the line starts of the code.
+
+        Args:
+            code (str): The loaded code.
+        """
+        self.line_starts = [0] + [i + 1 for i, c in enumerate(code) if c == "\n"]
+        self.length = len(code)
+
+    def get_code_coordinates(self, position: int) -> tuple[int, int]:
+        """Convert a position to a line and column, like `SimulationState.get_code_coordinates`.
+
+        Args:
+            position (int): The position.
+
+        Raises:
+            RuntimeError: If the position lies beyond the end of the code.
+
+        Returns:
+            tuple[int, int]: The line and column.
+        """
+        if position > self.length:
+            raise RuntimeError
+        line = max(i for i, start in enumerate(self.line_starts) if start <= position)
+        return (line, position - self.line_starts[line])
+
+    def get_code_position(self, line: int, column: int) -> int:
+        """Convert a line and column to a position, like `SimulationState.get_code_position`.
+
+        Args:
+            line (int): The line.
+            column (int): The column.
+
+        Raises:
+            RuntimeError: If the line or column lies outside of the code.
+
+        Returns:
+            int: The position.
+        """
+        if line >= len(self.line_starts):
+            raise RuntimeError
+        end = self.line_starts[line + 1] if line + 1 < len(self.line_starts) else self.length + 1
+        if self.line_starts[line] + column >= end:
+            raise RuntimeError
+        return self.line_starts[line] + column
+
+
+def test_stale_code_coordinates() -> None:
+    """Test that lines and columns outside of the loaded code are clamped instead of ending the session."""
+    code = "qreg q[2];\nh q[0];\n"
+    server = DAPServer()
+    server.simulation_state = CodeState(code)  # type: ignore[assignment]
+    server.source_code = code
+    assert server.code_coordinates_to_pos(2, 3) == 13
+    assert server.code_coordinates_to_pos(1, 100) == 10
+    assert server.code_coordinates_to_pos(3, 100) == len(code)
+    assert server.code_coordinates_to_pos(100, 1) == len(code)
+    assert server.code_pos_to_coordinates(13) == (2, 3)
+    assert server.code_pos_to_coordinates(1000) == (3, 1)
+
+
+def test_restart_reuses_assertion_results(tmp_path: Path) -> None:
+    """Test that restarting with an edited program starts over but reuses the results of unchanged assertions."""
+    program = tmp_path / "program.qasm"
+    program.write_text("qreg q[2];\nh q[0];\ncx q[0], q[1];\nassert-ent q[0], q[1];\nx q[1];\n")
+    server = DAPServer()
+    server.handle_command({"seq": 1, "type": "request", "command": "initialize", "arguments": {"adapterID": "mqtqasm"}})
+    server.handle_command({"seq": 2, "type": "request", "command": "launch", "arguments": {"program": str(program)}})
+    assert server.simulation_state.is_finished()
+
+    program.write_text("qreg q[2];\nh q[0];\ncx q[0], q[1];\nassert-ent q[0], q[1];\nz q[1];\n")
+    server.simulation_state.reset_metrics()
+    response, _ = server.handle_command({
+        "seq": 3,
+        "type": "request",
+        "command": "restart",
+        "arguments": {"arguments": {"program": str(program), "stopOnEntry": True}},
+    })
+    assert response["success"]
+    assert server.source_code.endswith("z q[1];\n")
+    assert server.simulation_state.get_current_instruction() == 0
+
+    server.simulation_state.run_simulation()
+    assert server.simulation_state.is_finished()
+    metrics = server.simulation_state.get_metrics()
+    assert metrics.assertion_cache_hits == 1
+    assert metrics.assertion_cache_misses == 0
@@ -9,6 +9,7 @@ import locale
 from pathlib import Path
 from typing import TYPE_CHECKING, cast
 
+import numpy as np
 import pytest
 
 import mqt.debugger
@@ -107,6 +108,102 @@ def test_current_instruction(simulation_instance: str, request: pytest.FixtureRe
     assert simulation_state.get_current_instruction() == 1
 
 
+def test_step_many(simulation_instance_ghz: SimulationInstance) -> None:
+    """Tests the `step_many()` method."""
+    (simulation_state, _state_id) = simulation_instance_ghz
+    trace, reason = simulation_state.step_many(2)
+    assert list(trace) == [0, 1]
+    assert reason == mqt.debugger.StopReason.StepLimit
+    trace, reason = simulation_state.step_many(100)
+    assert list(trace) == [2, 3, 4, 5]
+    assert reason == mqt.debugger.StopReason.AssertionFailed
+    assert simulation_state.get_current_instruction() == 5
+
+    simulation_state.reset_simulation()
+    simulation_state.set_breakpoint(30)
+    trace, reason = simulation_state.step_many(100)
+    assert list(trace) == [0, 1]
+    assert reason == mqt.debugger.StopReason.BreakpointHit
+    assert simulation_state.get_current_instruction() == 2
+
+    trace, reason = simulation_state.step_many(100, stop_on=[])
+    assert trace[-1] == 7
+    assert reason == mqt.debugger.StopReason.Finished
+    assert simulation_state.is_finished()
+    trace, reason = simulation_state.step_many(100)
+    assert len(trace) == 0
+    assert reason == mqt.debugger.StopReason.Finished
+
+
+def test_trace(simulation_instance_ghz: SimulationInstance) -> None:
+    """Tests the `set_trace_capacity()` and `get_trace()` methods."""
+    (simulation_state, _state_id) = simulation_instance_ghz
+    simulation_state.set_trace_capacity(100)
+    simulation_state.step_forward()
+    simulation_state.step_forward()
+    trace = simulation_state.get_trace()
+    assert trace.shape == (2, 3)
+    assert list(trace[:, 0]) == [mqt.debugger.TraceEventType.TraceStepForward.value] * 2
+    assert list(trace[:, 1]) == [0, 1]
+    simulation_state.set_trace_capacity(0)
+    assert simulation_state.get_trace().shape == (0, 3)
+
+
+def test_metrics(simulation_instance_ghz: SimulationInstance) -> None:
+    """Tests the `get_metrics()` and `reset_metrics()` methods."""
+    (simulation_state, _state_id) = simulation_instance_ghz
+    simulation_state.reset_metrics()
+    for _ in range(4):
+        simulation_state.step_forward()
+    metrics = simulation_state.get_metrics()
+    assert metrics.dd_multiplications == 3
+    assert metrics.diagnostics_callbacks == 4
+    assert metrics.code_loads == 0
+    simulation_state.reset_metrics()
+    assert simulation_state.get_metrics().dd_multiplications == 0
+
+
+def test_memory_budget(simulation_instance_ghz: SimulationInstance) -> None:
+    """Tests the `get_memory_statistics()` and `set_memory_budget()` methods."""
+    (simulation_state, _state_id) = simulation_instance_ghz
+    simulation_state.step_forward()
+    simulation_state.set_memory_budget(1)
+    instruction = simulation_state.get_current_instruction()
+    with pytest.raises(RuntimeError):
+        simulation_state.step_forward()
+    statistics = simulation_state.get_memory_statistics()
+    assert statistics.memory_budget == 1
+    assert statistics.budget_collections >= 1
+    assert statistics.budget_exceeded
+    assert statistics.node_memory > 1
+    assert statistics.package_memory > statistics.node_memory
+    assert simulation_state.get_current_instruction() == instruction
+    simulation_state.set_memory_budget(0)
+    simulation_state.step_forward()
+    statistics = simulation_state.get_memory_statistics()
+    assert statistics.memory_budget == 0
+    assert not statistics.budget_exceeded
+
+
+def test_dd_package_pool() -> None:
+    """Tests reusing DD packages through the package pool."""
+    mqt.debugger.set_dd_package_pool_capacity(1)
+    state = mqt.debugger.create_ddsim_simulation_state()
+    state.load_code("qreg q[1]; h q[0];")
+    state.run_simulation()
+    mqt.debugger.destroy_ddsim_simulation_state(state)
+    assert mqt.debugger.get_dd_package_pool_size() == 1
+
+    state = mqt.debugger.create_ddsim_simulation_state()
+    assert mqt.debugger.get_dd_package_pool_size() == 0
+    state.load_code("qreg q[1]; h q[0];")
+    state.run_simulation()
+    assert state.is_finished()
+    mqt.debugger.destroy_ddsim_simulation_state(state)
+    mqt.debugger.set_dd_package_pool_capacity(0)
+    assert mqt.debugger.get_dd_package_pool_size() == 0
+
+
 def test_step_out(simulation_instance_jumps: SimulationInstance) -> None:
     """Tests the `step_out()` methods."""
     (simulation_state, _state_id) = simulation_instance_jumps
@@ -171,6 +268,29 @@ def test_instruction_positions(simulation_instance_jumps: SimulationInstance) ->
     assert simulation_state.get_instruction_position(16) == (241, 254)
 
 
+def test_instruction_positions_bulk(simulation_instance_jumps: SimulationInstance) -> None:
+    """Tests the `get_instruction_positions()` method."""
+    (simulation_state, _state_id) = simulation_instance_jumps
+    positions = simulation_state.get_instruction_positions()
+    assert len(positions) == simulation_state.get_instruction_count()
+    assert positions == [
+        simulation_state.get_instruction_position(i) for i in range(simulation_state.get_instruction_count())
+    ]
+
+
+def test_code_coordinates(simulation_instance_jumps: SimulationInstance) -> None:
+    """Tests the `get_code_coordinates(position)` and `get_code_position(line, column)` methods."""
+    (simulation_state, _state_id) = simulation_instance_jumps
+    assert simulation_state.get_code_coordinates(0) == (0, 0)
+    for start, _end in simulation_state.get_instruction_positions():
+        line, column = simulation_state.get_code_coordinates(start)
+        assert simulation_state.get_code_position(line, column) == start
+    with pytest.raises(RuntimeError):
+        simulation_state.get_code_coordinates(1000000)
+    with pytest.raises(RuntimeError):
+        simulation_state.get_code_position(0, 1000000)
+
+
 @pytest.mark.parametrize(
     "simulation_instance", ["simulation_instance_ghz", "simulation_instance_jumps", "simulation_instance_classical"]
 )
@@ -223,6 +343,30 @@ def test_get_state_vector_sub(simulation_instance_classical: SimulationInstance)
     assert sv.amplitudes[0].real == 1 or sv.amplitudes[-1].real == 1
 
 
+def test_get_state_vector_arrays(simulation_instance_ghz: SimulationInstance) -> None:
+    """Tests the `get_state_vector_full_array()` and `get_state_vector_sub_array()` methods."""
+    (simulation_state, _state_id) = simulation_instance_ghz
+    simulation_state.run_simulation()
+    sv = simulation_state.get_state_vector_full()
+    arr = simulation_state.get_state_vector_full_array()
+    assert arr.dtype == np.complex128
+    assert arr.shape == (8,)
+    for amplitude, expected in zip(arr, sv.amplitudes):
+        assert abs(amplitude - complex(expected.real, expected.imaginary)) < 1e-6
+
+    out = np.zeros(8, dtype=np.complex128)
+    result = simulation_state.get_state_vector_full_array(out)
+    assert np.shares_memory(result, out)
+    assert np.allclose(out, arr)
+
+    sub = simulation_state.get_state_vector_sub_array([1, 0])
+    assert sub.shape == (4,)
+    with pytest.raises(ValueError, match="complex128"):
+        simulation_state.get_state_vector_sub_array([0, 1], np.zeros(4, dtype=np.float64))
+    with pytest.raises(ValueError, match="4 elements"):
+        simulation_state.get_state_vector_sub_array([0, 1], np.zeros(8, dtype=np.complex128))
+
+
 def test_classical_get(simulation_instance_classical: SimulationInstance) -> None:
     """Tests the classical-state-access methods."""
     (simulation_state, _state_id) = simulation_instance_classical
@@ -7,10 +7,12 @@
  * are not covered by the other tests.
  */
 
+#include "backend/dd/DDPackage.hpp"
 #include "backend/dd/DDSimDebug.hpp"
 #include "backend/debug.h"
 #include "backend/diagnostics.h"
 #include "common.h"
+#include "common/ProgramGenerator.hpp"
 #include "utils_test.hpp"
 
 #include <array>
@@ -18,6 +20,7 @@
 #include <gtest/gtest.h>
 #include <sstream>
 #include <string>
+#include <vector>
 
 /**
  * @brief Fixture for testing the correctness of the debugger on custom code.
@@ -321,6 +324,15 @@ TEST_F(CustomCodeTest, ErrorAssertionInCircuitEqualityAssertion) {
   ASSERT_EQ(state->runAll(state, nullptr), ERROR);
 }
 
+/**
+ * @test Test that an error is returned if the reference circuit of a circuit
+ * equality assertion does not have one qubit per target.
+ */
+TEST_F(CustomCodeTest, ErrorCircuitEqualityAssertionWidthMismatch) {
+  loadCode(3, 0, "assert-eq q[0], q[1] { qreg q[3]; }");
+  ASSERT_EQ(state->runAll(state, nullptr), ERROR);
+}
+
 /**
  * @test Test the correctness of `barrier` instructions.
  */
@@ -613,3 +625,630 @@ TEST_F(CustomCodeTest, PaperExampleGrover) {
   ASSERT_EQ(state->didAssertionFail(state), false);
   ASSERT_EQ(state->isFinished(state), true);
 }
+
+/**
+ * @test Test that assertion outcomes are reused when the same assertion is
+ * checked on the same state and target qubits again.
+ */
+TEST_F(CustomCodeTest, AssertionCache) {
+  loadCode(4, 0,
+           "gate bell a, b {"
+           "  h a;"
+           "  cx a, b;"
+           "  assert-ent a, b;"
+           "}"
+           "bell q[0], q[1];"
+           "bell q[2], q[3];");
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 0);
+  // The two calls target different qubits, so they cannot share outcomes.
+  ASSERT_EQ(ddState.metrics.assertionCacheHits, 0);
+  ASSERT_EQ(ddState.metrics.assertionCacheMisses, 2);
+
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 0);
+  ASSERT_EQ(ddState.metrics.assertionCacheHits, 2);
+  ASSERT_EQ(ddState.metrics.assertionCacheMisses, 2);
+}
+
+/**
+ * @test Test that the reference circuit of a circuit-equality assertion is
+ * only simulated once per loaded program.
+ */
+TEST_F(CustomCodeTest, CircuitEqualityReferenceReused) {
+  loadCode(2, 0,
+           "h q[0];"
+           "cx q[0], q[1];"
+           "assert-eq q[0], q[1] { qreg q[2]; h q[1]; cx q[1], q[0]; }"
+           "x q[0];"
+           "x q[0];"
+           "assert-eq q[1], q[0] { qreg q[2]; h q[1]; cx q[1], q[0]; }");
+  ASSERT_TRUE(ddState.circuitEqualityReferences.empty());
+
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 0);
+  ASSERT_EQ(ddState.circuitEqualityReferences.size(), 2);
+  const auto reference = ddState.circuitEqualityReferences.begin()->second;
+
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 0);
+  ASSERT_EQ(ddState.circuitEqualityReferences.size(), 2);
+  ASSERT_EQ(ddState.circuitEqualityReferences.begin()->second, reference);
+}
+
+/**
+ * @test Test that equality assertions compare states with complex amplitudes
+ * using a proper inner product.
+ */
+TEST_F(CustomCodeTest, EqualityAssertionComplexAmplitudes) {
+  loadCode(1, 0,
+           "h q[0];"
+           "s q[0];"
+           "assert-eq 0.9, q[0] { 0.707, 0.707i }"
+           "assert-eq 0.9, q[0] { 0.707, -0.707i }");
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 1);
+}
+
+/**
+ * @test Test equality assertions on systems that are large enough to be
+ * checked directly on the decision diagram.
+ */
+TEST_F(CustomCodeTest, EqualityAssertionLargeSystem) {
+  loadCode(10, 0,
+           "h q[0];"
+           "cx q[0], q[7];"
+           "h q[3];"
+           "s q[3];"
+           "x q[9];"
+           "assert-eq 0.9, q[7], q[0] { 0.707, 0, 0, 0.707 }"
+           "assert-eq 0.9, q[3] { 0.707, 0.707i }"
+           "assert-eq 0.9, q[9], q[3] { 0, 0, 0.707, 0.707i }"
+           "assert-eq 0.9, q[3] { 0.707, -0.707i }"
+           "assert-eq 0.9, q[7], q[0] { 0, 0.707, 0.707, 0 }");
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 2);
+}
+
+/**
+ * @test Test that an error is returned for equality assertions on entangled
+ * sub-states of systems that are checked directly on the decision diagram.
+ */
+TEST_F(CustomCodeTest, IllegalSubstateEqualityAssertionLargeSystem) {
+  loadCode(10, 0,
+           "h q[0];"
+           "cx q[0], q[7];"
+           "assert-eq 0.9, q[0], q[1] { 0.707, 0, 0, 0.707 }");
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), ERROR);
+}
+
+/**
+ * @test Test equality assertions on sub-states that are large enough to be
+ * extracted from the decision diagram.
+ */
+TEST_F(CustomCodeTest, EqualityAssertionLargeSubState) {
+  std::string targets;
+  std::string amplitudes;
+  std::string code = "h q[0];cx q[0], q[9];";
+  for (size_t i = 1; i < 9; i++) {
+    code += "h q[" + std::to_string(i) + "];";
+    targets += "q[" + std::to_string(9 - i) + "], ";
+  }
+  for (size_t i = 0; i < 256; i++) {
+    amplitudes += i == 0 ? "0.0625" : ", 0.0625";
+  }
+  loadCode(10, 0,
+           (code + "assert-eq 0.9, " + targets + "{ " + amplitudes + " }" +
+            "assert-eq 0.9, " + targets + "{ qreg q[8]; x q[0]; }")
+               .c_str());
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 1);
+
+  loadCode(10, 0,
+           (code + "assert-eq 0.9, q[0], " + targets + "{ " + amplitudes +
+            ", " + amplitudes + " }")
+               .c_str());
+  ASSERT_EQ(state->runAll(state, &numErrors), ERROR);
+}
+
+/**
+ * @test Test that variables in nested custom gates resolve to the correct
+ * qubits, also after stepping back out of and into a call.
+ */
+TEST_F(CustomCodeTest, NestedGateQubitResolution) {
+  loadCode(3, 0,
+           "gate inner a, b {"
+           "  cx a, b;"
+           "  assert-ent a, b;"
+           "}"
+           "gate outer x, y, z {"
+           "  h y;"
+           "  inner y, z;"
+           "}"
+           "outer q[0], q[1], q[2];");
+  // Instructions are: qreg (0), creg (1), inner (2-5), outer (6-9), call (10).
+  const size_t assertion = 4;
+  const size_t innerCall = 8;
+  while (state->getCurrentInstruction(state) != assertion) {
+    ASSERT_EQ(state->stepForward(state), OK);
+  }
+  ASSERT_EQ(ddState.callFrames.size(), 2);
+  ASSERT_EQ(variableToQubit(&ddState, ddState.symbols.parseVariable("a")), 1);
+  ASSERT_EQ(variableToQubit(&ddState, ddState.symbols.parseVariable("b")), 2);
+
+  while (state->getCurrentInstruction(state) != innerCall) {
+    ASSERT_EQ(state->stepBackward(state), OK);
+  }
+  ASSERT_EQ(ddState.callFrames.size(), 1);
+  ASSERT_EQ(variableToQubit(&ddState, ddState.symbols.parseVariable("y")), 1);
+
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 0);
+  ASSERT_TRUE(ddState.callFrames.empty());
+}
+
+/**
+ * @test Test that programs using only standard gates and custom gate calls are
+ * built without importing the preprocessed code and simulate correctly.
+ */
+TEST_F(CustomCodeTest, DirectCircuitConstruction) {
+  loadCode(3, 1,
+           "gate bell a, b {"
+           "  h a;"
+           "  cx a, b;"
+           "}"
+           "bell q[0], q[1];"
+           "swap q[1], q[2];"
+           "barrier q[0], q[2];"
+           "measure q[1] -> c[0];"
+           "ccx q[0], q[2], q[1];");
+  ASSERT_EQ(ddState.qc->getNops(), 6);
+
+  std::vector<Instruction> instructions;
+  preprocessAssertionCode(fullCode.c_str(), &ddState, instructions);
+  qc::QuantumComputation directQc;
+  ASSERT_TRUE(buildQuantumComputation(&ddState, instructions, directQc));
+  ASSERT_EQ(directQc.getNops(), 6);
+
+  ASSERT_EQ(state->runSimulation(state), OK);
+  Variable bit;
+  ASSERT_EQ(state->getClassicalVariable(state, "c[0]", &bit), OK);
+  ASSERT_TRUE(classicalEquals(bit, false));
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, 0, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.707, 0.0));
+  ASSERT_EQ(state->getAmplitudeIndex(state, 7, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.707, 0.0));
+
+  // Parameterized gates are left to the importer.
+  instructions.clear();
+  preprocessAssertionCode("qreg q[1];\nrz(0.5) q[0];\n", &ddState,
+                          instructions);
+  qc::QuantumComputation importedQc;
+  ASSERT_FALSE(buildQuantumComputation(&ddState, instructions, importedQc));
+}
+
+/**
+ * @test Test that generated programs using all constructs that can be checked
+ * on arbitrary states can be loaded and simulated to the end.
+ */
+TEST_F(CustomCodeTest, GeneratedProgramSimulation) {
+  ProgramGeneratorOptions options;
+  options.numQubits = 6;
+  options.numInstructions = 500;
+  options.nestingDepth = 3;
+  options.entanglementAssertionDensity = 0.05;
+  options.superpositionAssertionDensity = 0.05;
+  options.measurementDensity = 0.05;
+  options.classicControlDensity = 0.05;
+  options.noiseDensity = 0.3;
+  const auto code = generateProgram(options);
+
+  ASSERT_EQ(state->loadCode(state, code.c_str()), OK);
+  while (!state->isFinished(state)) {
+    ASSERT_EQ(state->runSimulation(state), OK);
+  }
+}
+
+/**
+ * @test Test that reloading edited code keeps the simulation state if only
+ * instructions that were not executed yet were changed.
+ */
+TEST_F(CustomCodeTest, ReloadKeepsUnchangedPrefix) {
+  loadCode(2, 0,
+           "h q[0];"
+           "cx q[0], q[1];"
+           "x q[1];");
+  forwardTo(2);
+  const auto position = state->getCurrentInstruction(state);
+
+  std::string edited = fullCode;
+  edited.replace(edited.find("x q[1]"), 1, "z");
+  ASSERT_EQ(state->reloadCode(state, edited.c_str()), OK);
+  ASSERT_EQ(state->getCurrentInstruction(state), position);
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, 3, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 0.707, 0.0));
+  ASSERT_EQ(state->stepForward(state), OK);
+  ASSERT_EQ(state->getAmplitudeIndex(state, 3, &result), OK);
+  ASSERT_TRUE(complexEquality(result, -0.707, 0.0));
+
+  // Editing an executed instruction steps back to the last unchanged one.
+  edited.replace(edited.find("h q[0]"), 1, "x");
+  ASSERT_EQ(state->reloadCode(state, edited.c_str()), OK);
+  ASSERT_EQ(state->getCurrentInstruction(state), 2);
+  ASSERT_EQ(state->getAmplitudeIndex(state, 0, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 1.0, 0.0));
+  ASSERT_EQ(state->stepForward(state), OK);
+  ASSERT_EQ(state->getAmplitudeIndex(state, 1, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 1.0, 0.0));
+}
+
+/**
+ * @test Test that reloading edited code keeps the diagnostics data of the
+ * unchanged instructions and discards that of the changed ones.
+ */
+TEST_F(CustomCodeTest, ReloadKeepsDiagnosticsOfUnchangedPrefix) {
+  loadCode(2, 0,
+           "x q[1];"
+           "cx q[0], q[1];"
+           "cx q[0], q[1];");
+  forwardTo(3);
+  auto* diagnostics = state->getDiagnostics(state);
+  std::array<bool, 5> zeroControls{};
+  diagnostics->getZeroControlInstructions(diagnostics, zeroControls.data());
+  ASSERT_TRUE(zeroControls[3]);
+  ASSERT_TRUE(zeroControls[4]);
+
+  std::string edited = fullCode;
+  edited.replace(edited.rfind("cx"), 2, "cz");
+  ASSERT_EQ(state->reloadCode(state, edited.c_str()), OK);
+  ASSERT_EQ(state->getCurrentInstruction(state), 4);
+  zeroControls = {};
+  diagnostics->getZeroControlInstructions(diagnostics, zeroControls.data());
+  ASSERT_TRUE(zeroControls[3]);
+  ASSERT_FALSE(zeroControls[4]);
+
+  ASSERT_EQ(state->stepForward(state), OK);
+  diagnostics->getZeroControlInstructions(diagnostics, zeroControls.data());
+  ASSERT_TRUE(zeroControls[4]);
+}
+
+/**
+ * @test Test that breakpoints with conditions on the hit count, on classical
+ * bits, and on qubit probabilities are only hit if their conditions hold.
+ */
+TEST_F(CustomCodeTest, ConditionalBreakpoints) {
+  loadCode(2, 1,
+           "gate g a { x a; }"
+           "g q[0];"
+           "g q[0];"
+           "g q[0];"
+           "h q[1];"
+           "measure q[0] -> c[0];"
+           "x q[1];");
+  size_t instruction = 0;
+  ASSERT_EQ(state->setBreakpoint(state, fullCode.find("x a"), &instruction),
+            OK);
+  ASSERT_EQ(instruction, 3);
+  ASSERT_EQ(state->setBreakpointCondition(state, instruction, nullptr, "% 2"),
+            OK);
+
+  // Only the second call of `g` hits the breakpoint.
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->wasBreakpointHit(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), 3);
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, 1, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 1.0, 0.0));
+
+  // Stepping back undoes the hit, so the breakpoint is hit again.
+  ASSERT_EQ(state->stepBackward(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->wasBreakpointHit(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), 3);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->isFinished(state));
+
+  ASSERT_EQ(state->clearBreakpoints(state), OK);
+  ASSERT_EQ(state->setBreakpoint(state, fullCode.find("x q[1]"), &instruction),
+            OK);
+  ASSERT_EQ(instruction, 10);
+  ASSERT_EQ(state->setBreakpointCondition(state, 3, "c[0] == 1", nullptr),
+            ERROR);
+
+  ASSERT_EQ(state->setBreakpointCondition(state, instruction, "c[0] == 0",
+                                          nullptr),
+            OK);
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->isFinished(state));
+
+  ASSERT_EQ(state->setBreakpointCondition(state, instruction, "c == 1",
+                                          nullptr),
+            OK);
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->wasBreakpointHit(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), instruction);
+
+  ASSERT_EQ(state->setBreakpointCondition(state, instruction,
+                                          "P(q[1]) > 0.4", "1"),
+            OK);
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->wasBreakpointHit(state));
+
+  ASSERT_EQ(state->setBreakpointCondition(state, instruction,
+                                          "P(q[1]) > 0.6", nullptr),
+            OK);
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->isFinished(state));
+
+  ASSERT_EQ(state->setBreakpointCondition(state, instruction, "P(q[2]) > 0",
+                                          nullptr),
+            ERROR);
+  ASSERT_EQ(state->setBreakpointCondition(state, instruction, "d == 1",
+                                          nullptr),
+            ERROR);
+  ASSERT_EQ(state->setBreakpointCondition(state, instruction, "c[0] === 1",
+                                          nullptr),
+            ERROR);
+}
+
+/**
+ * @test Test that a breakpoint is only counted as hit while its condition
+ * holds, so that the hit condition only applies to those hits.
+ */
+TEST_F(CustomCodeTest, ConditionalBreakpointHitCount) {
+  loadCode(1, 0,
+           "gate g a { x a; }"
+           "g q[0];"
+           "g q[0];"
+           "g q[0];"
+           "g q[0];");
+  size_t instruction = 0;
+  ASSERT_EQ(state->setBreakpoint(state, fullCode.find("x a"), &instruction),
+            OK);
+  ASSERT_EQ(state->setBreakpointCondition(state, instruction, "P(q[0]) > 0.5",
+                                          "2"),
+            OK);
+
+  // The condition only holds in the second and fourth call of `g`.
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->wasBreakpointHit(state));
+  ASSERT_EQ(state->getCurrentInstruction(state), instruction);
+  ASSERT_EQ(ddState.breakpointConditions[instruction].hits, 2);
+  Complex result;
+  ASSERT_EQ(state->getAmplitudeIndex(state, 1, &result), OK);
+  ASSERT_TRUE(complexEquality(result, 1.0, 0.0));
+
+  // Leaving the breakpoint backward undoes only the counted hit.
+  ASSERT_EQ(state->stepBackward(state), OK);
+  ASSERT_EQ(ddState.breakpointConditions[instruction].hits, 1);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->wasBreakpointHit(state));
+  ASSERT_EQ(ddState.breakpointConditions[instruction].hits, 2);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->isFinished(state));
+}
+
+/**
+ * @test Test that the execution trace records steps, custom gate calls and
+ * returns, measurement outcomes, and node counts, and keeps only the most
+ * recent events once it is full.
+ */
+TEST_F(CustomCodeTest, ExecutionTrace) {
+  loadCode(1, 1,
+           "gate g a { x a; }"
+           "g q[0];"
+           "x q[0];"
+           "measure q[0] -> c[0];"
+           "assert-sup q[0];");
+  ASSERT_EQ(state->setTraceCapacity(state, 100, false), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->didAssertionFail(state));
+
+  const std::vector<std::array<size_t, 3>> expected{
+      {TraceStepForward, 0, 0},  {TraceStepForward, 1, 0},
+      {TraceStepForward, 2, 0},  {TraceStepForward, 5, 0},
+      {TraceCall, 5, 3},         {TraceStepForward, 3, 0},
+      {TraceStepForward, 4, 0},  {TraceReturn, 4, 6},
+      {TraceStepForward, 6, 0},  {TraceStepForward, 7, 0},
+      {TraceMeasurement, 7, 0},  {TraceStepForward, 8, 0},
+      {TraceStepBackward, 8, 0}};
+  ASSERT_EQ(state->getTraceLength(state), expected.size());
+  std::vector<TraceEvent> events(expected.size());
+  ASSERT_EQ(state->getTrace(state, 0, events.size(), events.data()), OK);
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_EQ(events[i].type, expected[i][0]);
+    ASSERT_EQ(events[i].instruction, expected[i][1]);
+    ASSERT_EQ(events[i].value, expected[i][2]);
+  }
+  ASSERT_EQ(state->getTrace(state, 10, 4, events.data()), ERROR);
+
+  // Once the trace is full, new events replace the oldest ones.
+  ASSERT_EQ(state->setTraceCapacity(state, 4, false), OK);
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_EQ(state->getTraceLength(state), 4);
+  ASSERT_EQ(state->getTrace(state, 0, 4, events.data()), OK);
+  for (size_t i = 0; i < 4; i++) {
+    ASSERT_EQ(events[i].type, expected[expected.size() - 4 + i][0]);
+    ASSERT_EQ(events[i].instruction, expected[expected.size() - 4 + i][1]);
+  }
+
+  ASSERT_EQ(state->setTraceCapacity(state, 100, true), OK);
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->getTraceLength(state), 0);
+  for (size_t i = 0; i < 6; i++) {
+    ASSERT_EQ(state->stepForward(state), OK);
+  }
+  ASSERT_EQ(state->getTrace(state, 0, 8, events.data()), OK);
+  ASSERT_EQ(events[6].type, TraceNodeCount);
+  ASSERT_EQ(events[6].instruction, 3);
+  ASSERT_GT(events[6].value, 0);
+
+  ASSERT_EQ(state->setTraceCapacity(state, 0, false), OK);
+  ASSERT_EQ(state->stepForward(state), OK);
+  ASSERT_EQ(state->getTraceLength(state), 0);
+}
+
+/**
+ * @test Test that the metrics count loaded programs, applied operations,
+ * assertion checks of each type, state vector expansions, and diagnostics
+ * callbacks, and that they can be reset.
+ */
+TEST_F(CustomCodeTest, Metrics) {
+  loadCode(2, 1,
+           "h q[0];"
+           "cx q[0], q[1];"
+           "assert-ent q[0], q[1];"
+           "assert-sup q[0];"
+           "assert-eq 0.9, q[0], q[1] { 0.707, 0, 0, 0.707 }"
+           "assert-eq q[0], q[1] { qreg q[2]; h q[1]; cx q[1], q[0]; }");
+  Metrics metrics{};
+  ASSERT_EQ(state->getMetrics(state, &metrics), OK);
+  ASSERT_EQ(metrics.codeLoads, 1);
+  ASSERT_GT(metrics.preprocessingTime, 0);
+  ASSERT_EQ(metrics.ddMultiplications, 0);
+
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 0);
+  ASSERT_EQ(state->getMetrics(state, &metrics), OK);
+  ASSERT_EQ(metrics.ddMultiplications, 2);
+  ASSERT_EQ(metrics.entanglementAssertionChecks, 1);
+  ASSERT_EQ(metrics.superpositionAssertionChecks, 1);
+  ASSERT_EQ(metrics.statevectorEqualityAssertionChecks, 1);
+  ASSERT_EQ(metrics.circuitEqualityAssertionChecks, 1);
+  ASSERT_GT(metrics.entanglementAssertionTime, 0);
+  ASSERT_EQ(metrics.assertionCacheMisses, 4);
+  ASSERT_EQ(metrics.diagnosticsCallbacks, 8);
+  ASSERT_GE(metrics.stateVectorExpansions, 2);
+  ASSERT_GE(metrics.stateVectorExpansionAmplitudes,
+            4 * metrics.stateVectorExpansions);
+
+  ASSERT_EQ(state->resetMetrics(state), OK);
+  ASSERT_EQ(state->getMetrics(state, &metrics), OK);
+  ASSERT_EQ(metrics.codeLoads, 0);
+  ASSERT_EQ(metrics.ddMultiplications, 0);
+  ASSERT_EQ(metrics.diagnosticsCallbacks, 0);
+}
+
+/**
+ * @test Test that the memory statistics describe the stored nodes and that
+ * steps are refused without changing the state while the DD package exceeds
+ * the memory budget after forcing a garbage collection.
+ */
+TEST_F(CustomCodeTest, MemoryBudget) {
+  loadCode(2, 1,
+           "h q[0];"
+           "cx q[0], q[1];");
+  MemoryStatistics statistics{};
+  ASSERT_EQ(state->setMemoryBudget(state, 1), OK);
+  ASSERT_EQ(state->runSimulation(state), ERROR);
+  ASSERT_EQ(state->getCurrentInstruction(state), 2);
+  Complex amplitude;
+  ASSERT_EQ(state->getAmplitudeBitstring(state, "00", &amplitude), OK);
+  ASSERT_NEAR(amplitude.real, 1.0, 0.001);
+  ASSERT_EQ(state->getMemoryStatistics(state, &statistics), OK);
+  ASSERT_EQ(statistics.memoryBudget, 1);
+  ASSERT_EQ(statistics.budgetCollections, 1);
+  ASSERT_TRUE(statistics.budgetExceeded);
+  ASSERT_GT(statistics.nodeMemory, 1);
+  ASSERT_GT(statistics.packageMemory, statistics.nodeMemory);
+  ASSERT_GT(statistics.activeVectorNodes, 0);
+  ASSERT_LE(statistics.activeVectorNodes, statistics.vectorNodes);
+
+  ASSERT_EQ(state->setMemoryBudget(state, 0), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->isFinished(state));
+  ASSERT_EQ(state->getMemoryStatistics(state, &statistics), OK);
+  ASSERT_EQ(statistics.budgetCollections, 1);
+  ASSERT_FALSE(statistics.budgetExceeded);
+  ASSERT_GE(statistics.peakActiveVectorNodes, statistics.activeVectorNodes);
+
+  ASSERT_EQ(state->setMemoryBudget(state, 1), OK);
+  ASSERT_EQ(state->stepBackward(state), ERROR);
+  ASSERT_TRUE(state->isFinished(state));
+  ASSERT_EQ(state->getMemoryStatistics(state, &statistics), OK);
+  ASSERT_TRUE(statistics.budgetExceeded);
+}
+
+/**
+ * @test Test that exceeding the memory budget releases the states kept by the
+ * assertion cache and the circuit-equality references.
+ */
+TEST_F(CustomCodeTest, MemoryBudgetReleasesCachedStates) {
+  loadCode(2, 1,
+           "x q[0];"
+           "assert-eq q[0], q[1] { qreg q[2]; x q[0]; }\n"
+           "x q[0];"
+           "h q[1];");
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->isFinished(state));
+  ASSERT_FALSE(ddState.assertionCache.empty());
+  ASSERT_FALSE(ddState.circuitEqualityReferences.empty());
+
+  ASSERT_EQ(state->setMemoryBudget(state, 1), OK);
+  ASSERT_EQ(state->stepBackward(state), ERROR);
+  ASSERT_TRUE(ddState.assertionCache.empty());
+  ASSERT_TRUE(ddState.circuitEqualityReferences.empty());
+
+  // Released references are simulated again when they are needed.
+  ASSERT_EQ(state->setMemoryBudget(state, 0), OK);
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->isFinished(state));
+  ASSERT_FALSE(state->didAssertionFail(state));
+}
+
+/**
+ * @test Test that the DD packages of destroyed simulation states are reused by
+ * new simulation states while the pool has capacity left.
+ */
+TEST_F(CustomCodeTest, DDPackagePool) {
+  const std::string code = "qreg q[2]; h q[0]; cx q[0], q[1];";
+  setDDPackagePoolCapacity(1);
+  DDSimulationState first;
+  createDDSimulationState(&first);
+  ASSERT_EQ(first.interface.loadCode(&first.interface, code.c_str()), OK);
+  ASSERT_EQ(first.interface.runSimulation(&first.interface), OK);
+  const auto* package = first.dd.get();
+  destroyDDSimulationState(&first);
+  ASSERT_EQ(getDDPackagePoolSize(), 1);
+
+  DDSimulationState second;
+  createDDSimulationState(&second);
+  ASSERT_EQ(second.dd.get(), package);
+  ASSERT_EQ(getDDPackagePoolSize(), 0);
+  MemoryStatistics statistics{};
+  ASSERT_EQ(second.interface.getMemoryStatistics(&second.interface,
+                                                 &statistics),
+            OK);
+  ASSERT_EQ(statistics.peakActiveVectorNodes, statistics.activeVectorNodes);
+  ASSERT_EQ(second.interface.loadCode(&second.interface, code.c_str()), OK);
+  ASSERT_EQ(second.interface.runSimulation(&second.interface), OK);
+  ASSERT_TRUE(second.interface.isFinished(&second.interface));
+  Complex amplitude;
+  ASSERT_EQ(second.interface.getAmplitudeBitstring(&second.interface, "11",
+                                                   &amplitude),
+            OK);
+  ASSERT_NEAR(amplitude.real, 0.707, 0.001);
+  destroyDDSimulationState(&second);
+  ASSERT_EQ(getDDPackagePoolSize(), 1);
+
+  setDDPackagePoolCapacity(0);
+  ASSERT_EQ(getDDPackagePoolSize(), 0);
+}
@@ -345,3 +345,91 @@ TEST_F(DiagnosticsTest, RuntimeInteractions) {
   ASSERT_EQ(errors[0].type, ErrorCauseType::ControlAlwaysZero);
   ASSERT_EQ(errors[0].instruction, 6);
 }
+
+/**
+ * @test Test that the runtime qubit usage is stored only once per distinct
+ * qubit tuple and instruction, even if custom gates are called repeatedly.
+ */
+TEST_F(DiagnosticsTest, RuntimeQubitUsageStatistics) {
+  loadFromFile("complex-jumps");
+
+  DiagnosticsStatistics statistics{};
+  ASSERT_EQ(diagnostics->getStatistics(diagnostics, &statistics), OK);
+  ASSERT_EQ(statistics.distinctQubitTuples, 0);
+  ASSERT_EQ(statistics.qubitUsageEntries, 0);
+
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_TRUE(state->isFinished(state));
+  ASSERT_EQ(diagnostics->getStatistics(diagnostics, &statistics), OK);
+  ASSERT_EQ(statistics.distinctQubitTuples, 6);
+  ASSERT_EQ(statistics.qubitUsageEntries, 14);
+  ASSERT_GT(statistics.qubitUsageBytes, 0);
+
+  // Running the same program again must not record any new entries.
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  DiagnosticsStatistics rerunStatistics{};
+  ASSERT_EQ(diagnostics->getStatistics(diagnostics, &rerunStatistics), OK);
+  ASSERT_EQ(rerunStatistics.distinctQubitTuples, 6);
+  ASSERT_EQ(rerunStatistics.qubitUsageEntries, 14);
+}
+
+/**
+ * @test Test that `potentialErrorCausesAll` reports the error causes of all
+ * assertions that failed during `runAll`, ranked by the number of failures
+ * they explain.
+ */
+TEST_F(DiagnosticsTest, PotentialErrorCausesAll) {
+  loadFromFile("failing-assertions-multiple-failures");
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 2);
+
+  std::array<ErrorCause, 10> problems{};
+  ASSERT_EQ(
+      diagnostics->potentialErrorCausesAll(diagnostics, problems.data(), 10),
+      2);
+  ASSERT_EQ(problems[0].type, ErrorCauseType::ControlAlwaysZero);
+  ASSERT_EQ(problems[0].instruction, 2);
+  ASSERT_EQ(problems[1].type, ErrorCauseType::MissingInteraction);
+  ASSERT_EQ(problems[1].instruction, 3);
+
+  ASSERT_EQ(
+      diagnostics->potentialErrorCausesAll(diagnostics, problems.data(), 1), 1);
+  ASSERT_EQ(problems[0].type, ErrorCauseType::ControlAlwaysZero);
+
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(
+      diagnostics->potentialErrorCausesAll(diagnostics, problems.data(), 10),
+      0);
+}
+
+/**
+ * @test Test that `potentialErrorCausesAll` records the call stack of each
+ * failure and counts the failures of an assertion inside a custom gate once
+ * for each call site.
+ */
+TEST_F(DiagnosticsTest, PotentialErrorCausesAllCallSites) {
+  loadFromFile("failing-assertions-in-custom-gate");
+  size_t numErrors = 0;
+  ASSERT_EQ(state->runAll(state, &numErrors), OK);
+  ASSERT_EQ(numErrors, 3);
+
+  const auto& failures = ddState.diagnostics.failedAssertions;
+  ASSERT_EQ(failures.size(), 3);
+  ASSERT_EQ(failures[0].instruction, 1);
+  ASSERT_EQ(failures[0].callStack, std::vector<size_t>{5});
+  ASSERT_EQ(failures[1].instruction, 1);
+  ASSERT_EQ(failures[1].callStack, std::vector<size_t>{6});
+  ASSERT_EQ(failures[2].instruction, 7);
+  ASSERT_TRUE(failures[2].callStack.empty());
+
+  std::array<ErrorCause, 10> problems{};
+  ASSERT_EQ(
+      diagnostics->potentialErrorCausesAll(diagnostics, problems.data(), 10),
+      2);
+  ASSERT_EQ(problems[0].type, ErrorCauseType::MissingInteraction);
+  ASSERT_EQ(problems[0].instruction, 1);
+  ASSERT_EQ(problems[1].type, ErrorCauseType::MissingInteraction);
+  ASSERT_EQ(problems[1].instruction, 7);
+}
@@ -3,15 +3,24 @@
  * @brief Test the functionality of parsing functions used by the debugger.
  */
 
+#include "common/CompressedTable.hpp"
+#include "common/ProgramGenerator.hpp"
+#include "common/RingBuffer.hpp"
 #include "common/Span.hpp"
+#include "common/SymbolTable.hpp"
 #include "common/parsing/AssertionParsing.hpp"
+#include "common/parsing/BreakpointConditionParsing.hpp"
 #include "common/parsing/CodePreprocessing.hpp"
 #include "common/parsing/ParsingError.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <gtest/gtest.h>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 /**
  * @brief Fixture for testing the correctness of parsing functions.
@@ -166,3 +175,282 @@ TEST_F(ParsingTest, BadFunctionCall) {
       "gate my_gate q0, q1 { h q0; h q1 } qreg q[3]; my_gate q[0], q[1], q[2];";
   ASSERT_THROW(preprocessCode(input2, output), ParsingError);
 }
+
+/**
+ * @test Test that comments do not affect the preprocessed instructions.
+ *
+ * Comments containing braces and semicolons must neither end instructions nor
+ * open blocks, and all positions must still refer to the original code.
+ */
+TEST_F(ParsingTest, CommentsAndPositions) {
+  const std::string input = "qreg q[2]; // first { ; }\n"
+                            "gate g a { // body {\n"
+                            "  h a;\n"
+                            "}\n"
+                            "g q[0];\n"
+                            "measure q[1] -> c[1];\r\n"
+                            "h q[1];";
+  std::string output;
+  SymbolTable symbols;
+  const auto instructions = preprocessCode(input, output, symbols);
+  ASSERT_EQ(output.size(), input.size());
+  ASSERT_EQ(output.find("//"), std::string::npos);
+  ASSERT_EQ(instructions.size(), 7);
+
+  ASSERT_TRUE(instructions[1].isFunctionDefinition);
+  ASSERT_EQ(input[instructions[1].originalCodeEndPosition], '}');
+  ASSERT_EQ(input.substr(instructions[2].originalCodeStartPosition,
+                         instructions[2].originalCodeEndPosition -
+                             instructions[2].originalCodeStartPosition + 1),
+            " // body {\n  h a;");
+  ASSERT_EQ(instructions[3].code, "RETURN");
+  ASSERT_EQ(instructions[3].originalCodeStartPosition,
+            instructions[1].originalCodeEndPosition);
+
+  ASSERT_TRUE(instructions[4].isFunctionCall);
+  ASSERT_EQ(instructions[4].calledFunction, "g");
+  ASSERT_EQ(instructions[4].successorIndex, 2);
+  ASSERT_EQ(symbols.toString(
+                instructions[4].callSubstitution.at(symbols.intern("a"))),
+            "q[0]");
+
+  ASSERT_EQ(instructions[5].targets, std::vector<std::string>{"q[1]"});
+  ASSERT_EQ(instructions[6].targets, std::vector<std::string>{"q[1]"});
+  ASSERT_EQ(instructions[6].dataDependencies.size(), 1);
+  ASSERT_EQ(instructions[6].dataDependencies[0].first, 5);
+}
+
+/**
+ * @test Test parsing errors related to unbalanced curly braces.
+ */
+TEST_F(ParsingTest, UnmatchedBraces) {
+  std::string output;
+  ASSERT_THROW(preprocessCode("qreg q[1]; gate g a { h a;", output),
+               ParsingError);
+  ASSERT_THROW(preprocessCode("qreg q[1]; h q[0]; }", output), ParsingError);
+}
+
+/**
+ * @test Test the data dependencies between full registers and their indices.
+ */
+TEST_F(ParsingTest, DataDependencyAliasing) {
+  const std::string input = "qreg q[2];\n"
+                            "x q;\n"
+                            "h q[0];\n"
+                            "h q[1];\n"
+                            "cx q[0], q[1];\n"
+                            "h q[1];\n"
+                            "barrier q;\n"
+                            "z q[1];\n"
+                            "gate g q { h q; }\n"
+                            "g q[0];\n";
+  std::string output;
+  const auto instructions = preprocessCode(input, output);
+  using Dependencies = std::vector<std::pair<size_t, size_t>>;
+
+  // `q[0]` depends on the last usage of the full register.
+  ASSERT_EQ(instructions[2].dataDependencies, (Dependencies{{1, 0}}));
+  // Each index depends on its own last usage.
+  ASSERT_EQ(instructions[4].dataDependencies,
+            (Dependencies{{2, 0}, {3, 0}}));
+  // `q` depends on the last usage of each index since its own last usage.
+  auto barrierDependencies = instructions[6].dataDependencies;
+  std::sort(barrierDependencies.begin(), barrierDependencies.end());
+  ASSERT_EQ(barrierDependencies, (Dependencies{{1, 0}, {4, 0}, {5, 0}}));
+  ASSERT_EQ(instructions[7].dataDependencies, (Dependencies{{6, 0}}));
+  // Instructions inside gate definitions only depend on their own scope.
+  ASSERT_TRUE(instructions[9].dataDependencies.empty());
+  ASSERT_EQ(instructions[11].dataDependencies, (Dependencies{{6, 0}}));
+}
+
+TEST_F(ParsingTest, SymbolInterning) {
+  SymbolTable symbols;
+  const auto first = symbols.parseVariable("q[12]");
+  const auto second = symbols.parseVariable("q");
+  ASSERT_EQ(first.symbol, second.symbol);
+  ASSERT_EQ(first.index, 12);
+  ASSERT_TRUE(second.isFullRegister());
+  ASSERT_EQ(symbols.toString(first), "q[12]");
+  ASSERT_EQ(symbols.toString(second), "q");
+
+  const auto invalid = symbols.parseVariable("q[i]");
+  ASSERT_TRUE(invalid.isFullRegister());
+  ASSERT_EQ(symbols.getName(invalid.symbol), "q[i]");
+  ASSERT_EQ(symbols.size(), 2);
+
+  const std::string input = "qreg q[2];\n"
+                            "gate g a, b { cx a, b; }\n"
+                            "g q[1], q[0];\n";
+  std::string output;
+  symbols.clear();
+  const auto instructions = preprocessCode(input, output, symbols);
+  ASSERT_EQ(instructions[2].targetReferences.size(), 2);
+  ASSERT_EQ(symbols.toString(instructions[2].targetReferences[0]), "a");
+  const auto& substitution = instructions[4].callSubstitution;
+  ASSERT_EQ(substitution.at(symbols.intern("a")),
+            symbols.parseVariable("q[1]"));
+  ASSERT_EQ(substitution.at(symbols.intern("b")),
+            symbols.parseVariable("q[0]"));
+}
+
+TEST_F(ParsingTest, InstructionsReferenceProcessedCode) {
+  const std::string input = "qreg q[2];\n"
+                            "gate g a { h a; }\n"
+                            "g q[0];\n"
+                            "assert-eq q[0] { qreg q[1]; h q[0]; }\n";
+  std::string output;
+  const auto instructions = preprocessCode(input, output);
+  ASSERT_EQ(instructions.size(), 6);
+  const auto* const begin = output.data();
+  const auto* const end = output.data() + output.size();
+  for (const auto& instruction : instructions) {
+    if (instruction.code == "RETURN") {
+      continue;
+    }
+    ASSERT_GE(instruction.code.data(), begin);
+    ASSERT_LE(instruction.code.data() + instruction.code.size(), end);
+  }
+  ASSERT_EQ(instructions[1].block.code, " h a; ");
+  ASSERT_EQ(instructions[4].calledFunction, "g");
+  ASSERT_EQ(instructions[4].calledFunction.data(),
+            output.data() + output.find("g q[0]"));
+  ASSERT_EQ(instructions[5].block.code, " qreg q[1]; h q[0]; ");
+}
+
+/**
+ * @test Test that a compressed table stores its rows back-to-back, including
+ * empty rows.
+ */
+TEST_F(ParsingTest, CompressedTableRows) {
+  CompressedTable<std::pair<size_t, size_t>> table;
+  table.addRow({{0, 1}, {2, 0}});
+  table.addRow({});
+  const std::vector<std::pair<size_t, size_t>> last{{1, 1}};
+  table.addRow(last.begin(), last.end());
+
+  ASSERT_EQ(table.size(), 3);
+  ASSERT_EQ(table[0].size(), 2);
+  ASSERT_EQ(table[0][1], (std::pair<size_t, size_t>{2, 0}));
+  ASSERT_EQ(table[1].size(), 0);
+  ASSERT_EQ(table[2][0], (std::pair<size_t, size_t>{1, 1}));
+  ASSERT_EQ(table[0].end(), table[1].begin());
+
+  table.clear();
+  ASSERT_EQ(table.size(), 0);
+}
+
+/**
+ * @test Test that a ring buffer keeps the most recent elements in order, also
+ * when they wrap around the end of its storage.
+ */
+TEST_F(ParsingTest, RingBufferKeepsRecentElements) {
+  RingBuffer<size_t> buffer;
+  buffer.push(1);
+  ASSERT_EQ(buffer.size(), 0);
+  ASSERT_THROW(buffer[0], std::out_of_range);
+
+  buffer.setCapacity(3);
+  for (size_t i = 0; i < 5; i++) {
+    buffer.push(i);
+  }
+  ASSERT_EQ(buffer.size(), 3);
+  ASSERT_EQ(buffer[0], 2);
+  ASSERT_EQ(buffer[2], 4);
+  ASSERT_THROW(buffer[3], std::out_of_range);
+
+  std::vector<size_t> output(3);
+  ASSERT_TRUE(buffer.copy(0, 3, output.data()));
+  ASSERT_EQ(output, (std::vector<size_t>{2, 3, 4}));
+  ASSERT_TRUE(buffer.copy(1, 2, output.data()));
+  ASSERT_EQ(output[0], 3);
+  ASSERT_EQ(output[1], 4);
+  ASSERT_FALSE(buffer.copy(2, 2, output.data()));
+
+  buffer.clear();
+  ASSERT_EQ(buffer.size(), 0);
+  ASSERT_EQ(buffer.capacity(), 3);
+  ASSERT_TRUE(buffer.copy(0, 0, output.data()));
+}
+
+/**
+ * @test Test the parsing of breakpoint conditions and hit conditions.
+ */
+TEST_F(ParsingTest, BreakpointConditions) {
+  const auto bit = parseBreakpointCondition(" c[1] != 0 ");
+  ASSERT_EQ(bit.target, ConditionTarget::ClassicalBit);
+  ASSERT_EQ(bit.variable, "c[1]");
+  ASSERT_EQ(bit.comparison, ComparisonOperator::NotEqual);
+  ASSERT_EQ(bit.value, 0);
+
+  const auto reg = parseBreakpointCondition("c>=2");
+  ASSERT_EQ(reg.target, ConditionTarget::ClassicalRegister);
+  ASSERT_EQ(reg.variable, "c");
+  ASSERT_EQ(reg.comparison, ComparisonOperator::GreaterEqual);
+
+  const auto probability = parseBreakpointCondition("P(q[3]) < 0.25");
+  ASSERT_EQ(probability.target, ConditionTarget::QubitProbability);
+  ASSERT_EQ(probability.variable, "q[3]");
+  ASSERT_EQ(probability.comparison, ComparisonOperator::Less);
+  ASSERT_EQ(probability.value, 0.25);
+
+  ASSERT_THROW(parseBreakpointCondition("c[0]"), ParsingError);
+  ASSERT_THROW(parseBreakpointCondition("c[0] = 1"), ParsingError);
+  ASSERT_THROW(parseBreakpointCondition("c % 2"), ParsingError);
+  ASSERT_THROW(parseBreakpointCondition("P(q) > 0.5"), ParsingError);
+  ASSERT_THROW(parseBreakpointCondition("c[x] == 1"), ParsingError);
+  ASSERT_THROW(parseBreakpointCondition("c == one"), ParsingError);
+
+  const auto exact = parseHitCondition("3");
+  ASSERT_EQ(exact.comparison, ComparisonOperator::Equal);
+  ASSERT_EQ(exact.count, 3);
+  const auto multiple = parseHitCondition("% 2");
+  ASSERT_EQ(multiple.comparison, ComparisonOperator::Multiple);
+  ASSERT_EQ(multiple.count, 2);
+  ASSERT_EQ(parseHitCondition(">5").comparison, ComparisonOperator::Greater);
+  ASSERT_THROW(parseHitCondition("% 0"), ParsingError);
+  ASSERT_THROW(parseHitCondition(">= -1"), ParsingError);
+  ASSERT_THROW(parseHitCondition("often"), ParsingError);
+
+  ASSERT_TRUE(compareValues(ComparisonOperator::Multiple, 4, 2));
+  ASSERT_FALSE(compareValues(ComparisonOperator::Multiple, 3, 2));
+  ASSERT_TRUE(compareValues(ComparisonOperator::Equal, 0.1 + 0.2, 0.3));
+}
+
+/**
+ * @test Test that generated programs using all supported constructs and noise
+ * can be preprocessed and contain the requested number of instructions.
+ */
+TEST_F(ParsingTest, GeneratedProgram) {
+  ProgramGeneratorOptions options;
+  options.numQubits = 6;
+  options.numInstructions = 2000;
+  options.nestingDepth = 3;
+  options.callFanOut = 2;
+  options.entanglementAssertionDensity = 0.05;
+  options.superpositionAssertionDensity = 0.05;
+  options.statevectorEqualityAssertionDensity = 0.05;
+  options.circuitEqualityAssertionDensity = 0.05;
+  options.measurementDensity = 0.05;
+  options.classicControlDensity = 0.05;
+  options.noiseDensity = 0.3;
+  const auto code = generateProgram(options);
+  ASSERT_EQ(code, generateProgram(options));
+
+  std::string output;
+  const auto instructions = preprocessCode(code, output);
+  // Two declarations, the innermost gate with three instructions and two gates
+  // with two calls and two further instructions each, including the gate
+  // definitions and their `return` instructions.
+  ASSERT_EQ(instructions.size(), 2 + 5 + 6 + 6 + options.numInstructions);
+  const auto assertions = std::count_if(
+      instructions.begin(), instructions.end(),
+      [](const Instruction& i) { return i.assertion != nullptr; });
+  ASSERT_GT(assertions, 200);
+  ASSERT_LT(assertions, 600);
+
+  options.measurementDensity = 0.9;
+  ASSERT_THROW(generateProgram(options), std::invalid_argument);
+  options.measurementDensity = 0;
+  options.numQubits = 1;
+  ASSERT_THROW(generateProgram(options), std::invalid_argument);
+}
@@ -601,6 +601,48 @@ TEST_P(SimulationTest, StepAtEnds) {
   ASSERT_EQ(state->stepOutBackward(state), Result::ERROR);
 }
 
+/**
+ * @test Test that multiple breakpoints can be set at once, both at top-level
+ * instructions and inside gate definitions.
+ *
+ * Positions at which no breakpoint can be set are reported as -1 without
+ * affecting the other breakpoints.
+ */
+TEST_P(SimulationTest, BulkBreakpoints) {
+  if (GetParam() != "complex-jumps") {
+    return;
+  }
+
+  const std::vector<size_t> positions{86, 174, 9999, 280, 451};
+  const std::vector<size_t> expected{2, 4, -1ULL, 7, 12};
+  std::vector<size_t> targets(positions.size());
+  ASSERT_EQ(state->setBreakpoints(state, positions.data(), positions.size(),
+                                  targets.data()),
+            OK);
+  ASSERT_EQ(targets, expected);
+
+  for (size_t i = 0; i < positions.size(); i++) {
+    size_t target = 0;
+    if (expected[i] == -1ULL) {
+      ASSERT_EQ(state->setBreakpoint(state, positions[i], &target), ERROR);
+    } else {
+      ASSERT_EQ(state->setBreakpoint(state, positions[i], &target), OK);
+      ASSERT_EQ(target, expected[i]);
+    }
+  }
+
+  ASSERT_EQ(state->runSimulation(state), OK);
+  while (state->didAssertionFail(state)) {
+    ASSERT_EQ(state->runSimulation(state), OK);
+  }
+  ASSERT_TRUE(state->wasBreakpointHit(state));
+
+  ASSERT_EQ(state->clearBreakpoints(state), OK);
+  ASSERT_EQ(state->resetSimulation(state), OK);
+  ASSERT_EQ(state->runSimulation(state), OK);
+  ASSERT_FALSE(state->wasBreakpointHit(state));
+}
+
 /**
  * @test Test that errors are returned when placing breakpoints outside the
  * code.
@@ -12,6 +12,7 @@
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 
 /**
  * @brief Fixture for testing the correctness of utility functions.
@@ -89,3 +90,80 @@ TEST_F(UtilityTest, BadInstructionPosition) {
   size_t end = 0;
   ASSERT_EQ(state->getInstructionPosition(state, 100, &start, &end), ERROR);
 }
+
+/**
+ * @test Test the retrieval of the positions of all instructions at once.
+ */
+TEST_F(UtilityTest, GetInstructionPositions) {
+  loadFromFile("complex-jumps");
+
+  const auto count = state->getInstructionCount(state);
+  std::vector<size_t> starts(count);
+  std::vector<size_t> ends(count);
+  ASSERT_EQ(
+      state->getInstructionPositions(state, count, starts.data(), ends.data()),
+      OK);
+  for (size_t instruction = 0; instruction < count; instruction++) {
+    size_t start = 0;
+    size_t end = 0;
+    state->getInstructionPosition(state, instruction, &start, &end);
+    ASSERT_EQ(starts[instruction], start)
+        << "Failed for instruction " << instruction;
+    ASSERT_EQ(ends[instruction], end)
+        << "Failed for instruction " << instruction;
+  }
+
+  std::vector<size_t> tooMany(count + 1);
+  ASSERT_EQ(state->getInstructionPositions(state, count + 1, tooMany.data(),
+                                           tooMany.data()),
+            ERROR);
+}
+
+/**
+ * @test Test the conversion between positions and lines and columns in the
+ * loaded code.
+ */
+TEST_F(UtilityTest, CodeCoordinates) {
+  loadFromFile("complex-jumps");
+
+  const std::map<size_t, std::pair<size_t, size_t>> expected = {
+      {0, {0, 0}},  {9, {0, 9}},   {38, {2, 0}},
+      {79, {3, 4}}, {150, {6, 0}}, {452, {16, 2}}};
+  for (const auto& [position, coordinates] : expected) {
+    size_t line = 0;
+    size_t column = 0;
+    ASSERT_EQ(state->getCodeCoordinates(state, position, &line, &column), OK);
+    ASSERT_EQ(line, coordinates.first) << "Failed for position " << position;
+    ASSERT_EQ(column, coordinates.second)
+        << "Failed for position " << position;
+
+    size_t result = 0;
+    ASSERT_EQ(state->getCodePosition(state, line, column, &result), OK);
+    ASSERT_EQ(result, position);
+  }
+
+  // The line break at the end of the first line still belongs to it.
+  size_t line = 0;
+  size_t column = 0;
+  ASSERT_EQ(state->getCodeCoordinates(state, 36, &line, &column), OK);
+  ASSERT_EQ(line, 0);
+  ASSERT_EQ(column, 36);
+
+  ASSERT_EQ(state->getCodeCoordinates(state, 100000, &line, &column), ERROR);
+  size_t position = 0;
+  ASSERT_EQ(state->getCodePosition(state, 1000, 0, &position), ERROR);
+  ASSERT_EQ(state->getCodePosition(state, 0, 36, &position), OK);
+  ASSERT_EQ(position, 36);
+  ASSERT_EQ(state->getCodePosition(state, 0, 37, &position), ERROR);
+  ASSERT_EQ(state->getCodePosition(state, 1, 1, &position), ERROR);
+
+  // The end of the code is the last position of the last line.
+  size_t end = 0;
+  while (state->getCodeCoordinates(state, end + 1, &line, &column) == OK) {
+    end++;
+  }
+  ASSERT_EQ(state->getCodeCoordinates(state, end, &line, &column), OK);
+  ASSERT_EQ(state->getCodePosition(state, line, column, &position), OK);
+  ASSERT_EQ(position, end);
+  ASSERT_EQ(state->getCodePosition(state, line, column + 1, &position), ERROR);
+}